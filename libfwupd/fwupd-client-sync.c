@@ -1746,6 +1746,60 @@ fwupd_client_get_report_metadata(FwupdClient *self, GCancellable *cancellable, G
 	return g_steal_pointer(&helper->hash);
 }
 
+static void
+fwupd_client_get_device_stats_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->hash =
+	    fwupd_client_get_device_stats_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_get_device_stats:
+ * @self: a #FwupdClient
+ * @device_id: the device ID
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the low-level I/O statistics recorded during the last update of a device.
+ *
+ * Returns: (transfer container): operation kind to summary
+ *
+ * Since: 1.8.5
+ **/
+GHashTable *
+fwupd_client_get_device_stats(FwupdClient *self,
+			      const gchar *device_id,
+			      GCancellable *cancellable,
+			      GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(device_id != NULL, NULL);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return NULL;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_get_device_stats_async(self,
+					    device_id,
+					    cancellable,
+					    fwupd_client_get_device_stats_cb,
+					    helper);
+	g_main_loop_run(helper->loop);
+	if (helper->hash == NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return NULL;
+	}
+	return g_steal_pointer(&helper->hash);
+}
+
 static void
 fwupd_client_modify_device_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
@@ -181,6 +181,11 @@ GHashTable *
 fwupd_client_get_report_metadata(FwupdClient *self,
 				 GCancellable *cancellable,
 				 GError **error) G_GNUC_WARN_UNUSED_RESULT;
+GHashTable *
+fwupd_client_get_device_stats(FwupdClient *self,
+			      const gchar *device_id,
+			      GCancellable *cancellable,
+			      GError **error) G_GNUC_WARN_UNUSED_RESULT;
 GPtrArray *
 fwupd_client_get_remotes(FwupdClient *self,
 			 GCancellable *cancellable,
@@ -1111,7 +1111,9 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 	gchar tmp_file[] = "/tmp/fwupd.XXXXXX";
 #endif
 
-#ifdef HAVE_MEMFD_CREATE
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+	fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#elif defined(HAVE_MEMFD_CREATE)
 	fd = memfd_create("fwupd", MFD_CLOEXEC);
 #else
 	/* emulate in-memory file by an unlinked temporary file */
@@ -1156,6 +1158,12 @@ fwupd_unix_input_stream_from_bytes(GBytes *bytes, GError **error)
 			    g_strerror(errno));
 		return NULL;
 	}
+
+#if defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+	/* the daemon can map a sealed memfd rather than copying the contents */
+	if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0)
+		g_debug("failed to seal memfd: %s", g_strerror(errno));
+#endif
 	return G_UNIX_INPUT_STREAM(g_unix_input_stream_new(fd, TRUE));
 }
 
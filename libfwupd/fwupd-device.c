@@ -35,6 +35,8 @@ typedef struct {
 	guint64 flags;
 	guint64 problems;
 	GPtrArray *guids;
+	GHashTable *guids_bin;	 /* (element-type fwupd_guid_t) */
+	guint guids_invalid_cnt; /* not in @guids_bin */
 	GPtrArray *vendor_ids;
 	GPtrArray *protocols;
 	GPtrArray *instance_ids;
@@ -601,6 +603,87 @@ fwupd_device_get_guids(FwupdDevice *self)
 	return priv->guids;
 }
 
+/* like fwupd_guid_from_string() but without any allocations */
+static gboolean
+fwupd_device_guid_from_string(const gchar *str, fwupd_guid_t *guid)
+{
+	guint j = 0;
+
+	for (guint i = 0; i < 36; i++) {
+		gint val;
+		if (i == 8 || i == 13 || i == 18 || i == 23) {
+			if (str[i] != '-')
+				return FALSE;
+			continue;
+		}
+		val = g_ascii_xdigit_value(str[i]);
+		if (val < 0)
+			return FALSE;
+		if (j % 2 == 0)
+			(*guid)[j / 2] = (guint8)(val << 4);
+		else
+			(*guid)[j / 2] |= (guint8)val;
+		j++;
+	}
+	return str[36] == '\0';
+}
+
+static guint
+fwupd_device_guid_hash(gconstpointer key)
+{
+	const guint8 *buf = (const guint8 *)key;
+	guint32 hash = 0;
+
+	/* the GUID is either random or a SHA-1 hash, so just fold it */
+	for (guint i = 0; i < sizeof(fwupd_guid_t); i += sizeof(guint32)) {
+		guint32 tmp;
+		memcpy(&tmp, buf + i, sizeof(tmp));
+		hash ^= tmp;
+	}
+	return hash;
+}
+
+static gboolean
+fwupd_device_guid_equal(gconstpointer a, gconstpointer b)
+{
+	return memcmp(a, b, sizeof(fwupd_guid_t)) == 0;
+}
+
+static void
+fwupd_device_guids_bin_add(FwupdDevice *self, const gchar *guid)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	guint8 *guid_bin = g_new0(guint8, sizeof(fwupd_guid_t));
+
+	if (!fwupd_device_guid_from_string(guid, (fwupd_guid_t *)guid_bin)) {
+		priv->guids_invalid_cnt++;
+		g_free(guid_bin);
+		return;
+	}
+	g_hash_table_add(priv->guids_bin, guid_bin);
+}
+
+/* only called when the GUIDs are modified, so that lookups never write */
+static void
+fwupd_device_guids_bin_rebuild(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	g_hash_table_remove_all(priv->guids_bin);
+	priv->guids_invalid_cnt = 0;
+	for (guint i = 0; i < priv->guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(priv->guids, i);
+		fwupd_device_guids_bin_add(self, guid);
+	}
+}
+
+/* older callers may have changed the size of the array directly */
+static gboolean
+fwupd_device_guids_bin_is_valid(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	return g_hash_table_size(priv->guids_bin) + priv->guids_invalid_cnt == priv->guids->len;
+}
+
 /**
  * fwupd_device_has_guid:
  * @self: a #FwupdDevice
@@ -616,10 +699,20 @@ gboolean
 fwupd_device_has_guid(FwupdDevice *self, const gchar *guid)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	fwupd_guid_t guid_bin = {0x0};
 
 	g_return_val_if_fail(FWUPD_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(guid != NULL, FALSE);
 
+	/* use the binary representation where possible */
+	if (fwupd_device_guids_bin_is_valid(self)) {
+		if (fwupd_device_guid_from_string(guid, &guid_bin))
+			return g_hash_table_contains(priv->guids_bin, guid_bin);
+
+		/* not a GUID, but was added anyway */
+		if (priv->guids_invalid_cnt == 0)
+			return FALSE;
+	}
 	for (guint i = 0; i < priv->guids->len; i++) {
 		const gchar *guid_tmp = g_ptr_array_index(priv->guids, i);
 		if (g_strcmp0(guid, guid_tmp) == 0)
@@ -645,7 +738,28 @@ fwupd_device_add_guid(FwupdDevice *self, const gchar *guid)
 	g_return_if_fail(guid != NULL);
 	if (fwupd_device_has_guid(self, guid))
 		return;
+	if (!fwupd_device_guids_bin_is_valid(self))
+		fwupd_device_guids_bin_rebuild(self);
 	g_ptr_array_add(priv->guids, g_strdup(guid));
+	fwupd_device_guids_bin_add(self, guid);
+}
+
+/**
+ * fwupd_device_remove_all_guids:
+ * @self: a #FwupdDevice
+ *
+ * Removes all the GUIDs from the device.
+ *
+ * Since: 1.8.5
+ **/
+void
+fwupd_device_remove_all_guids(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	g_ptr_array_set_size(priv->guids, 0);
+	g_hash_table_remove_all(priv->guids_bin);
+	priv->guids_invalid_cnt = 0;
 }
 
 /**
@@ -3815,6 +3929,8 @@ fwupd_device_init(FwupdDevice *self)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	priv->guids = g_ptr_array_new_with_free_func(g_free);
+	priv->guids_bin =
+	    g_hash_table_new_full(fwupd_device_guid_hash, fwupd_device_guid_equal, g_free, NULL);
 	priv->instance_ids = g_ptr_array_new_with_free_func(g_free);
 	priv->icons = g_ptr_array_new_with_free_func(g_free);
 	priv->checksums = g_ptr_array_new_with_free_func(g_free);
@@ -3859,6 +3975,7 @@ fwupd_device_finalize(GObject *object)
 	g_free(priv->version_lowest);
 	g_free(priv->version_bootloader);
 	g_ptr_array_unref(priv->guids);
+	g_hash_table_unref(priv->guids_bin);
 	g_ptr_array_unref(priv->vendor_ids);
 	g_ptr_array_unref(priv->protocols);
 	g_ptr_array_unref(priv->instance_ids);
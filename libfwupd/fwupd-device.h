@@ -193,6 +193,8 @@ void
 fwupd_device_add_guid(FwupdDevice *self, const gchar *guid);
 gboolean
 fwupd_device_has_guid(FwupdDevice *self, const gchar *guid);
+void
+fwupd_device_remove_all_guids(FwupdDevice *self);
 GPtrArray *
 fwupd_device_get_guids(FwupdDevice *self);
 const gchar *
@@ -840,6 +840,9 @@ fwupd_device_func(void)
 	g_assert_true(fwupd_device_has_guid(dev, "2082b5e0-7a64-478a-b1b2-e3404fab6dad"));
 	g_assert_true(fwupd_device_has_guid(dev, "00000000-0000-0000-0000-000000000000"));
 	g_assert_false(fwupd_device_has_guid(dev, "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"));
+	g_assert_true(fwupd_device_has_guid(dev, "2082B5E0-7A64-478A-B1B2-E3404FAB6DAD"));
+	g_assert_false(fwupd_device_has_guid(dev, "2082b5e0-7a64-478a-b1b2-e3404fab6da"));
+	g_assert_false(fwupd_device_has_guid(dev, "2082b5e0-7a64-478a-b1b2-e3404fab6dadd"));
 
 	/* convert the new non-breaking space back into a normal space:
 	 * https://gitlab.gnome.org/GNOME/glib/commit/76af5dabb4a25956a6c41a75c0c7feeee74496da */
@@ -951,6 +954,21 @@ fwupd_device_func(void)
 	g_assert_true(fwupd_device_has_vendor_id(dev_new, "USB:0x1234"));
 	g_assert_true(fwupd_device_has_vendor_id(dev_new, "PCI:0x5678"));
 	g_assert_true(fwupd_device_has_instance_id(dev_new, "USB\\VID_1234&PID_0001"));
+	g_assert_true(fwupd_device_has_guid(dev_new, "2082b5e0-7a64-478a-b1b2-e3404fab6dad"));
+
+	/* clear GUIDs using the array */
+	g_ptr_array_set_size(fwupd_device_get_guids(dev_new), 0);
+	g_assert_false(fwupd_device_has_guid(dev_new, "2082b5e0-7a64-478a-b1b2-e3404fab6dad"));
+	fwupd_device_add_guid(dev_new, "2082b5e0-7a64-478a-b1b2-e3404fab6dad");
+	g_assert_true(fwupd_device_has_guid(dev_new, "2082b5e0-7a64-478a-b1b2-e3404fab6dad"));
+	g_assert_cmpint(fwupd_device_get_guids(dev_new)->len, ==, 1);
+
+	/* replace with a different GUID, leaving the array the same length */
+	fwupd_device_remove_all_guids(dev_new);
+	fwupd_device_add_guid(dev_new, "00000000-0000-0000-0000-000000000000");
+	g_assert_false(fwupd_device_has_guid(dev_new, "2082b5e0-7a64-478a-b1b2-e3404fab6dad"));
+	g_assert_true(fwupd_device_has_guid(dev_new, "00000000-0000-0000-0000-000000000000"));
+	g_assert_cmpint(fwupd_device_get_guids(dev_new)->len, ==, 1);
 
 	/* from JSON */
 	ret = json_parser_load_from_data(parser, data, -1, &error);
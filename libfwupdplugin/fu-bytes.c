@@ -9,7 +9,10 @@
 #include "config.h"
 
 #ifdef HAVE_GIO_UNIX
+#include <fcntl.h>
 #include <gio/gunixinputstream.h>
+#include <glib/gstdio.h>
+#include <sys/stat.h>
 #endif
 
 #include "fwupd-error.h"
@@ -81,62 +84,67 @@ fu_bytes_get_contents(const gchar *filename, GError **error)
 }
 
 /**
- * fu_bytes_get_contents_fd:
- * @fd: a file descriptor
- * @count: the maximum number of bytes to read
+ * fu_bytes_map_contents:
+ * @filename: a filename
  * @error: (nullable): optional return location for an error
  *
- * Reads a blob from a specific file descriptor.
+ * Maps a file into memory rather than copying it, so that the data is shared with the page
+ * cache. Files that report a length of zero, e.g. in sysfs and procfs, are read instead.
  *
- * Note: this will close the fd when done
+ * This must only be used for trusted files that nothing can truncate or modify while the
+ * returned #GBytes is in use, e.g. the running executable. Truncating a mapped file causes
+ * SIGBUS on the next access, and any change would be visible after the data was checked.
+ * Use fu_bytes_get_contents() for everything else.
  *
- * Returns: (transfer full): a #GBytes, or %NULL
+ * Returns: a #GBytes, or %NULL for failure
  *
- * Since: 1.8.2
+ * Since: 1.8.5
  **/
 GBytes *
-fu_bytes_get_contents_fd(gint fd, gsize count, GError **error)
+fu_bytes_map_contents(const gchar *filename, GError **error)
 {
-#ifdef HAVE_GIO_UNIX
-	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GMappedFile) mapped_file = NULL;
 
-	g_return_val_if_fail(fd > 0, NULL);
+	g_return_val_if_fail(filename != NULL, NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
 
-	/* read the entire fd to a data blob */
-	stream = g_unix_input_stream_new(fd, TRUE);
-	return fu_bytes_get_contents_stream(stream, count, error);
+	mapped_file = g_mapped_file_new(filename, FALSE, error);
+	if (mapped_file == NULL)
+		return NULL;
+	if (g_mapped_file_get_length(mapped_file) == 0)
+		return fu_bytes_get_contents(filename, error);
+	g_debug("mapping %s with %" G_GSIZE_FORMAT " bytes",
+		filename,
+		g_mapped_file_get_length(mapped_file));
+	return g_mapped_file_get_bytes(mapped_file);
+}
+
+#ifdef HAVE_GIO_UNIX
+/* the sender can no longer change the contents, so the fd is safe to map */
+static gboolean
+fu_bytes_fd_is_sealed(gint fd)
+{
+#ifdef F_GET_SEALS
+	gint seals = fcntl(fd, F_GET_SEALS);
+	if (seals < 0)
+		return FALSE;
+	return (seals & (F_SEAL_SHRINK | F_SEAL_WRITE)) == (F_SEAL_SHRINK | F_SEAL_WRITE);
 #else
-	g_set_error_literal(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_NOT_SUPPORTED,
-			    "Not supported as <glib-unix.h> is unavailable");
-	return NULL;
+	return FALSE;
 #endif
 }
+#endif
 
-/**
- * fu_bytes_get_contents_stream:
- * @stream: input stream
- * @count: the maximum number of bytes to read
- * @error: (nullable): optional return location for an error
- *
- * Reads a blob from a specific input stream.
- *
- * Returns: (transfer full): a #GBytes, or %NULL
- *
- * Since: 1.8.2
- **/
-GBytes *
-fu_bytes_get_contents_stream(GInputStream *stream, gsize count, GError **error)
+static GBytes *
+fu_bytes_get_contents_stream_full(GInputStream *stream,
+				  gsize count,
+				  gsize size_hint,
+				  GError **error)
 {
 	guint8 tmp[0x8000] = {0x0};
-	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GByteArray) buf = NULL;
 	g_autoptr(GError) error_local = NULL;
 
-	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
-	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
-
 	/* this is invalid */
 	if (count == 0) {
 		g_set_error_literal(error,
@@ -146,10 +154,27 @@ fu_bytes_get_contents_stream(GInputStream *stream, gsize count, GError **error)
 		return NULL;
 	}
 
-	/* read from stream in 32kB chunks */
+	/* never trust the hint to allocate more than is allowed */
+	size_hint = MIN(size_hint, MIN(count, G_MAXUINT32));
+	buf = g_byte_array_sized_new(size_hint);
+
+	/* read directly into the buffer up to the expected size, then in 32kB chunks */
 	while (TRUE) {
 		gssize sz;
-		sz = g_input_stream_read(stream, tmp, sizeof(tmp), NULL, &error_local);
+		if (buf->len < size_hint) {
+			guint offset = buf->len;
+			g_byte_array_set_size(buf, size_hint);
+			sz = g_input_stream_read(stream,
+						 buf->data + offset,
+						 size_hint - offset,
+						 NULL,
+						 &error_local);
+			g_byte_array_set_size(buf, offset + MAX(sz, 0));
+		} else {
+			sz = g_input_stream_read(stream, tmp, sizeof(tmp), NULL, &error_local);
+			if (sz > 0)
+				g_byte_array_append(buf, tmp, sz);
+		}
 		if (sz == 0)
 			break;
 		if (sz < 0) {
@@ -159,7 +184,6 @@ fu_bytes_get_contents_stream(GInputStream *stream, gsize count, GError **error)
 					    error_local->message);
 			return NULL;
 		}
-		g_byte_array_append(buf, tmp, sz);
 		if (buf->len > count) {
 			g_set_error(error,
 				    FWUPD_ERROR,
@@ -173,6 +197,90 @@ fu_bytes_get_contents_stream(GInputStream *stream, gsize count, GError **error)
 	return g_byte_array_free_to_bytes(g_steal_pointer(&buf));
 }
 
+/**
+ * fu_bytes_get_contents_fd:
+ * @fd: a file descriptor
+ * @count: the maximum number of bytes to read
+ * @error: (nullable): optional return location for an error
+ *
+ * Reads a blob from a specific file descriptor.
+ *
+ * Note: this will close the fd when done
+ *
+ * Returns: (transfer full): a #GBytes, or %NULL
+ *
+ * Since: 1.8.2
+ **/
+GBytes *
+fu_bytes_get_contents_fd(gint fd, gsize count, GError **error)
+{
+#ifdef HAVE_GIO_UNIX
+	gsize size_hint = 0;
+	struct stat st = {0x0};
+	g_autoptr(GInputStream) stream = NULL;
+
+	g_return_val_if_fail(fd > 0, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* a sealed memfd can be mapped, which means the pages are shared with the sender */
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+		size_hint = st.st_size;
+		if (size_hint > 0 && fu_bytes_fd_is_sealed(fd)) {
+			g_autoptr(GMappedFile) mapped_file = NULL;
+			g_autoptr(GError) error_local = NULL;
+
+			if (size_hint > count) {
+				g_set_error(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INVALID_FILE,
+					    "cannot read from fd: 0x%x > 0x%x",
+					    (guint)size_hint,
+					    (guint)count);
+				g_close(fd, NULL);
+				return NULL;
+			}
+			mapped_file = g_mapped_file_new_from_fd(fd, FALSE, &error_local);
+			if (mapped_file != NULL) {
+				g_close(fd, NULL);
+				return g_mapped_file_get_bytes(mapped_file);
+			}
+			g_debug("failed to map sealed fd, reading instead: %s",
+				error_local->message);
+		}
+	}
+
+	/* read the entire fd to a data blob */
+	stream = g_unix_input_stream_new(fd, TRUE);
+	return fu_bytes_get_contents_stream_full(stream, count, size_hint, error);
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as <glib-unix.h> is unavailable");
+	return NULL;
+#endif
+}
+
+/**
+ * fu_bytes_get_contents_stream:
+ * @stream: input stream
+ * @count: the maximum number of bytes to read
+ * @error: (nullable): optional return location for an error
+ *
+ * Reads a blob from a specific input stream.
+ *
+ * Returns: (transfer full): a #GBytes, or %NULL
+ *
+ * Since: 1.8.2
+ **/
+GBytes *
+fu_bytes_get_contents_stream(GInputStream *stream, gsize count, GError **error)
+{
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+	return fu_bytes_get_contents_stream_full(stream, count, 0, error);
+}
+
 /**
  * fu_bytes_align:
  * @bytes: data blob
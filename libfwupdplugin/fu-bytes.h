@@ -15,6 +15,8 @@ fu_bytes_set_contents(const gchar *filename,
 GBytes *
 fu_bytes_get_contents(const gchar *filename, GError **error) G_GNUC_WARN_UNUSED_RESULT;
 GBytes *
+fu_bytes_map_contents(const gchar *filename, GError **error) G_GNUC_WARN_UNUSED_RESULT;
+GBytes *
 fu_bytes_get_contents_stream(GInputStream *stream,
 			     gsize count,
 			     GError **error) G_GNUC_WARN_UNUSED_RESULT;
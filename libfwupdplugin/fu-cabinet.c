@@ -31,6 +31,7 @@ struct _FuCabinet {
 	GObject parent_instance;
 	guint64 size_max;
 	GCabCabinet *gcab_cabinet;
+	gboolean gcab_loaded; /* files are only decompressed when required */
 	gchar *container_checksum;
 	gchar *container_checksum_alt;
 	XbBuilder *builder;
@@ -141,6 +142,89 @@ fu_cabinet_get_file_by_name(FuCabinet *self, const gchar *basename)
 	return NULL;
 }
 
+static gboolean
+fu_cabinet_extract_file_cb(GCabFile *file, gpointer user_data)
+{
+	GHashTable *basenames = (GHashTable *)user_data;
+	if (gcab_file_get_bytes(file) != NULL)
+		return FALSE;
+	if (basenames == NULL)
+		return TRUE;
+	return g_hash_table_contains(basenames, gcab_file_get_extract_name(file));
+}
+
+/* decompress the files in @basenames, or all files if %NULL, if not already done */
+static gboolean
+fu_cabinet_extract_files_full(GCabCabinet *gcab_cabinet, GHashTable *basenames, GError **error)
+{
+	GPtrArray *folders = gcab_cabinet_get_folders(gcab_cabinet);
+	gboolean required = FALSE;
+	g_autoptr(GError) error_local = NULL;
+
+	for (guint i = 0; i < folders->len && !required; i++) {
+		GCabFolder *cabfolder = GCAB_FOLDER(g_ptr_array_index(folders, i));
+		g_autoptr(GSList) cabfiles = gcab_folder_get_files(cabfolder);
+		for (GSList *l = cabfiles; l != NULL; l = l->next) {
+			if (fu_cabinet_extract_file_cb(GCAB_FILE(l->data), basenames)) {
+				required = TRUE;
+				break;
+			}
+		}
+	}
+	if (!required)
+		return TRUE;
+
+	/* decompress the selected files to memory */
+	if (!gcab_cabinet_extract_simple(gcab_cabinet,
+					 NULL,
+					 fu_cabinet_extract_file_cb,
+					 basenames,
+					 NULL,
+					 &error_local)) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    error_local->message);
+		return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_cabinet_extract_files(FuCabinet *self, GHashTable *basenames, GError **error)
+{
+	/* nothing to do */
+	if (!self->gcab_loaded)
+		return TRUE;
+	return fu_cabinet_extract_files_full(self->gcab_cabinet, basenames, error);
+}
+
+static GBytes *
+fu_cabinet_get_file_bytes(FuCabinet *self, GCabFile *cabfile, GError **error)
+{
+	GBytes *blob = gcab_file_get_bytes(cabfile);
+
+	/* decompress on demand */
+	if (blob == NULL) {
+		g_autoptr(GHashTable) basenames = g_hash_table_new(g_str_hash, g_str_equal);
+		g_hash_table_add(basenames, (gpointer)gcab_file_get_extract_name(cabfile));
+		if (!fu_cabinet_extract_files(self, basenames, error))
+			return NULL;
+		blob = gcab_file_get_bytes(cabfile);
+	}
+	if (blob == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "no GBytes from GCabFile %s",
+			    gcab_file_get_name(cabfile));
+		return NULL;
+	}
+	return blob;
+}
+
 /**
  * fu_cabinet_add_file:
  * @self: a #FuCabinet
@@ -216,37 +300,19 @@ fu_cabinet_get_file(FuCabinet *self, const gchar *basename, GError **error)
 			    basename);
 		return NULL;
 	}
-	blob = gcab_file_get_bytes(cabfile);
-	if (blob == NULL) {
-		g_set_error_literal(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_FILE,
-				    "no GBytes from GCabFile firmware");
+	blob = fu_cabinet_get_file_bytes(self, cabfile, error);
+	if (blob == NULL)
 		return NULL;
-	}
 	return g_bytes_ref(blob);
 }
 
-/* sets the firmware and signature blobs on XbNode */
-static gboolean
-fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
+/* gets the basename of the payload, and the optional checksum node used to verify it */
+static gchar *
+fu_cabinet_release_get_basename(XbNode *release, XbNode **csum)
 {
-	GCabFile *cabfile;
-	GBytes *blob;
 	const gchar *csum_filename = NULL;
-	g_autofree gchar *basename = NULL;
 	g_autoptr(XbNode) artifact = NULL;
 	g_autoptr(XbNode) csum_tmp = NULL;
-	g_autoptr(XbNode) metadata_trust = NULL;
-	g_autoptr(XbNode) nsize = NULL;
-	g_autoptr(JcatItem) item = NULL;
-	g_autoptr(GBytes) release_flags_blob = NULL;
-	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
-
-	/* we set this with XbBuilderSource before the silo was created */
-	metadata_trust = xb_node_query_first(release, "../../info/metadata_trust", NULL);
-	if (metadata_trust != NULL)
-		release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_METADATA;
 
 	/* look for source artifact first */
 	artifact = xb_node_query_first(release, "artifacts/artifact[@type='source']", NULL);
@@ -265,9 +331,71 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 	 * something like: <checksum target="content" filename="FLASH.ROM"/> */
 	if (csum_filename == NULL)
 		csum_filename = "firmware.bin";
+	if (csum != NULL)
+		*csum = g_steal_pointer(&csum_tmp);
+	return g_path_get_basename(csum_filename);
+}
+
+/* the payload of a release, which is only decompressed and verified when first required */
+typedef struct {
+	GCabCabinet *gcab_cabinet;
+	GCabFile *cabfile;
+	GCabFile *cabfile_sig; /* nullable */
+	JcatContext *jcat_context;
+	JcatItem *jcat_item; /* nullable */
+	gchar *basename;
+	gchar *checksum; /* nullable */
+	FwupdReleaseFlags release_flags;
+} FuCabinetRelease;
+
+static void
+fu_cabinet_release_free(FuCabinetRelease *helper)
+{
+	g_object_unref(helper->gcab_cabinet);
+	g_object_unref(helper->cabfile);
+	if (helper->cabfile_sig != NULL)
+		g_object_unref(helper->cabfile_sig);
+	g_object_unref(helper->jcat_context);
+	if (helper->jcat_item != NULL)
+		g_object_unref(helper->jcat_item);
+	g_free(helper->basename);
+	g_free(helper->checksum);
+	g_free(helper);
+}
+
+static guint64
+fu_cabinet_file_get_size(GCabFile *cabfile)
+{
+	GBytes *blob = gcab_file_get_bytes(cabfile);
+	if (blob != NULL)
+		return g_bytes_get_size(blob);
+	return gcab_file_get_size(cabfile);
+}
+
+static void
+fu_cabinet_release_set_flags(XbNode *release, FwupdReleaseFlags release_flags)
+{
+	g_autoptr(GBytes) release_flags_blob = NULL;
+
+	/* this means we can get the data from fu_keyring_get_release_flags */
+	release_flags_blob = g_bytes_new(&release_flags, sizeof(release_flags));
+	xb_node_set_data(release, "fwupd::ReleaseFlags", release_flags_blob);
+}
+
+/* checks the installed size using the file table, and defers everything needing the payload */
+static gboolean
+fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
+{
+	GCabFile *cabfile;
+	guint64 size_cabfile;
+	g_autofree gchar *basename = NULL;
+	g_autoptr(XbNode) csum_tmp = NULL;
+	g_autoptr(XbNode) metadata_trust = NULL;
+	g_autoptr(XbNode) nsize = NULL;
+	FuCabinetRelease *helper;
 
 	/* get the main firmware file */
-	basename = g_path_get_basename(csum_filename);
+	basename = fu_cabinet_release_get_basename(release, &csum_tmp);
 	cabfile = fu_cabinet_get_file_by_name(self, basename);
 	if (cabfile == NULL) {
 		g_set_error(error,
@@ -277,117 +405,175 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 			    basename);
 		return FALSE;
 	}
-	blob = gcab_file_get_bytes(cabfile);
-	if (blob == NULL) {
-		g_set_error_literal(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_FILE,
-				    "no GBytes from GCabFile firmware");
-		return FALSE;
-	}
-
-	/* set the blob */
-	xb_node_set_data(release, "fwupd::FirmwareBlob", blob);
 
 	/* set as metadata if unset, but error if specified and incorrect */
+	size_cabfile = fu_cabinet_file_get_size(cabfile);
 	nsize = xb_node_query_first(release, "size[@type='installed']", NULL);
 	if (nsize != NULL) {
 		guint64 size = 0;
 		if (!fu_strtoull(xb_node_get_text(nsize), &size, 0, G_MAXSIZE, error))
 			return FALSE;
-		if (size != g_bytes_get_size(blob)) {
+		if (size != size_cabfile) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "contents size invalid, expected "
-				    "%" G_GSIZE_FORMAT ", got %" G_GUINT64_FORMAT,
-				    g_bytes_get_size(blob),
+				    "%" G_GUINT64_FORMAT ", got %" G_GUINT64_FORMAT,
+				    size_cabfile,
 				    size);
 			return FALSE;
 		}
 	} else {
-		guint64 size = g_bytes_get_size(blob);
-		g_autoptr(GBytes) blob_sz = g_bytes_new(&size, sizeof(guint64));
+		g_autoptr(GBytes) blob_sz = g_bytes_new(&size_cabfile, sizeof(guint64));
 		xb_node_set_data(release, "fwupd::ReleaseSize", blob_sz);
 	}
 
-	/* set if unspecified, but error out if specified and incorrect */
-	if (csum_tmp != NULL && xb_node_get_text(csum_tmp) != NULL) {
-		const gchar *checksum_old = xb_node_get_text(csum_tmp);
-		GChecksumType checksum_type = fwupd_checksum_guess_kind(checksum_old);
-		g_autofree gchar *checksum = NULL;
-		checksum = g_compute_checksum_for_bytes(checksum_type, blob);
-		if (g_strcmp0(checksum, checksum_old) != 0) {
+	/* everything else is done in fu_cabinet_load_release() */
+	helper = g_new0(FuCabinetRelease, 1);
+	helper->gcab_cabinet = g_object_ref(self->gcab_cabinet);
+	helper->cabfile = g_object_ref(cabfile);
+	helper->jcat_context = g_object_ref(self->jcat_context);
+	helper->jcat_item = jcat_file_get_item_by_id(self->jcat_file, basename, NULL);
+	if (helper->jcat_item == NULL) {
+		g_autofree gchar *basename_sig = g_strdup_printf("%s.asc", basename);
+		GCabFile *cabfile_sig = fu_cabinet_get_file_by_name(self, basename_sig);
+		if (cabfile_sig != NULL)
+			helper->cabfile_sig = g_object_ref(cabfile_sig);
+	}
+	if (csum_tmp != NULL)
+		helper->checksum = g_strdup(xb_node_get_text(csum_tmp));
+	helper->basename = g_steal_pointer(&basename);
+
+	/* we set this with XbBuilderSource before the silo was created */
+	metadata_trust = xb_node_query_first(release, "../../info/metadata_trust", NULL);
+	if (metadata_trust != NULL)
+		helper->release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_METADATA;
+	fu_cabinet_release_set_flags(release, helper->release_flags);
+	g_object_set_data_full(G_OBJECT(release),
+			       "fwupd::CabinetRelease",
+			       helper,
+			       (GDestroyNotify)fu_cabinet_release_free);
+
+	/* success */
+	return TRUE;
+}
+
+/**
+ * fu_cabinet_load_release: (skip):
+ * @release: a release #XbNode from the silo returned by fu_cabinet_get_silo()
+ * @error: (nullable): optional return location for an error
+ *
+ * Decompresses the payload of a release, verifies the checksum and signature, and then sets
+ * the `fwupd::FirmwareBlob` and `fwupd::ReleaseFlags` data on the node.
+ *
+ * This does nothing if the release has already been loaded, or is not from an archive.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_cabinet_load_release(XbNode *release, GError **error)
+{
+	FuCabinetRelease *helper;
+	GBytes *blob;
+	g_autoptr(GHashTable) basenames = g_hash_table_new(g_str_hash, g_str_equal);
+
+	g_return_val_if_fail(XB_IS_NODE(release), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* nothing to do */
+	helper = g_object_get_data(G_OBJECT(release), "fwupd::CabinetRelease");
+	if (helper == NULL)
+		return TRUE;
+
+	/* decompress the payload and any detached signature in one pass */
+	g_hash_table_add(basenames, (gpointer)gcab_file_get_extract_name(helper->cabfile));
+	if (helper->cabfile_sig != NULL) {
+		g_hash_table_add(basenames,
+				 (gpointer)gcab_file_get_extract_name(helper->cabfile_sig));
+	}
+	if (!fu_cabinet_extract_files_full(helper->gcab_cabinet, basenames, error))
+		return FALSE;
+	blob = gcab_file_get_bytes(helper->cabfile);
+	if (blob == NULL) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "no GBytes from GCabFile %s",
+			    gcab_file_get_name(helper->cabfile));
+		return FALSE;
+	}
+
+	/* error out if specified and incorrect */
+	if (helper->checksum != NULL) {
+		GChecksumType checksum_type = fwupd_checksum_guess_kind(helper->checksum);
+		g_autofree gchar *checksum = g_compute_checksum_for_bytes(checksum_type, blob);
+		if (g_strcmp0(checksum, helper->checksum) != 0) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "contents checksum invalid, expected %s, got %s",
 				    checksum,
-				    xb_node_get_text(csum_tmp));
+				    helper->checksum);
 			return FALSE;
 		}
 	}
 
 	/* find out if the payload is signed, falling back to detached */
-	item = jcat_file_get_item_by_id(self->jcat_file, basename, NULL);
-	if (item != NULL) {
+	if (helper->jcat_item != NULL) {
 		g_autoptr(GError) error_local = NULL;
 		g_autoptr(GPtrArray) results = NULL;
-		results = jcat_context_verify_item(self->jcat_context,
+		results = jcat_context_verify_item(helper->jcat_context,
 						   blob,
-						   item,
+						   helper->jcat_item,
 						   JCAT_VERIFY_FLAG_REQUIRE_CHECKSUM |
 						       JCAT_VERIFY_FLAG_REQUIRE_SIGNATURE,
 						   &error_local);
 		if (results == NULL) {
-			g_debug("failed to verify payload %s: %s", basename, error_local->message);
+			g_debug("failed to verify payload %s: %s",
+				helper->basename,
+				error_local->message);
 		} else {
-			g_debug("verified payload %s: %u", basename, results->len);
-			release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_PAYLOAD;
+			g_debug("verified payload %s: %u", helper->basename, results->len);
+			helper->release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_PAYLOAD;
 		}
 
 		/* legacy GPG detached signature */
-	} else {
-		g_autofree gchar *basename_sig = NULL;
-		basename_sig = g_strdup_printf("%s.asc", basename);
-		cabfile = fu_cabinet_get_file_by_name(self, basename_sig);
-		if (cabfile != NULL) {
-			GBytes *data_sig;
-			g_autoptr(JcatResult) jcat_result = NULL;
-			g_autoptr(JcatBlob) jcat_blob = NULL;
-			g_autoptr(GError) error_local = NULL;
-
-			data_sig = gcab_file_get_bytes(cabfile);
-			if (data_sig == NULL) {
-				g_set_error(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_INVALID_FILE,
-					    "no GBytes from GCabFile %s",
-					    basename_sig);
-				return FALSE;
-			}
-			jcat_blob = jcat_blob_new(JCAT_BLOB_KIND_GPG, data_sig);
-			jcat_result = jcat_context_verify_blob(self->jcat_context,
-							       blob,
-							       jcat_blob,
-							       JCAT_VERIFY_FLAG_REQUIRE_SIGNATURE,
-							       &error_local);
-			if (jcat_result == NULL) {
-				g_debug("failed to verify payload %s using detached: %s",
-					basename,
-					error_local->message);
-			} else {
-				g_debug("verified payload %s using detached", basename);
-				release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_PAYLOAD;
-			}
+	} else if (helper->cabfile_sig != NULL) {
+		GBytes *data_sig = gcab_file_get_bytes(helper->cabfile_sig);
+		g_autoptr(JcatResult) jcat_result = NULL;
+		g_autoptr(JcatBlob) jcat_blob = NULL;
+		g_autoptr(GError) error_local = NULL;
+
+		if (data_sig == NULL) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "no GBytes from GCabFile %s",
+				    gcab_file_get_name(helper->cabfile_sig));
+			return FALSE;
+		}
+		jcat_blob = jcat_blob_new(JCAT_BLOB_KIND_GPG, data_sig);
+		jcat_result = jcat_context_verify_blob(helper->jcat_context,
+						       blob,
+						       jcat_blob,
+						       JCAT_VERIFY_FLAG_REQUIRE_SIGNATURE,
+						       &error_local);
+		if (jcat_result == NULL) {
+			g_debug("failed to verify payload %s using detached: %s",
+				helper->basename,
+				error_local->message);
+		} else {
+			g_debug("verified payload %s using detached", helper->basename);
+			helper->release_flags |= FWUPD_RELEASE_FLAG_TRUSTED_PAYLOAD;
 		}
 	}
 
-	/* this means we can get the data from fu_keyring_get_release_flags */
-	release_flags_blob = g_bytes_new(&release_flags, sizeof(release_flags));
-	xb_node_set_data(release, "fwupd::ReleaseFlags", release_flags_blob);
-
-	/* success */
+	/* set the blob, and the helper is no longer required */
+	xb_node_set_data(release, "fwupd::FirmwareBlob", blob);
+	fu_cabinet_release_set_flags(release, helper->release_flags);
+	g_object_set_data(G_OBJECT(release), "fwupd::CabinetRelease", NULL);
 	return TRUE;
 }
 
@@ -557,14 +743,9 @@ fu_cabinet_build_silo_file(FuCabinet *self,
 	xb_builder_source_set_prefix(source, "components");
 
 	/* parse file */
-	blob = gcab_file_get_bytes(cabfile);
-	if (blob == NULL) {
-		g_set_error_literal(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_FILE,
-				    "no GBytes from GCabFile");
+	blob = fu_cabinet_get_file_bytes(self, cabfile, error);
+	if (blob == NULL)
 		return FALSE;
-	}
 	if (!xb_builder_source_load_bytes(source,
 					  blob,
 					  XB_BUILDER_SOURCE_FLAG_NONE,
@@ -587,9 +768,13 @@ fu_cabinet_build_silo_metainfo(FuCabinet *self, GCabFile *cabfile, GError **erro
 {
 	FwupdReleaseFlags release_flags = FWUPD_RELEASE_FLAG_NONE;
 	const gchar *fn = gcab_file_get_extract_name(cabfile);
+	GBytes *blob;
 	g_autoptr(JcatItem) item = NULL;
 
 	/* validate against the Jcat file */
+	blob = fu_cabinet_get_file_bytes(self, cabfile, error);
+	if (blob == NULL)
+		return FALSE;
 	item = jcat_file_get_item_by_id(self->jcat_file, fn, NULL);
 	if (item == NULL) {
 		g_debug("failed to verify %s: no JcatItem", fn);
@@ -597,7 +782,7 @@ fu_cabinet_build_silo_metainfo(FuCabinet *self, GCabFile *cabfile, GError **erro
 		g_autoptr(GError) error_local = NULL;
 		g_autoptr(GPtrArray) results = NULL;
 		results = jcat_context_verify_item(self->jcat_context,
-						   gcab_file_get_bytes(cabfile),
+						   blob,
 						   item,
 						   JCAT_VERIFY_FLAG_REQUIRE_CHECKSUM |
 						       JCAT_VERIFY_FLAG_REQUIRE_SIGNATURE,
@@ -632,8 +817,10 @@ fu_cabinet_build_jcat_folder(FuCabinet *self, GCabFolder *cabfolder, GError **er
 		GCabFile *cabfile = GCAB_FILE(l->data);
 		const gchar *fn = gcab_file_get_extract_name(cabfile);
 		if (g_str_has_suffix(fn, ".jcat")) {
-			GBytes *data_jcat = gcab_file_get_bytes(cabfile);
+			GBytes *data_jcat = fu_cabinet_get_file_bytes(self, cabfile, error);
 			g_autoptr(GInputStream) istream = NULL;
+			if (data_jcat == NULL)
+				return FALSE;
 			istream = g_memory_input_stream_new_from_bytes(data_jcat);
 			if (!jcat_file_import_stream(self->jcat_file,
 						     istream,
@@ -736,29 +923,18 @@ fu_cabinet_build_silo(FuCabinet *self, GBytes *data, GError **error)
 	return TRUE;
 }
 
-typedef struct {
-	FuCabinet *self;
-	guint64 size_total;
-	GError *error;
-} FuCabinetDecompressHelper;
-
+/* check sizes and set the extract names without decompressing anything */
 static gboolean
-fu_cabinet_decompress_file_cb(GCabFile *file, gpointer user_data)
+fu_cabinet_index_file(FuCabinet *self, GCabFile *file, guint64 *size_total, GError **error)
 {
-	FuCabinetDecompressHelper *helper = (FuCabinetDecompressHelper *)user_data;
-	FuCabinet *self = FU_CABINET(helper->self);
 	g_autofree gchar *basename = NULL;
 	g_autofree gchar *name = NULL;
 
-	/* already failed */
-	if (helper->error != NULL)
-		return FALSE;
-
 	/* check the size of the compressed file */
 	if (gcab_file_get_size(file) > self->size_max) {
 		g_autofree gchar *sz_val = g_format_size(gcab_file_get_size(file));
 		g_autofree gchar *sz_max = g_format_size(self->size_max);
-		g_set_error(&helper->error,
+		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "file %s was too large (%s, limit %s)",
@@ -769,11 +945,11 @@ fu_cabinet_decompress_file_cb(GCabFile *file, gpointer user_data)
 	}
 
 	/* check the total size of all the compressed files */
-	helper->size_total += gcab_file_get_size(file);
-	if (helper->size_total > self->size_max) {
-		g_autofree gchar *sz_val = g_format_size(helper->size_total);
+	*size_total += gcab_file_get_size(file);
+	if (*size_total > self->size_max) {
+		g_autofree gchar *sz_val = g_format_size(*size_total);
 		g_autofree gchar *sz_max = g_format_size(self->size_max);
-		g_set_error(&helper->error,
+		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INVALID_FILE,
 			    "uncompressed data too large (%s, limit %s)",
@@ -795,12 +971,8 @@ fu_cabinet_decompress_file_cb(GCabFile *file, gpointer user_data)
 static gboolean
 fu_cabinet_decompress(FuCabinet *self, GBytes *data, GError **error)
 {
-	FuCabinetDecompressHelper helper = {
-	    .self = self,
-	    .size_total = 0,
-	    .error = NULL,
-	};
-	g_autoptr(GError) error_local = NULL;
+	GPtrArray *folders;
+	guint64 size_total = 0;
 	g_autoptr(GInputStream) istream = NULL;
 
 	/* load from a seekable stream */
@@ -821,25 +993,17 @@ fu_cabinet_decompress(FuCabinet *self, GBytes *data, GError **error)
 		return FALSE;
 	}
 
-	/* decompress the file to memory */
-	if (!gcab_cabinet_extract_simple(self->gcab_cabinet,
-					 NULL,
-					 fu_cabinet_decompress_file_cb,
-					 &helper,
-					 NULL,
-					 &error_local)) {
-		g_set_error_literal(error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INVALID_FILE,
-				    error_local->message);
-		return FALSE;
-	}
-
-	/* the file callback set an error */
-	if (helper.error != NULL) {
-		g_propagate_error(error, helper.error);
-		return FALSE;
+	/* the file table is enough to check the sizes, the data is extracted on demand */
+	folders = gcab_cabinet_get_folders(self->gcab_cabinet);
+	for (guint i = 0; i < folders->len; i++) {
+		GCabFolder *cabfolder = GCAB_FOLDER(g_ptr_array_index(folders, i));
+		g_autoptr(GSList) cabfiles = gcab_folder_get_files(cabfolder);
+		for (GSList *l = cabfiles; l != NULL; l = l->next) {
+			if (!fu_cabinet_index_file(self, GCAB_FILE(l->data), &size_total, error))
+				return FALSE;
+		}
 	}
+	self->gcab_loaded = TRUE;
 
 	/* success */
 	return TRUE;
@@ -861,6 +1025,11 @@ GBytes *
 fu_cabinet_export(FuCabinet *self, FuCabinetExportFlags flags, GError **error)
 {
 	g_autoptr(GOutputStream) op = NULL;
+
+	/* any files not already extracted have to be written back */
+	if (!fu_cabinet_extract_files(self, NULL, error))
+		return NULL;
+
 	op = g_memory_output_stream_new_resizable();
 	if (!gcab_cabinet_write_simple(self->gcab_cabinet,
 				       op,
@@ -1043,6 +1212,24 @@ fu_cabinet_sign(FuCabinet *self,
 	return TRUE;
 }
 
+static gboolean
+fu_cabinet_extract_metadata(FuCabinet *self, GError **error)
+{
+	GPtrArray *folders = gcab_cabinet_get_folders(self->gcab_cabinet);
+	g_autoptr(GHashTable) basenames = g_hash_table_new(g_str_hash, g_str_equal);
+
+	for (guint i = 0; i < folders->len; i++) {
+		GCabFolder *cabfolder = GCAB_FOLDER(g_ptr_array_index(folders, i));
+		g_autoptr(GSList) cabfiles = gcab_folder_get_files(cabfolder);
+		for (GSList *l = cabfiles; l != NULL; l = l->next) {
+			const gchar *fn = gcab_file_get_extract_name(GCAB_FILE(l->data));
+			if (g_str_has_suffix(fn, ".metainfo.xml") || g_str_has_suffix(fn, ".jcat"))
+				g_hash_table_add(basenames, (gpointer)fn);
+		}
+	}
+	return fu_cabinet_extract_files(self, basenames, error);
+}
+
 /**
  * fu_cabinet_parse:
  * @self: a #FuCabinet
@@ -1068,10 +1255,14 @@ fu_cabinet_parse(FuCabinet *self, GBytes *data, FuCabinetParseFlags flags, GErro
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 	g_return_val_if_fail(self->silo == NULL, FALSE);
 
-	/* decompress */
+	/* load the file table */
 	if (!fu_cabinet_decompress(self, data, error))
 		return FALSE;
 
+	/* only the metadata is needed to build the silo */
+	if (!fu_cabinet_extract_metadata(self, error))
+		return FALSE;
+
 	/* build xmlb silo */
 	self->container_checksum = g_compute_checksum_for_bytes(G_CHECKSUM_SHA1, data);
 	self->container_checksum_alt = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, data);
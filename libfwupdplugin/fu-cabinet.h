@@ -74,3 +74,5 @@ fu_cabinet_export(FuCabinet *self,
 		  GError **error) G_GNUC_WARN_UNUSED_RESULT;
 XbSilo *
 fu_cabinet_get_silo(FuCabinet *self);
+gboolean
+fu_cabinet_load_release(XbNode *release, GError **error) G_GNUC_WARN_UNUSED_RESULT;
@@ -18,6 +18,8 @@ gboolean
 fu_context_load_hwinfo(FuContext *self, GError **error);
 gboolean
 fu_context_load_quirks(FuContext *self, FuQuirksLoadFlags flags, GError **error);
+gboolean
+fu_context_ensure_quirks(FuContext *self, GError **error);
 void
 fu_context_set_runtime_versions(FuContext *self, GHashTable *runtime_versions);
 void
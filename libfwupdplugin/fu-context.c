@@ -24,6 +24,7 @@ typedef struct {
 	FuHwids *hwids;
 	FuSmbios *smbios;
 	FuQuirks *quirks;
+	FuQuirksLoadFlags quirks_flags;
 	GHashTable *runtime_versions;
 	GHashTable *compile_versions;
 	GPtrArray *udev_subsystems;
@@ -665,6 +666,7 @@ fu_context_load_quirks(FuContext *self, FuQuirksLoadFlags flags, GError **error)
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	/* rebuild silo if required */
+	priv->quirks_flags = flags;
 	if (!fu_quirks_load(priv->quirks, flags, &error_local))
 		g_warning("Failed to load quirks: %s", error_local->message);
 
@@ -672,6 +674,27 @@ fu_context_load_quirks(FuContext *self, FuQuirksLoadFlags flags, GError **error)
 	return TRUE;
 }
 
+/**
+ * fu_context_ensure_quirks:
+ * @self: a #FuContext
+ * @error: (nullable): optional return location for an error
+ *
+ * Rebuilds the quirk silo now if any of the quirk files have changed since it was loaded,
+ * rather than when the next quirk is looked up.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_context_ensure_quirks(FuContext *self, GError **error)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fu_quirks_load(priv->quirks, priv->quirks_flags, error);
+}
+
 /**
  * fu_context_get_battery_state:
  * @self: a #FuContext
@@ -8,8 +8,138 @@
 
 #include "config.h"
 
+#include <string.h>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
 #include "fu-crc.h"
 
+/* smaller buffers are not worth the lookup of the table */
+#define FU_CRC_TABLE_MIN_SIZE 16
+
+typedef struct {
+	guint32 slice[8][256];
+} FuCrcTable;
+
+/* width<<32|polynomial : FuCrcTable, shared by all callers and never pruned */
+static GHashTable *fu_crc_tables = NULL;
+static GMutex fu_crc_tables_mutex;
+
+/* each byte is processed LSB first, as used for the CRC-16 and CRC-32 functions */
+static void
+fu_crc_table_init_reflected(FuCrcTable *table, guint32 polynomial)
+{
+	for (guint i = 0; i < 256; i++) {
+		guint32 crc = i;
+		for (guint j = 0; j < 8; j++)
+			crc = (crc >> 1) ^ (polynomial & -(crc & 1));
+		table->slice[0][i] = crc;
+	}
+	for (guint k = 1; k < 8; k++) {
+		for (guint i = 0; i < 256; i++) {
+			guint32 crc = table->slice[k - 1][i];
+			table->slice[k][i] = (crc >> 8) ^ table->slice[0][crc & 0xFF];
+		}
+	}
+}
+
+/* each byte is processed MSB first, as used for the CRC-8 functions */
+static void
+fu_crc_table_init_msb8(FuCrcTable *table, guint8 polynomial)
+{
+	for (guint i = 0; i < 256; i++) {
+		guint8 crc = i;
+		for (guint j = 0; j < 8; j++) {
+			if (crc & 0x80)
+				crc = (guint8)((crc << 1) ^ polynomial);
+			else
+				crc = (guint8)(crc << 1);
+		}
+		table->slice[0][i] = crc;
+	}
+	for (guint k = 1; k < 8; k++) {
+		for (guint i = 0; i < 256; i++)
+			table->slice[k][i] = table->slice[0][table->slice[k - 1][i]];
+	}
+}
+
+/* the table only depends on the width and polynomial, and not the initial value */
+static const FuCrcTable *
+fu_crc_table_get(guint width, guint32 polynomial)
+{
+	FuCrcTable *table;
+	guint64 key = ((guint64)width << 32) | polynomial;
+	g_autofree guint64 *key_new = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_crc_tables_mutex);
+
+	if (fu_crc_tables == NULL)
+		fu_crc_tables = g_hash_table_new_full(g_int64_hash, g_int64_equal, g_free, g_free);
+	table = g_hash_table_lookup(fu_crc_tables, &key);
+	if (table != NULL)
+		return table;
+
+	/* build lazily, as most polynomials are never used */
+	table = g_new0(FuCrcTable, 1);
+	if (width == 8) {
+		fu_crc_table_init_msb8(table, polynomial);
+	} else {
+		fu_crc_table_init_reflected(table, polynomial);
+	}
+	key_new = g_new0(guint64, 1);
+	*key_new = key;
+	g_hash_table_insert(fu_crc_tables, g_steal_pointer(&key_new), table);
+	return table;
+}
+
+/**
+ * fu_crc8_step:
+ * @buf: memory buffer
+ * @bufsz: size of @buf
+ * @crc: initial CRC value, or the value returned from the previous call
+ * @polynomial: CRC polynomial, e.g. 0x07 for CCITT
+ *
+ * Computes the cyclic redundancy check value for the given memory buffer, allowing the CRC
+ * to be calculated in chunks. The returned value is not inverted, so when starting with
+ * @crc set to 0x00 the final value is the same as fu_crc8_full() if inverted using `~`.
+ *
+ * Returns: CRC value
+ *
+ * Since: 1.8.5
+ **/
+guint8
+fu_crc8_step(const guint8 *buf, gsize bufsz, guint8 crc, guint8 polynomial)
+{
+	const FuCrcTable *table;
+
+	/* bit-at-a-time */
+	if (bufsz < FU_CRC_TABLE_MIN_SIZE) {
+		for (gsize i = 0; i < bufsz; i++) {
+			crc ^= buf[i];
+			for (guint j = 0; j < 8; j++) {
+				if (crc & 0x80)
+					crc = (guint8)((crc << 1) ^ polynomial);
+				else
+					crc = (guint8)(crc << 1);
+			}
+		}
+		return crc;
+	}
+
+	/* slice-by-8 */
+	table = fu_crc_table_get(8, polynomial);
+	for (; bufsz >= 8; bufsz -= 8, buf += 8) {
+		crc = table->slice[7][crc ^ buf[0]] ^ table->slice[6][buf[1]] ^
+		      table->slice[5][buf[2]] ^ table->slice[4][buf[3]] ^
+		      table->slice[3][buf[4]] ^ table->slice[2][buf[5]] ^
+		      table->slice[1][buf[6]] ^ table->slice[0][buf[7]];
+	}
+	for (gsize i = 0; i < bufsz; i++)
+		crc = table->slice[0][crc ^ buf[i]];
+	return crc;
+}
+
 /**
  * fu_crc8_full:
  * @buf: memory buffer
@@ -27,15 +157,17 @@ guint8
 fu_crc8_full(const guint8 *buf, gsize bufsz, guint8 crc_init, guint8 polynomial)
 {
 	guint32 crc = crc_init;
-	for (gsize j = bufsz; j > 0; j--) {
-		crc ^= (*(buf++) << 8);
-		for (guint32 i = 8; i; i--) {
-			if (crc & 0x8000)
-				crc ^= ((polynomial | 0x100) << 7);
-			crc <<= 1;
-		}
+
+	/* @crc_init is shifted in with the first byte */
+	if (bufsz == 0)
+		return ~((guint8)(crc >> 8));
+	crc ^= (buf[0] << 8);
+	for (guint32 i = 8; i; i--) {
+		if (crc & 0x8000)
+			crc ^= ((polynomial | 0x100) << 7);
+		crc <<= 1;
 	}
-	return ~((guint8)(crc >> 8));
+	return ~fu_crc8_step(buf + 1, bufsz - 1, (guint8)(crc >> 8), polynomial);
 }
 
 /**
@@ -55,6 +187,55 @@ fu_crc8(const guint8 *buf, gsize bufsz)
 	return fu_crc8_full(buf, bufsz, 0x00, 0x07);
 }
 
+/**
+ * fu_crc16_step:
+ * @buf: memory buffer
+ * @bufsz: size of @buf
+ * @crc: initial CRC value, typically 0xFFFF, or the value returned from the previous call
+ * @polynomial: CRC polynomial, typically 0xA001 for IBM or 0x1021 for CCITT
+ *
+ * Computes the cyclic redundancy check value for the given memory buffer, allowing the CRC
+ * to be calculated in chunks. The returned value is not inverted, so the final value is the
+ * same as fu_crc16_full() if inverted using `~`.
+ *
+ * Returns: CRC value
+ *
+ * Since: 1.8.5
+ **/
+guint16
+fu_crc16_step(const guint8 *buf, gsize bufsz, guint16 crc, guint16 polynomial)
+{
+	const FuCrcTable *table;
+
+	/* bit-at-a-time */
+	if (bufsz < FU_CRC_TABLE_MIN_SIZE) {
+		for (gsize i = 0; i < bufsz; i++) {
+			crc = (guint16)(crc ^ buf[i]);
+			for (guint8 j = 0; j < 8; j++) {
+				if (crc & 0x1) {
+					crc = (crc >> 1) ^ polynomial;
+				} else {
+					crc >>= 1;
+				}
+			}
+		}
+		return crc;
+	}
+
+	/* slice-by-8 */
+	table = fu_crc_table_get(16, polynomial);
+	for (; bufsz >= 8; bufsz -= 8, buf += 8) {
+		crc = table->slice[7][(crc ^ buf[0]) & 0xFF] ^
+		      table->slice[6][((crc >> 8) ^ buf[1]) & 0xFF] ^ table->slice[5][buf[2]] ^
+		      table->slice[4][buf[3]] ^ table->slice[3][buf[4]] ^
+		      table->slice[2][buf[5]] ^ table->slice[1][buf[6]] ^
+		      table->slice[0][buf[7]];
+	}
+	for (gsize i = 0; i < bufsz; i++)
+		crc = (crc >> 8) ^ table->slice[0][(crc ^ buf[i]) & 0xFF];
+	return crc;
+}
+
 /**
  * fu_crc16_full:
  * @buf: memory buffer
@@ -71,17 +252,7 @@ fu_crc8(const guint8 *buf, gsize bufsz)
 guint16
 fu_crc16_full(const guint8 *buf, gsize bufsz, guint16 crc, guint16 polynomial)
 {
-	for (gsize len = bufsz; len > 0; len--) {
-		crc = (guint16)(crc ^ (*buf++));
-		for (guint8 i = 0; i < 8; i++) {
-			if (crc & 0x1) {
-				crc = (crc >> 1) ^ polynomial;
-			} else {
-				crc >>= 1;
-			}
-		}
-	}
-	return ~crc;
+	return ~fu_crc16_step(buf, bufsz, crc, polynomial);
 }
 
 /**
@@ -101,6 +272,74 @@ fu_crc16(const guint8 *buf, gsize bufsz)
 	return fu_crc16_full(buf, bufsz, 0xFFFF, 0xA001);
 }
 
+#if defined(__ARM_FEATURE_CRC32) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+/* the ARMv8 CRC32 instructions only support the IEEE 802.3 polynomial */
+static guint32
+fu_crc32_step_armv8(const guint8 *buf, gsize bufsz, guint32 crc)
+{
+	for (; bufsz >= 8; bufsz -= 8, buf += 8) {
+		guint64 tmp;
+		memcpy(&tmp, buf, sizeof(tmp));
+		crc = __crc32d(crc, tmp);
+	}
+	for (gsize i = 0; i < bufsz; i++)
+		crc = __crc32b(crc, buf[i]);
+	return crc;
+}
+#endif
+
+/**
+ * fu_crc32_step:
+ * @buf: memory buffer
+ * @bufsz: size of @buf
+ * @crc: initial CRC value, typically 0xFFFFFFFF, or the value returned from the previous call
+ * @polynomial: CRC polynomial, typically 0xEDB88320
+ *
+ * Computes the cyclic redundancy check value for the given memory buffer, allowing the CRC
+ * to be calculated in chunks. The returned value is not inverted, so the final value is the
+ * same as fu_crc32_full() if inverted using `~`.
+ *
+ * Returns: CRC value
+ *
+ * Since: 1.8.5
+ **/
+guint32
+fu_crc32_step(const guint8 *buf, gsize bufsz, guint32 crc, guint32 polynomial)
+{
+	const FuCrcTable *table;
+
+#if defined(__ARM_FEATURE_CRC32) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+	if (polynomial == 0xEDB88320)
+		return fu_crc32_step_armv8(buf, bufsz, crc);
+#endif
+
+	/* bit-at-a-time */
+	if (bufsz < FU_CRC_TABLE_MIN_SIZE) {
+		for (gsize i = 0; i < bufsz; i++) {
+			crc = crc ^ buf[i];
+			for (guint32 bit = 0; bit < 8; bit++) {
+				guint32 mask = -(crc & 1);
+				crc = (crc >> 1) ^ (polynomial & mask);
+			}
+		}
+		return crc;
+	}
+
+	/* slice-by-8 */
+	table = fu_crc_table_get(32, polynomial);
+	for (; bufsz >= 8; bufsz -= 8, buf += 8) {
+		crc = table->slice[7][(crc ^ buf[0]) & 0xFF] ^
+		      table->slice[6][((crc >> 8) ^ buf[1]) & 0xFF] ^
+		      table->slice[5][((crc >> 16) ^ buf[2]) & 0xFF] ^
+		      table->slice[4][(crc >> 24) ^ buf[3]] ^ table->slice[3][buf[4]] ^
+		      table->slice[2][buf[5]] ^ table->slice[1][buf[6]] ^
+		      table->slice[0][buf[7]];
+	}
+	for (gsize i = 0; i < bufsz; i++)
+		crc = (crc >> 8) ^ table->slice[0][(crc ^ buf[i]) & 0xFF];
+	return crc;
+}
+
 /**
  * fu_crc32_full:
  * @buf: memory buffer
@@ -117,15 +356,7 @@ fu_crc16(const guint8 *buf, gsize bufsz)
 guint32
 fu_crc32_full(const guint8 *buf, gsize bufsz, guint32 crc, guint32 polynomial)
 {
-	for (guint32 idx = 0; idx < bufsz; idx++) {
-		guint8 data = *buf++;
-		crc = crc ^ data;
-		for (guint32 bit = 0; bit < 8; bit++) {
-			guint32 mask = -(crc & 1);
-			crc = (crc >> 1) ^ (polynomial & mask);
-		}
-	}
-	return ~crc;
+	return ~fu_crc32_step(buf, bufsz, crc, polynomial);
 }
 
 /**
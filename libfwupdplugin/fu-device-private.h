@@ -38,6 +38,12 @@ void
 fu_device_incorporate_from_component(FuDevice *device, XbNode *component);
 void
 fu_device_convert_instance_ids(FuDevice *self);
+GHashTable *
+fu_device_get_io_stats(FuDevice *self);
+void
+fu_device_clear_io_stats(FuDevice *self);
+void
+fu_device_incorporate_io_stats(FuDevice *self, FuDevice *donor);
 gchar *
 fu_device_get_guids_as_str(FuDevice *self);
 GPtrArray *
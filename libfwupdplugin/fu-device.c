@@ -20,6 +20,7 @@
 #include "fu-quirks.h"
 #include "fu-security-attr.h"
 #include "fu-string.h"
+#include "fu-trace-private.h"
 #include "fu-version-common.h"
 
 #define FU_DEVICE_RETRY_OPEN_COUNT 5
@@ -81,6 +82,8 @@ typedef struct {
 	gchar *custom_flags;
 	gulong notify_flags_handler_id;
 	GHashTable *instance_hash;
+	GHashTable *io_stats; /* (nullable): kind:FuDeviceIoStat */
+	GMutex io_stats_mutex;
 } FuDevicePrivate;
 
 typedef struct {
@@ -95,6 +98,19 @@ typedef struct {
 	gchar *reason;
 } FuDeviceInhibit;
 
+/* latency histogram buckets are decades starting at <10us, and the last is >=1s */
+#define FU_DEVICE_IO_STAT_BUCKETS 7
+
+typedef struct {
+	guint64 count;
+	guint64 bytes;
+	guint64 retries;
+	guint64 errors;
+	guint64 elapsed; /* us */
+	guint64 elapsed_max;
+	guint64 buckets[FU_DEVICE_IO_STAT_BUCKETS];
+} FuDeviceIoStat;
+
 enum {
 	PROP_0,
 	PROP_PHYSICAL_ID,
@@ -106,13 +122,54 @@ enum {
 	PROP_LAST
 };
 
-enum { SIGNAL_CHILD_ADDED, SIGNAL_CHILD_REMOVED, SIGNAL_REQUEST, SIGNAL_LAST };
+enum {
+	SIGNAL_CHILD_ADDED,
+	SIGNAL_CHILD_REMOVED,
+	SIGNAL_REQUEST,
+	SIGNAL_IDENTITY_CHANGED,
+	SIGNAL_LAST
+};
 
 static guint signals[SIGNAL_LAST] = {0};
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuDevice, fu_device, FWUPD_TYPE_DEVICE)
 #define GET_PRIVATE(o) (fu_device_get_instance_private(o))
 
+/* instance-id : GUID, shared by all devices and emptied when full */
+static GHashTable *fu_device_guid_cache = NULL;
+static GMutex fu_device_guid_cache_mutex;
+
+static void
+fu_device_identity_changed(FuDevice *self)
+{
+	g_signal_emit(self, signals[SIGNAL_IDENTITY_CHANGED], 0);
+}
+
+/* far more than the instance IDs of every device on a typical system */
+#define FU_DEVICE_GUID_CACHE_MAX 4096
+
+/* the same instance IDs are hashed many times when matching devices, and SHA-1 is slow */
+static gchar *
+fu_device_instance_id_to_guid(const gchar *instance_id)
+{
+	gchar *guid;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&fu_device_guid_cache_mutex);
+
+	if (fu_device_guid_cache == NULL)
+		fu_device_guid_cache =
+		    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	guid = g_hash_table_lookup(fu_device_guid_cache, instance_id);
+	if (guid != NULL)
+		return g_strdup(guid);
+	guid = fwupd_guid_hash_string(instance_id);
+	if (guid == NULL)
+		return NULL;
+	if (g_hash_table_size(fu_device_guid_cache) >= FU_DEVICE_GUID_CACHE_MAX)
+		g_hash_table_remove_all(fu_device_guid_cache);
+	g_hash_table_insert(fu_device_guid_cache, g_strdup(instance_id), g_strdup(guid));
+	return guid;
+}
+
 static void
 fu_device_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
 {
@@ -237,6 +294,8 @@ fu_device_internal_flag_to_string(FuDeviceInternalFlags flag)
 		return "auto-pause-polling";
 	if (flag == FU_DEVICE_INTERNAL_FLAG_ONLY_WAIT_FOR_REPLUG)
 		return "only-wait-for-replug";
+	if (flag == FU_DEVICE_INTERNAL_FLAG_CONCURRENT_INSTALL)
+		return "concurrent-install";
 	return NULL;
 }
 
@@ -305,6 +364,8 @@ fu_device_internal_flag_from_string(const gchar *flag)
 		return FU_DEVICE_INTERNAL_AUTO_PAUSE_POLLING;
 	if (g_strcmp0(flag, "only-wait-for-replug") == 0)
 		return FU_DEVICE_INTERNAL_FLAG_ONLY_WAIT_FOR_REPLUG;
+	if (g_strcmp0(flag, "concurrent-install") == 0)
+		return FU_DEVICE_INTERNAL_FLAG_CONCURRENT_INSTALL;
 	return FU_DEVICE_INTERNAL_FLAG_UNKNOWN;
 }
 
@@ -484,6 +545,193 @@ fu_device_get_request_cnt(FuDevice *self, FwupdRequestKind request_kind)
 	return priv->request_cnts[request_kind];
 }
 
+static FuDeviceIoStat *
+fu_device_ensure_io_stat(FuDevice *self, const gchar *kind)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuDeviceIoStat *stat;
+
+	if (priv->io_stats == NULL)
+		priv->io_stats = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	stat = g_hash_table_lookup(priv->io_stats, kind);
+	if (stat == NULL) {
+		stat = g_new0(FuDeviceIoStat, 1);
+		g_hash_table_insert(priv->io_stats, g_strdup(kind), stat);
+	}
+	return stat;
+}
+
+/**
+ * fu_device_add_io_stat:
+ * @self: a #FuDevice
+ * @kind: the operation, e.g. `ioctl` or `set-report`
+ * @bytes: number of bytes transferred
+ * @retries: number of times the operation was retried
+ * @elapsed: time taken in microseconds, including any retries
+ * @success: if the operation succeeded
+ *
+ * Records a low-level I/O operation so that the time spent talking to the hardware can be
+ * compared between devices.
+ *
+ * Since: 1.8.5
+ **/
+void
+fu_device_add_io_stat(FuDevice *self,
+		      const gchar *kind,
+		      gsize bytes,
+		      guint retries,
+		      gint64 elapsed,
+		      gboolean success)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuDeviceIoStat *stat;
+	guint idx = 0;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_DEVICE(self));
+	g_return_if_fail(kind != NULL);
+
+	locker = g_mutex_locker_new(&priv->io_stats_mutex);
+	stat = fu_device_ensure_io_stat(self, kind);
+	stat->count++;
+	stat->bytes += bytes;
+	stat->retries += retries;
+	if (!success)
+		stat->errors++;
+	if (elapsed < 0)
+		elapsed = 0;
+	stat->elapsed += elapsed;
+	stat->elapsed_max = MAX(stat->elapsed_max, (guint64)elapsed);
+	for (gint64 limit = 10; elapsed >= limit && idx < FU_DEVICE_IO_STAT_BUCKETS - 1;
+	     limit *= 10)
+		idx++;
+	stat->buckets[idx]++;
+}
+
+static gchar *
+fu_device_io_stat_to_string(FuDeviceIoStat *stat)
+{
+	const gchar *bucket_names[] = {"<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"};
+	GString *str = g_string_new(NULL);
+
+	g_string_append_printf(str,
+			       "count=%" G_GUINT64_FORMAT " bytes=%" G_GUINT64_FORMAT
+			       " retries=%" G_GUINT64_FORMAT " errors=%" G_GUINT64_FORMAT
+			       " total=%.1fms max=%.1fms latency=",
+			       stat->count,
+			       stat->bytes,
+			       stat->retries,
+			       stat->errors,
+			       (gdouble)stat->elapsed / 1000.f,
+			       (gdouble)stat->elapsed_max / 1000.f);
+	for (guint i = 0; i < FU_DEVICE_IO_STAT_BUCKETS; i++) {
+		if (i > 0)
+			g_string_append_c(str, ',');
+		g_string_append_printf(str,
+				       "%s:%" G_GUINT64_FORMAT,
+				       bucket_names[i],
+				       stat->buckets[i]);
+	}
+	return g_string_free(str, FALSE);
+}
+
+/**
+ * fu_device_get_io_stats:
+ * @self: a #FuDevice
+ *
+ * Gets a summary of the I/O operations recorded using fu_device_add_io_stat().
+ *
+ * Returns: (transfer container) (element-type utf8 utf8): operation kind to summary
+ *
+ * Since: 1.8.5
+ **/
+GHashTable *
+fu_device_get_io_stats(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	GHashTableIter iter;
+	gpointer key, value;
+	GHashTable *hash = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_DEVICE(self), NULL);
+
+	locker = g_mutex_locker_new(&priv->io_stats_mutex);
+	if (priv->io_stats == NULL)
+		return hash;
+	g_hash_table_iter_init(&iter, priv->io_stats);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		g_hash_table_insert(hash,
+				    g_strdup(key),
+				    fu_device_io_stat_to_string((FuDeviceIoStat *)value));
+	}
+	return hash;
+}
+
+/**
+ * fu_device_clear_io_stats:
+ * @self: a #FuDevice
+ *
+ * Clears all the recorded I/O statistics, typically done before an update.
+ *
+ * Since: 1.8.5
+ **/
+void
+fu_device_clear_io_stats(FuDevice *self)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_DEVICE(self));
+
+	locker = g_mutex_locker_new(&priv->io_stats_mutex);
+	if (priv->io_stats != NULL)
+		g_hash_table_remove_all(priv->io_stats);
+}
+
+/**
+ * fu_device_incorporate_io_stats:
+ * @self: a #FuDevice
+ * @donor: another #FuDevice
+ *
+ * Adds the I/O statistics of @donor to @self, typically used when the device has been
+ * replaced by a new object after a replug.
+ *
+ * Since: 1.8.5
+ **/
+void
+fu_device_incorporate_io_stats(FuDevice *self, FuDevice *donor)
+{
+	FuDevicePrivate *priv = GET_PRIVATE(self);
+	FuDevicePrivate *priv_donor = GET_PRIVATE(donor);
+	GHashTableIter iter;
+	gpointer key, value;
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_autoptr(GMutexLocker) locker_donor = NULL;
+
+	g_return_if_fail(FU_IS_DEVICE(self));
+	g_return_if_fail(FU_IS_DEVICE(donor));
+	g_return_if_fail(self != donor);
+
+	locker_donor = g_mutex_locker_new(&priv_donor->io_stats_mutex);
+	if (priv_donor->io_stats == NULL)
+		return;
+	locker = g_mutex_locker_new(&priv->io_stats_mutex);
+	g_hash_table_iter_init(&iter, priv_donor->io_stats);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		FuDeviceIoStat *stat_donor = (FuDeviceIoStat *)value;
+		FuDeviceIoStat *stat = fu_device_ensure_io_stat(self, key);
+		stat->count += stat_donor->count;
+		stat->bytes += stat_donor->bytes;
+		stat->retries += stat_donor->retries;
+		stat->errors += stat_donor->errors;
+		stat->elapsed += stat_donor->elapsed;
+		stat->elapsed_max = MAX(stat->elapsed_max, stat_donor->elapsed_max);
+		for (guint i = 0; i < FU_DEVICE_IO_STAT_BUCKETS; i++)
+			stat->buckets[i] += stat_donor->buckets[i];
+	}
+}
+
 /**
  * fu_device_set_private_flags:
  * @self: a #FuDevice
@@ -951,6 +1199,7 @@ fu_device_set_equivalent_id(FuDevice *self, const gchar *equivalent_id)
 
 	g_free(priv->equivalent_id);
 	priv->equivalent_id = g_strdup(equivalent_id);
+	fu_device_identity_changed(self);
 }
 
 /**
@@ -1447,7 +1696,7 @@ fu_device_add_parent_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = fu_device_instance_id_to_guid(guid);
 		if (fu_device_has_parent_guid(self, tmp))
 			return;
 		g_debug("using %s for %s", tmp, guid);
@@ -1993,8 +2242,10 @@ fu_device_add_guid_safe(FuDevice *self, const gchar *guid, FuDeviceInstanceFlags
 {
 	/* add the device GUID before adding additional GUIDs from quirks
 	 * to ensure the bootloader GUID is listed after the runtime GUID */
-	if ((flags & FU_DEVICE_INSTANCE_FLAG_ONLY_QUIRKS) == 0)
+	if ((flags & FU_DEVICE_INSTANCE_FLAG_ONLY_QUIRKS) == 0) {
 		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+		fu_device_identity_changed(self);
+	}
 	if ((flags & FU_DEVICE_INSTANCE_FLAG_NO_QUIRKS) == 0)
 		fu_device_add_guid_quirks(self, guid);
 }
@@ -2018,7 +2269,9 @@ fu_device_has_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = fu_device_instance_id_to_guid(guid);
+		if (tmp == NULL)
+			return FALSE;
 		return fwupd_device_has_guid(FWUPD_DEVICE(self), tmp);
 	}
 
@@ -2057,15 +2310,17 @@ fu_device_add_instance_id_full(FuDevice *self,
 	 * calling fu_device_add_guid_safe() -- but we want the quirks to match
 	 * so the plugin is set, but not the LVFS metadata to match firmware
 	 * until we're sure the device isn't using _NO_AUTO_INSTANCE_IDS */
-	guid = fwupd_guid_hash_string(instance_id);
+	guid = fu_device_instance_id_to_guid(instance_id);
 	if ((flags & FU_DEVICE_INSTANCE_FLAG_NO_QUIRKS) == 0)
 		fu_device_add_guid_quirks(self, guid);
 	if ((flags & FU_DEVICE_INSTANCE_FLAG_ONLY_QUIRKS) == 0)
 		fwupd_device_add_instance_id(FWUPD_DEVICE(self), instance_id);
 
 	/* already done by ->setup(), so this must be ->registered() */
-	if (priv->done_setup)
+	if (priv->done_setup) {
 		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+		fu_device_identity_changed(self);
+	}
 }
 
 /**
@@ -2153,13 +2408,17 @@ fu_device_add_counterpart_guid(FuDevice *self, const gchar *guid)
 
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
-		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
+		g_autofree gchar *tmp = fu_device_instance_id_to_guid(guid);
+		if (tmp == NULL)
+			return;
 		fwupd_device_add_guid(FWUPD_DEVICE(self), tmp);
+		fu_device_identity_changed(self);
 		return;
 	}
 
 	/* already valid */
 	fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+	fu_device_identity_changed(self);
 }
 
 /**
@@ -2513,6 +2772,7 @@ fu_device_set_id(FuDevice *self, const gchar *id)
 	}
 	fwupd_device_set_id(FWUPD_DEVICE(self), id_hash);
 	priv->device_id_valid = TRUE;
+	fu_device_identity_changed(self);
 
 	/* ensure the parent ID is set */
 	children = fu_device_get_children(self);
@@ -3041,6 +3301,7 @@ fu_device_set_logical_id(FuDevice *self, const gchar *logical_id)
 	g_free(priv->logical_id);
 	priv->logical_id = g_strdup(logical_id);
 	priv->device_id_valid = FALSE;
+	fu_device_identity_changed(self);
 	g_object_notify(G_OBJECT(self), "logical-id");
 }
 
@@ -3175,6 +3436,7 @@ fu_device_set_physical_id(FuDevice *self, const gchar *physical_id)
 	g_free(priv->physical_id);
 	priv->physical_id = g_strdup(physical_id);
 	priv->device_id_valid = FALSE;
+	fu_device_identity_changed(self);
 	g_object_notify(G_OBJECT(self), "physical-id");
 }
 
@@ -3933,6 +4195,7 @@ fu_device_write_firmware(FuDevice *self,
 {
 	FuDeviceClass *klass = FU_DEVICE_GET_CLASS(self);
 	FuDevicePrivate *priv = GET_PRIVATE(self);
+	gboolean ret;
 	g_autoptr(FuFirmware) firmware = NULL;
 	g_autofree gchar *str = NULL;
 
@@ -3958,7 +4221,10 @@ fu_device_write_firmware(FuDevice *self,
 	g_debug("installing onto %s:\n%s", fu_device_get_id(self), str);
 
 	/* call vfunc */
-	if (!klass->write_firmware(self, firmware, progress, flags, error))
+	FU_TRACE1(device_write_firmware_begin, fu_device_get_id(self));
+	ret = klass->write_firmware(self, firmware, progress, flags, error);
+	FU_TRACE2(device_write_firmware_end, fu_device_get_id(self), ret);
+	if (!ret)
 		return FALSE;
 
 	/* the device set an UpdateMessage (possibly from a quirk, or XML file)
@@ -4400,22 +4666,27 @@ fu_device_open_internal(FuDevice *self, GError **error)
 gboolean
 fu_device_open(FuDevice *self, GError **error)
 {
+	FuDevice *target = self;
+	gboolean ret;
+
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	/* use parent */
 	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_USE_PARENT_FOR_OPEN)) {
-		FuDevice *parent = fu_device_get_parent(self);
-		if (parent == NULL) {
+		target = fu_device_get_parent(self);
+		if (target == NULL) {
 			g_set_error_literal(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED,
 					    "no parent device");
 			return FALSE;
 		}
-		return fu_device_open_internal(parent, error);
 	}
-	return fu_device_open_internal(self, error);
+	FU_TRACE1(device_open_begin, fu_device_get_id(target));
+	ret = fu_device_open_internal(target, error);
+	FU_TRACE2(device_open_end, fu_device_get_id(target), ret);
+	return ret;
 }
 
 static gboolean
@@ -4472,22 +4743,27 @@ fu_device_close_internal(FuDevice *self, GError **error)
 gboolean
 fu_device_close(FuDevice *self, GError **error)
 {
+	FuDevice *target = self;
+	gboolean ret;
+
 	g_return_val_if_fail(FU_IS_DEVICE(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
 	/* use parent */
 	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_USE_PARENT_FOR_OPEN)) {
-		FuDevice *parent = fu_device_get_parent(self);
-		if (parent == NULL) {
+		target = fu_device_get_parent(self);
+		if (target == NULL) {
 			g_set_error_literal(error,
 					    FWUPD_ERROR,
 					    FWUPD_ERROR_NOT_SUPPORTED,
 					    "no parent device");
 			return FALSE;
 		}
-		return fu_device_close_internal(parent, error);
 	}
-	return fu_device_close_internal(self, error);
+	FU_TRACE1(device_close_begin, fu_device_get_id(target));
+	ret = fu_device_close_internal(target, error);
+	FU_TRACE2(device_close_end, fu_device_get_id(target), ret);
+	return ret;
 }
 
 /**
@@ -4560,7 +4836,7 @@ fu_device_rescan(FuDevice *self, GError **error)
 
 	/* remove all GUIDs */
 	g_ptr_array_set_size(fu_device_get_instance_ids(self), 0);
-	g_ptr_array_set_size(fu_device_get_guids(self), 0);
+	fwupd_device_remove_all_guids(FWUPD_DEVICE(self));
 
 	/* subclassed */
 	if (klass->rescan != NULL) {
@@ -4615,17 +4891,19 @@ fu_device_set_progress(FuDevice *self, FuProgress *progress)
 void
 fu_device_convert_instance_ids(FuDevice *self)
 {
-	GPtrArray *instance_ids;
+	GPtrArray *instance_ids = fwupd_device_get_instance_ids(FWUPD_DEVICE(self));
 
 	/* OEM specific hardware */
-	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_NO_AUTO_INSTANCE_IDS))
-		return;
-	instance_ids = fwupd_device_get_instance_ids(FWUPD_DEVICE(self));
-	for (guint i = 0; i < instance_ids->len; i++) {
-		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
-		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+	if (!fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_NO_AUTO_INSTANCE_IDS)) {
+		for (guint i = 0; i < instance_ids->len; i++) {
+			const gchar *instance_id = g_ptr_array_index(instance_ids, i);
+			g_autofree gchar *guid = fu_device_instance_id_to_guid(instance_id);
+			fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+		}
 	}
+
+	/* also when nothing was added, as fu_device_rescan() may have removed GUIDs */
+	fu_device_identity_changed(self);
 }
 
 /**
@@ -4980,6 +5258,7 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 
 	/* now the base class, where all the interesting bits are */
 	fwupd_device_incorporate(FWUPD_DEVICE(self), FWUPD_DEVICE(donor));
+	fu_device_identity_changed(self);
 
 	/* set by the superclass */
 	if (fu_device_get_id(self) != NULL)
@@ -4992,7 +5271,7 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 	/* call the set_quirk_kv() vfunc for the superclassed object */
 	for (guint i = 0; i < instance_ids->len; i++) {
 		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
-		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
+		g_autofree gchar *guid = fu_device_instance_id_to_guid(instance_id);
 		fu_device_add_guid_quirks(self, guid);
 	}
 }
@@ -5501,6 +5780,24 @@ fu_device_class_init(FuDeviceClass *klass)
 					       G_TYPE_NONE,
 					       1,
 					       FWUPD_TYPE_REQUEST);
+	/**
+	 * FuDevice::identity-changed:
+	 * @self: the #FuDevice instance that emitted the signal
+	 *
+	 * The ::identity-changed signal is emitted when the device ID, equivalent ID, GUIDs,
+	 * physical ID or logical ID have changed.
+	 *
+	 * Since: 1.8.5
+	 **/
+	signals[SIGNAL_IDENTITY_CHANGED] = g_signal_new("identity-changed",
+							G_TYPE_FROM_CLASS(object_class),
+							G_SIGNAL_RUN_LAST,
+							0,
+							NULL,
+							NULL,
+							g_cclosure_marshal_VOID__VOID,
+							G_TYPE_NONE,
+							0);
 
 	/**
 	 * FuDevice:physical-id:
@@ -5599,6 +5896,7 @@ fu_device_init(FuDevice *self)
 	priv->acquiesce_delay = 50; /* ms */
 	g_rw_lock_init(&priv->parent_guids_mutex);
 	g_rw_lock_init(&priv->metadata_mutex);
+	g_mutex_init(&priv->io_stats_mutex);
 	priv->notify_flags_handler_id = g_signal_connect(FWUPD_DEVICE(self),
 							 "notify::flags",
 							 G_CALLBACK(fu_device_flags_notify_cb),
@@ -5613,6 +5911,7 @@ fu_device_finalize(GObject *object)
 
 	g_rw_lock_clear(&priv->metadata_mutex);
 	g_rw_lock_clear(&priv->parent_guids_mutex);
+	g_mutex_clear(&priv->io_stats_mutex);
 
 	if (priv->alternate != NULL)
 		g_object_unref(priv->alternate);
@@ -5626,6 +5925,8 @@ fu_device_finalize(GObject *object)
 		g_hash_table_unref(priv->metadata);
 	if (priv->inhibits != NULL)
 		g_hash_table_unref(priv->inhibits);
+	if (priv->io_stats != NULL)
+		g_hash_table_unref(priv->io_stats);
 	if (priv->parent_physical_ids != NULL)
 		g_ptr_array_unref(priv->parent_physical_ids);
 	if (priv->private_flag_items != NULL)
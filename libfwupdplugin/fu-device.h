@@ -466,6 +466,19 @@ typedef guint64 FuDeviceInternalFlags;
  */
 #define FU_DEVICE_INTERNAL_FLAG_ONLY_WAIT_FOR_REPLUG (1ull << 25)
 
+/**
+ * FU_DEVICE_INTERNAL_FLAG_CONCURRENT_INSTALL:
+ *
+ * The device can be updated at the same time as other devices with this flag that do not share
+ * a parent or proxy device, if the daemon has been configured to install in parallel.
+ *
+ * The firmware is written from a worker thread, so the plugin must not share any state between
+ * devices, and must only wait for the replug of this device.
+ *
+ * Since: 1.8.5
+ */
+#define FU_DEVICE_INTERNAL_FLAG_CONCURRENT_INSTALL (1ull << 26)
+
 /* accessors */
 gchar *
 fu_device_to_string(FuDevice *self);
@@ -749,3 +762,10 @@ gboolean
 fu_device_build_instance_id_quirk(FuDevice *self, GError **error, const gchar *subsystem, ...);
 FuDeviceLocker *
 fu_device_poll_locker_new(FuDevice *self, GError **error);
+void
+fu_device_add_io_stat(FuDevice *self,
+		      const gchar *kind,
+		      gsize bytes,
+		      guint retries,
+		      gint64 elapsed,
+		      gboolean success);
@@ -363,6 +363,7 @@ static void
 fu_dfuse_firmware_init(FuDfuseFirmware *self)
 {
 	fu_dfu_firmware_set_version(FU_DFU_FIRMWARE(self), FU_DFU_FIRMARE_VERSION_DFUSE);
+	fu_firmware_set_search_magic(FU_FIRMWARE(self), (const guint8 *)"DfuSe", 5, 0x0);
 }
 
 static void
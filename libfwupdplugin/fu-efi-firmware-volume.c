@@ -414,7 +414,13 @@ static void
 fu_efi_firmware_volume_init(FuEfiFirmwareVolume *self)
 {
 	FuEfiFirmwareVolumePrivate *priv = GET_PRIVATE(self);
+	guint8 magic[4] = {0x0};
 	priv->attrs = 0xfeff;
+	fu_memwrite_uint32(magic, FU_EFI_FIRMWARE_VOLUME_SIGNATURE, G_LITTLE_ENDIAN);
+	fu_firmware_set_search_magic(FU_FIRMWARE(self),
+				     magic,
+				     sizeof(magic),
+				     FU_EFI_FIRMWARE_VOLUME_OFFSET_SIGNATURE);
 }
 
 static void
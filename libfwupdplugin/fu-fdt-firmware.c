@@ -736,8 +736,14 @@ fu_fdt_firmware_build(FuFirmware *firmware, XbNode *n, GError **error)
 static void
 fu_fdt_firmware_init(FuFdtFirmware *self)
 {
+	guint8 magic[4] = {0x0};
 	g_type_ensure(FU_TYPE_FDT_IMAGE);
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_VID_PID);
+	fu_memwrite_uint32(magic, FDT_MAGIC, G_BIG_ENDIAN);
+	fu_firmware_set_search_magic(FU_FIRMWARE(self),
+				     magic,
+				     sizeof(magic),
+				     G_STRUCT_OFFSET(FuFdtHeader, magic));
 }
 
 static void
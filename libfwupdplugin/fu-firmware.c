@@ -40,6 +40,8 @@ typedef struct {
 	gsize size;
 	GPtrArray *chunks;  /* nullable, element-type FuChunk */
 	GPtrArray *patches; /* nullable, element-type FuFirmwarePatch */
+	GBytes *search_magic; /* nullable */
+	gsize search_magic_offset;
 } FuFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuFirmware, fu_firmware, G_TYPE_OBJECT)
@@ -620,6 +622,36 @@ fu_firmware_set_alignment(FuFirmware *self, guint8 alignment)
 	priv->alignment = alignment;
 }
 
+/**
+ * fu_firmware_set_search_magic:
+ * @self: a #FuFirmware
+ * @buf: (nullable): magic bytes, or %NULL to unset
+ * @bufsz: size of @buf
+ * @offset: offset of the magic bytes from the start of the header
+ *
+ * Sets the bytes that are always found at @offset when the `->check_magic()` vfunc succeeds.
+ *
+ * When searching the firmware for the header, the base class then only calls `->check_magic()`
+ * at the offsets where the magic bytes have been found, rather than at every offset.
+ *
+ * Subclasses that override `->check_magic()` to look for different data should unset this.
+ *
+ * Since: 1.8.5
+ **/
+void
+fu_firmware_set_search_magic(FuFirmware *self, const guint8 *buf, gsize bufsz, gsize offset)
+{
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_FIRMWARE(self));
+	if (priv->search_magic != NULL) {
+		g_bytes_unref(priv->search_magic);
+		priv->search_magic = NULL;
+	}
+	if (buf != NULL && bufsz > 0)
+		priv->search_magic = g_bytes_new(buf, bufsz);
+	priv->search_magic_offset = offset;
+}
+
 /**
  * fu_firmware_get_alignment:
  * @self: a #FuFirmware
@@ -811,6 +843,7 @@ fu_firmware_check_magic_for_offset(FuFirmware *self,
 				   GError **error)
 {
 	FuFirmwareClass *klass = FU_FIRMWARE_GET_CLASS(self);
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
 
 	/* not implemented */
 	if (klass->check_magic == NULL)
@@ -838,12 +871,42 @@ fu_firmware_check_magic_for_offset(FuFirmware *self,
 		return TRUE;
 	}
 
-	/* increment the offset, looking for the magic */
-	for (gsize offset_tmp = *offset; offset_tmp < g_bytes_get_size(fw); offset_tmp++) {
-		if (klass->check_magic(self, fw, offset_tmp, NULL)) {
-			fu_firmware_set_offset(self, offset_tmp);
-			*offset = offset_tmp;
-			return TRUE;
+	/* only check where the magic bytes are found */
+	if (priv->search_magic != NULL) {
+		gsize bufsz = 0;
+		gsize magicsz = 0;
+		const guint8 *buf = g_bytes_get_data(fw, &bufsz);
+		const guint8 *magic = g_bytes_get_data(priv->search_magic, &magicsz);
+		gsize offset_tmp = *offset + priv->search_magic_offset;
+
+		while (offset_tmp < bufsz) {
+			gsize offset_found = 0;
+			gsize offset_hdr;
+			if (!fu_memmem_safe(buf + offset_tmp,
+					    bufsz - offset_tmp,
+					    magic,
+					    magicsz,
+					    &offset_found,
+					    NULL))
+				break;
+			offset_tmp += offset_found;
+			offset_hdr = offset_tmp - priv->search_magic_offset;
+			if (klass->check_magic(self, fw, offset_hdr, NULL)) {
+				fu_firmware_set_offset(self, offset_hdr);
+				*offset = offset_hdr;
+				return TRUE;
+			}
+			offset_tmp++;
+		}
+	} else {
+		/* increment the offset, looking for the magic */
+		for (gsize offset_tmp = *offset; offset_tmp < g_bytes_get_size(fw);
+		     offset_tmp++) {
+			if (klass->check_magic(self, fw, offset_tmp, NULL)) {
+				fu_firmware_set_offset(self, offset_tmp);
+				*offset = offset_tmp;
+				return TRUE;
+			}
 		}
 	}
 
@@ -1215,6 +1278,8 @@ fu_firmware_build_from_xml(FuFirmware *self, const gchar *xml, GError **error)
  *
  * Parses a firmware file, typically breaking the firmware into images.
  *
+ * NOTE: the entire file is read into memory first, and the images are windows into that buffer.
+ *
  * Returns: %TRUE for success
  *
  * Since: 1.3.3
@@ -1377,6 +1442,9 @@ fu_firmware_write_chunk(FuFirmware *self, guint64 address, guint64 chunk_sz_max,
  *
  * Writes a firmware, typically packing the images into a binary blob.
  *
+ * The data is written using fu_firmware_write_stream() to a temporary file, which then replaces
+ * @file only if the write succeeded.
+ *
  * Returns: %TRUE for success
  *
  * Since: 1.3.3
@@ -1384,24 +1452,150 @@ fu_firmware_write_chunk(FuFirmware *self, guint64 address, guint64 chunk_sz_max,
 gboolean
 fu_firmware_write_file(FuFirmware *self, GFile *file, GError **error)
 {
-	g_autoptr(GBytes) blob = NULL;
+	g_autofree gchar *basename = NULL;
+	g_autofree gchar *basename_tmp = NULL;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GFile) file_parent = NULL;
+	g_autoptr(GFile) file_tmp = NULL;
+	g_autoptr(GFileOutputStream) stream = NULL;
 
 	g_return_val_if_fail(FU_IS_FIRMWARE(self), FALSE);
 	g_return_val_if_fail(G_IS_FILE(file), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	blob = fu_firmware_write(self, error);
+	/* write to a temporary file next to the target so that a failure part way through
+	 * never leaves an empty or partial file in its place */
+	file_parent = g_file_get_parent(file);
+	if (file_parent == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "cannot write to the root directory");
+		return FALSE;
+	}
+	basename = g_file_get_basename(file);
+	basename_tmp = g_strdup_printf(".%s.%08x", basename, g_random_int());
+	file_tmp = g_file_get_child(file_parent, basename_tmp);
+	stream = g_file_create(file_tmp, G_FILE_CREATE_NONE, NULL, error);
+	if (stream == NULL)
+		return FALSE;
+	if (!fu_firmware_write_stream(self, G_OUTPUT_STREAM(stream), error)) {
+		g_output_stream_close(G_OUTPUT_STREAM(stream), NULL, NULL);
+		if (!g_file_delete(file_tmp, NULL, &error_local))
+			g_debug("ignoring: %s", error_local->message);
+		return FALSE;
+	}
+	if (!g_output_stream_close(G_OUTPUT_STREAM(stream), NULL, error) ||
+	    !g_file_move(file_tmp, file, G_FILE_COPY_OVERWRITE, NULL, NULL, NULL, error)) {
+		if (!g_file_delete(file_tmp, NULL, &error_local))
+			g_debug("ignoring: %s", error_local->message);
+		return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gint
+fu_firmware_patch_sort_cb(gconstpointer a, gconstpointer b)
+{
+	FuFirmwarePatch *ptch1 = *((FuFirmwarePatch **)a);
+	FuFirmwarePatch *ptch2 = *((FuFirmwarePatch **)b);
+	if (ptch1->offset < ptch2->offset)
+		return -1;
+	if (ptch1->offset > ptch2->offset)
+		return 1;
+	return 0;
+}
+
+static gboolean
+fu_firmware_write_stream_blob(FuFirmware *self, GOutputStream *stream, GError **error)
+{
+	g_autoptr(GBytes) blob = fu_firmware_write(self, error);
 	if (blob == NULL)
 		return FALSE;
-	return g_file_replace_contents(file,
-				       g_bytes_get_data(blob, NULL),
-				       g_bytes_get_size(blob),
-				       NULL,
-				       FALSE,
-				       G_FILE_CREATE_NONE,
-				       NULL,
-				       NULL,
-				       error);
+	return g_output_stream_write_all(stream,
+					 g_bytes_get_data(blob, NULL),
+					 g_bytes_get_size(blob),
+					 NULL,
+					 NULL,
+					 error);
+}
+
+/**
+ * fu_firmware_write_stream:
+ * @self: a #FuFirmware
+ * @stream: a #GOutputStream
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes a firmware to a stream, typically packing the images into a binary blob.
+ *
+ * If the firmware does not need packing then the payload is written directly, with any patches
+ * applied as the data is written rather than to a mutable copy of the entire image.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_firmware_write_stream(FuFirmware *self, GOutputStream *stream, GError **error)
+{
+	FuFirmwareClass *klass = FU_FIRMWARE_GET_CLASS(self);
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	const guint8 *buf;
+	gsize bufsz = 0;
+	gsize offset = 0;
+	g_autoptr(GPtrArray) patches = NULL;
+
+	g_return_val_if_fail(FU_IS_FIRMWARE(self), FALSE);
+	g_return_val_if_fail(G_IS_OUTPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* subclassed, or nothing to stream */
+	if (klass->write != NULL || priv->bytes == NULL)
+		return fu_firmware_write_stream_blob(self, stream, error);
+
+	/* usual case */
+	buf = g_bytes_get_data(priv->bytes, &bufsz);
+	if (priv->patches == NULL)
+		return g_output_stream_write_all(stream, buf, bufsz, NULL, NULL, error);
+
+	/* patches are applied in the order they were added, so if any overlap, or are invalid,
+	 * then apply them to a copy which also reports the error */
+	patches = g_ptr_array_sized_new(priv->patches->len);
+	for (guint i = 0; i < priv->patches->len; i++)
+		g_ptr_array_add(patches, g_ptr_array_index(priv->patches, i));
+	g_ptr_array_sort(patches, fu_firmware_patch_sort_cb);
+	for (guint i = 0; i < patches->len; i++) {
+		FuFirmwarePatch *ptch = g_ptr_array_index(patches, i);
+		gsize ptchsz = g_bytes_get_size(ptch->blob);
+		if (ptch->offset < offset || ptch->offset + ptchsz < ptchsz ||
+		    ptch->offset + ptchsz > bufsz)
+			return fu_firmware_write_stream_blob(self, stream, error);
+		offset = ptch->offset + ptchsz;
+	}
+
+	/* write the data before each patch, then the patch itself */
+	offset = 0;
+	for (guint i = 0; i < patches->len; i++) {
+		FuFirmwarePatch *ptch = g_ptr_array_index(patches, i);
+		if (!g_output_stream_write_all(stream,
+					       buf + offset,
+					       ptch->offset - offset,
+					       NULL,
+					       NULL,
+					       error))
+			return FALSE;
+		if (!g_output_stream_write_all(stream,
+					       g_bytes_get_data(ptch->blob, NULL),
+					       g_bytes_get_size(ptch->blob),
+					       NULL,
+					       NULL,
+					       error))
+			return FALSE;
+		offset = ptch->offset + g_bytes_get_size(ptch->blob);
+	}
+	return g_output_stream_write_all(stream, buf + offset, bufsz - offset, NULL, NULL, error);
 }
 
 /**
@@ -1909,6 +2103,8 @@ fu_firmware_finalize(GObject *object)
 		g_ptr_array_unref(priv->chunks);
 	if (priv->patches != NULL)
 		g_ptr_array_unref(priv->patches);
+	if (priv->search_magic != NULL)
+		g_bytes_unref(priv->search_magic);
 	if (priv->parent != NULL)
 		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
 	g_ptr_array_unref(priv->images);
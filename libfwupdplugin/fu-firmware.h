@@ -258,6 +258,8 @@ fu_firmware_get_alignment(FuFirmware *self);
 void
 fu_firmware_set_alignment(FuFirmware *self, guint8 alignment);
 void
+fu_firmware_set_search_magic(FuFirmware *self, const guint8 *buf, gsize bufsz, gsize offset);
+void
 fu_firmware_add_chunk(FuFirmware *self, FuChunk *chk);
 GPtrArray *
 fu_firmware_get_chunks(FuFirmware *self, GError **error);
@@ -294,6 +296,10 @@ fu_firmware_write_chunk(FuFirmware *self, guint64 address, guint64 chunk_sz_max,
     G_GNUC_WARN_UNUSED_RESULT;
 gboolean
 fu_firmware_write_file(FuFirmware *self, GFile *file, GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_firmware_write_stream(FuFirmware *self,
+			 GOutputStream *stream,
+			 GError **error) G_GNUC_WARN_UNUSED_RESULT;
 gchar *
 fu_firmware_get_checksum(FuFirmware *self, GChecksumType csum_kind, GError **error);
 gboolean
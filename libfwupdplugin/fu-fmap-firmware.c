@@ -221,6 +221,10 @@ fu_fmap_firmware_write(FuFirmware *firmware, GError **error)
 static void
 fu_fmap_firmware_init(FuFmapFirmware *self)
 {
+	fu_firmware_set_search_magic(FU_FIRMWARE(self),
+				     (const guint8 *)FMAP_SIGNATURE,
+				     strlen(FMAP_SIGNATURE),
+				     G_STRUCT_OFFSET(FuFmap, signature));
 }
 
 static void
@@ -273,6 +273,7 @@ typedef struct {
 	gsize bufsz;
 	guint timeout;
 	FuHidDeviceFlags flags;
+	guint attempts;
 } FuHidDeviceRetryHelper;
 
 static gboolean
@@ -349,6 +350,7 @@ fu_hid_device_set_report_internal_cb(FuDevice *device, gpointer user_data, GErro
 {
 	FuHidDevice *self = FU_HID_DEVICE(device);
 	FuHidDeviceRetryHelper *helper = (FuHidDeviceRetryHelper *)user_data;
+	helper->attempts++;
 	return fu_hid_device_set_report_internal(self, helper, error);
 }
 
@@ -377,8 +379,10 @@ fu_hid_device_set_report(FuHidDevice *self,
 			 FuHidDeviceFlags flags,
 			 GError **error)
 {
-	FuHidDeviceRetryHelper helper;
+	FuHidDeviceRetryHelper helper = {0};
 	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+	gboolean ret;
+	gint64 start = g_get_monotonic_time();
 
 	g_return_val_if_fail(FU_HID_DEVICE(self), FALSE);
 	g_return_val_if_fail(buf != NULL, FALSE);
@@ -394,15 +398,177 @@ fu_hid_device_set_report(FuHidDevice *self,
 
 	/* special case */
 	if (flags & FU_HID_DEVICE_FLAG_RETRY_FAILURE) {
-		return fu_device_retry(FU_DEVICE(self),
-				       fu_hid_device_set_report_internal_cb,
-				       FU_HID_DEVICE_RETRIES,
-				       &helper,
-				       error);
+		ret = fu_device_retry(FU_DEVICE(self),
+				      fu_hid_device_set_report_internal_cb,
+				      FU_HID_DEVICE_RETRIES,
+				      &helper,
+				      error);
+	} else {
+		/* just one */
+		helper.attempts = 1;
+		ret = fu_hid_device_set_report_internal(self, &helper, error);
+	}
+	fu_device_add_io_stat(FU_DEVICE(self),
+			      "set-report",
+			      ret ? bufsz : 0,
+			      helper.attempts > 0 ? helper.attempts - 1 : 0,
+			      g_get_monotonic_time() - start,
+			      ret);
+	return ret;
+}
+
+#ifdef HAVE_GUSB
+typedef struct {
+	guint8 value;
+	guint timeout;
+	FuHidDeviceFlags flags;
+} FuHidDeviceReportsHelper;
+
+static void
+fu_hid_device_set_reports_submit(FuUsbDevice *device,
+				 GByteArray *buf,
+				 GCancellable *cancellable,
+				 GAsyncReadyCallback callback,
+				 gpointer callback_data,
+				 gpointer user_data)
+{
+	FuHidDevice *self = FU_HID_DEVICE(device);
+	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+	FuHidDeviceReportsHelper *helper = (FuHidDeviceReportsHelper *)user_data;
+	GUsbDevice *usb_device = fu_usb_device_get_dev(device);
+	guint16 wvalue = (FU_HID_REPORT_TYPE_OUTPUT << 8) | helper->value;
+
+	if (priv->flags & FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER) {
+		g_usb_device_interrupt_transfer_async(usb_device,
+						      priv->ep_addr_out,
+						      buf->data,
+						      buf->len,
+						      helper->timeout,
+						      cancellable,
+						      callback,
+						      callback_data);
+		return;
+	}
+
+	/* special case */
+	if (helper->flags & FU_HID_DEVICE_FLAG_IS_FEATURE)
+		wvalue = (FU_HID_REPORT_TYPE_FEATURE << 8) | helper->value;
+	g_usb_device_control_transfer_async(usb_device,
+					    G_USB_DEVICE_DIRECTION_HOST_TO_DEVICE,
+					    G_USB_DEVICE_REQUEST_TYPE_CLASS,
+					    G_USB_DEVICE_RECIPIENT_INTERFACE,
+					    FU_HID_REPORT_SET,
+					    wvalue,
+					    priv->interface,
+					    buf->data,
+					    buf->len,
+					    helper->timeout,
+					    cancellable,
+					    callback,
+					    callback_data);
+}
+
+static gboolean
+fu_hid_device_set_reports_finish(FuUsbDevice *device,
+				 GAsyncResult *res,
+				 GByteArray *buf,
+				 gpointer user_data,
+				 GError **error)
+{
+	FuHidDevice *self = FU_HID_DEVICE(device);
+	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+	FuHidDeviceReportsHelper *helper = (FuHidDeviceReportsHelper *)user_data;
+	GUsbDevice *usb_device = fu_usb_device_get_dev(device);
+	gssize actual_len;
+
+	if (priv->flags & FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER) {
+		actual_len = g_usb_device_interrupt_transfer_finish(usb_device, res, error);
+	} else {
+		actual_len = g_usb_device_control_transfer_finish(usb_device, res, error);
+		if (actual_len < 0)
+			g_prefix_error(error, "failed to SetReport: ");
+	}
+	if (actual_len < 0)
+		return FALSE;
+	if ((helper->flags & FU_HID_DEVICE_FLAG_ALLOW_TRUNC) == 0 &&
+	    (gsize)actual_len != buf->len) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "wrote %" G_GSSIZE_FORMAT ", requested %u bytes",
+			    actual_len,
+			    buf->len);
+		return FALSE;
 	}
+	return TRUE;
+}
+#endif
 
-	/* just one */
-	return fu_hid_device_set_report_internal(self, &helper, error);
+/**
+ * fu_hid_device_set_reports:
+ * @self: a #FuHidDevice
+ * @value: low byte of wValue, but unused when using %FU_HID_DEVICE_FLAG_USE_INTERRUPT_TRANSFER
+ * @bufs: (element-type GByteArray): reports to send
+ * @queue_depth: maximum number of reports to have outstanding at once
+ * @timeout: timeout for each report in ms
+ * @flags: HID device flags e.g. %FU_HID_DEVICE_FLAG_ALLOW_TRUNC
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Calls SetReport on the hardware for each buffer in order, without waiting for each
+ * report to complete before submitting the next. This should only be used for devices
+ * that do not need to be polled for a status between each report.
+ *
+ * The %FU_HID_DEVICE_FLAG_RETRY_FAILURE flag is not supported.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_hid_device_set_reports(FuHidDevice *self,
+			  guint8 value,
+			  GPtrArray *bufs,
+			  guint queue_depth,
+			  guint timeout,
+			  FuHidDeviceFlags flags,
+			  FuProgress *progress,
+			  GError **error)
+{
+#ifdef HAVE_GUSB
+	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+	FuHidDeviceReportsHelper helper = {
+	    .value = value,
+	    .timeout = timeout,
+	    .flags = priv->flags | flags,
+	};
+
+	g_return_val_if_fail(FU_HID_DEVICE(self), FALSE);
+	g_return_val_if_fail(bufs != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (g_getenv("FU_HID_DEVICE_VERBOSE") != NULL) {
+		for (guint i = 0; i < bufs->len; i++) {
+			GByteArray *buf = g_ptr_array_index(bufs, i);
+			g_autofree gchar *title = g_strdup_printf("HID::SetReports [%u]", i);
+			fu_dump_raw(G_LOG_DOMAIN, title, buf->data, buf->len);
+		}
+	}
+	return fu_usb_device_transfers(FU_USB_DEVICE(self),
+				       bufs,
+				       queue_depth,
+				       fu_hid_device_set_reports_submit,
+				       fu_hid_device_set_reports_finish,
+				       &helper,
+				       progress,
+				       error);
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as <gusb.h> is unavailable");
+	return FALSE;
+#endif
 }
 
 static gboolean
@@ -486,6 +652,7 @@ fu_hid_device_get_report_internal_cb(FuDevice *device, gpointer user_data, GErro
 {
 	FuHidDevice *self = FU_HID_DEVICE(device);
 	FuHidDeviceRetryHelper *helper = (FuHidDeviceRetryHelper *)user_data;
+	helper->attempts++;
 	return fu_hid_device_get_report_internal(self, helper, error);
 }
 
@@ -514,8 +681,10 @@ fu_hid_device_get_report(FuHidDevice *self,
 			 FuHidDeviceFlags flags,
 			 GError **error)
 {
-	FuHidDeviceRetryHelper helper;
+	FuHidDeviceRetryHelper helper = {0};
 	FuHidDevicePrivate *priv = GET_PRIVATE(self);
+	gboolean ret;
+	gint64 start = g_get_monotonic_time();
 
 	g_return_val_if_fail(FU_HID_DEVICE(self), FALSE);
 	g_return_val_if_fail(buf != NULL, FALSE);
@@ -531,15 +700,23 @@ fu_hid_device_get_report(FuHidDevice *self,
 
 	/* special case */
 	if (flags & FU_HID_DEVICE_FLAG_RETRY_FAILURE) {
-		return fu_device_retry(FU_DEVICE(self),
-				       fu_hid_device_get_report_internal_cb,
-				       FU_HID_DEVICE_RETRIES,
-				       &helper,
-				       error);
+		ret = fu_device_retry(FU_DEVICE(self),
+				      fu_hid_device_get_report_internal_cb,
+				      FU_HID_DEVICE_RETRIES,
+				      &helper,
+				      error);
+	} else {
+		/* just one */
+		helper.attempts = 1;
+		ret = fu_hid_device_get_report_internal(self, &helper, error);
 	}
-
-	/* just one */
-	return fu_hid_device_get_report_internal(self, &helper, error);
+	fu_device_add_io_stat(FU_DEVICE(self),
+			      "get-report",
+			      ret ? bufsz : 0,
+			      helper.attempts > 0 ? helper.attempts - 1 : 0,
+			      g_get_monotonic_time() - start,
+			      ret);
+	return ret;
 }
 
 static void
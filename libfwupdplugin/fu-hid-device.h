@@ -57,6 +57,15 @@ fu_hid_device_set_report(FuHidDevice *self,
 			 FuHidDeviceFlags flags,
 			 GError **error) G_GNUC_WARN_UNUSED_RESULT;
 gboolean
+fu_hid_device_set_reports(FuHidDevice *self,
+			  guint8 value,
+			  GPtrArray *bufs,
+			  guint queue_depth,
+			  guint timeout,
+			  FuHidDeviceFlags flags,
+			  FuProgress *progress,
+			  GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
 fu_hid_device_get_report(FuHidDevice *self,
 			 guint8 value,
 			 guint8 *buf,
@@ -464,6 +464,7 @@ static void
 fu_ifd_firmware_init(FuIfdFirmware *self)
 {
 	FuIfdFirmwarePrivate *priv = GET_PRIVATE(self);
+	guint8 magic[4] = {0x0};
 
 	/* some good defaults */
 	priv->new_layout = TRUE;
@@ -476,6 +477,13 @@ fu_ifd_firmware_init(FuIfdFirmware *self)
 	priv->flash_master[3] = 0x00800900;
 	priv->flash_ich_strap_base_addr = 0x100;
 	priv->flash_mch_strap_base_addr = 0x300;
+
+	/* only search where the signature is found */
+	fu_memwrite_uint32(magic, FU_IFD_SIGNATURE, G_LITTLE_ENDIAN);
+	fu_firmware_set_search_magic(FU_FIRMWARE(self),
+				     magic,
+				     sizeof(magic),
+				     FU_IFD_FDBAR_SIGNATURE);
 }
 
 static void
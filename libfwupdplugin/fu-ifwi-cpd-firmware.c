@@ -455,6 +455,12 @@ fu_ifwi_cpd_firmware_build(FuFirmware *firmware, XbNode *n, GError **error)
 static void
 fu_ifwi_cpd_firmware_init(FuIfwiCpdFirmware *self)
 {
+	guint8 magic[4] = {0x0};
+	fu_memwrite_uint32(magic, FU_IFWI_CPD_FIRMWARE_HEADER_MARKER, G_LITTLE_ENDIAN);
+	fu_firmware_set_search_magic(FU_FIRMWARE(self),
+				     magic,
+				     sizeof(magic),
+				     G_STRUCT_OFFSET(FuIfwiCpdHeader, header_marker));
 }
 
 static void
@@ -286,6 +286,12 @@ fu_ifwi_fpt_firmware_write(FuFirmware *firmware, GError **error)
 static void
 fu_ifwi_fpt_firmware_init(FuIfwiFptFirmware *self)
 {
+	guint8 magic[4] = {0x0};
+	fu_memwrite_uint32(magic, FU_IFWI_FPT_HEADER_MARKER, G_LITTLE_ENDIAN);
+	fu_firmware_set_search_magic(FU_FIRMWARE(self),
+				     magic,
+				     sizeof(magic),
+				     G_STRUCT_OFFSET(FuIfwiFptHeader, header_marker));
 }
 
 static void
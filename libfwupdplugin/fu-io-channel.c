@@ -32,6 +32,7 @@
 struct _FuIOChannel {
 	GObject parent_instance;
 	gint fd;
+	FuDevice *device; /* noref */
 };
 
 G_DEFINE_TYPE(FuIOChannel, fu_io_channel, G_TYPE_OBJECT)
@@ -53,6 +54,28 @@ fu_io_channel_unix_get_fd(FuIOChannel *self)
 	return self->fd;
 }
 
+/**
+ * fu_io_channel_set_device:
+ * @self: a #FuIOChannel
+ * @device: (nullable): a #FuDevice
+ *
+ * Sets the device that reads and writes are recorded against, see
+ * fu_device_add_io_stat().
+ *
+ * Since: 1.8.5
+ **/
+void
+fu_io_channel_set_device(FuIOChannel *self, FuDevice *device)
+{
+	g_return_if_fail(FU_IS_IO_CHANNEL(self));
+	g_return_if_fail(device == NULL || FU_IS_DEVICE(device));
+	if (self->device != NULL)
+		g_object_remove_weak_pointer(G_OBJECT(self->device), (gpointer *)&self->device);
+	self->device = device;
+	if (self->device != NULL)
+		g_object_add_weak_pointer(G_OBJECT(self->device), (gpointer *)&self->device);
+}
+
 /**
  * fu_io_channel_shutdown:
  * @self: a #FuIOChannel
@@ -141,34 +164,16 @@ fu_io_channel_write_byte_array(FuIOChannel *self,
 	return fu_io_channel_write_raw(self, buf->data, buf->len, timeout_ms, flags, error);
 }
 
-/**
- * fu_io_channel_write_raw:
- * @self: a #FuIOChannel
- * @data: buffer to write
- * @datasz: size of @data
- * @timeout_ms: timeout in ms
- * @flags: channel flags, e.g. %FU_IO_CHANNEL_FLAG_SINGLE_SHOT
- * @error: (nullable): optional return location for an error
- *
- * Writes bytes to the TTY, that will fail if exceeding @timeout_ms.
- *
- * Returns: %TRUE if all the bytes was written
- *
- * Since: 1.2.2
- **/
-gboolean
-fu_io_channel_write_raw(FuIOChannel *self,
-			const guint8 *data,
-			gsize datasz,
-			guint timeout_ms,
-			FuIOChannelFlags flags,
-			GError **error)
+static gboolean
+fu_io_channel_write_raw_internal(FuIOChannel *self,
+				 const guint8 *data,
+				 gsize datasz,
+				 guint timeout_ms,
+				 FuIOChannelFlags flags,
+				 GError **error)
 {
 	gsize idx = 0;
 
-	g_return_val_if_fail(FU_IS_IO_CHANNEL(self), FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
-
 	/* flush pending reads */
 	if (flags & FU_IO_CHANNEL_FLAG_FLUSH_INPUT) {
 		if (!fu_io_channel_flush_input(self, error))
@@ -254,6 +259,47 @@ fu_io_channel_write_raw(FuIOChannel *self,
 	return TRUE;
 }
 
+/**
+ * fu_io_channel_write_raw:
+ * @self: a #FuIOChannel
+ * @data: buffer to write
+ * @datasz: size of @data
+ * @timeout_ms: timeout in ms
+ * @flags: channel flags, e.g. %FU_IO_CHANNEL_FLAG_SINGLE_SHOT
+ * @error: (nullable): optional return location for an error
+ *
+ * Writes bytes to the TTY, that will fail if exceeding @timeout_ms.
+ *
+ * Returns: %TRUE if all the bytes was written
+ *
+ * Since: 1.2.2
+ **/
+gboolean
+fu_io_channel_write_raw(FuIOChannel *self,
+			const guint8 *data,
+			gsize datasz,
+			guint timeout_ms,
+			FuIOChannelFlags flags,
+			GError **error)
+{
+	gboolean ret;
+	gint64 start = g_get_monotonic_time();
+
+	g_return_val_if_fail(FU_IS_IO_CHANNEL(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	ret = fu_io_channel_write_raw_internal(self, data, datasz, timeout_ms, flags, error);
+	if (self->device != NULL) {
+		fu_device_add_io_stat(self->device,
+				      "write",
+				      ret ? datasz : 0,
+				      0,
+				      g_get_monotonic_time() - start,
+				      ret);
+	}
+	return ret;
+}
+
 /**
  * fu_io_channel_read_bytes:
  * @self: a #FuIOChannel
@@ -281,26 +327,12 @@ fu_io_channel_read_bytes(FuIOChannel *self,
 	return g_byte_array_free_to_bytes(buf);
 }
 
-/**
- * fu_io_channel_read_byte_array:
- * @self: a #FuIOChannel
- * @max_size: maximum size of the returned blob, or -1 for no limit
- * @timeout_ms: timeout in ms
- * @flags: channel flags, e.g. %FU_IO_CHANNEL_FLAG_SINGLE_SHOT
- * @error: (nullable): optional return location for an error
- *
- * Reads bytes from the TTY, that will fail if exceeding @timeout_ms.
- *
- * Returns: (transfer full): a #GByteArray, or %NULL for error
- *
- * Since: 1.3.2
- **/
-GByteArray *
-fu_io_channel_read_byte_array(FuIOChannel *self,
-			      gssize max_size,
-			      guint timeout_ms,
-			      FuIOChannelFlags flags,
-			      GError **error)
+static GByteArray *
+fu_io_channel_read_byte_array_internal(FuIOChannel *self,
+				       gssize max_size,
+				       guint timeout_ms,
+				       FuIOChannelFlags flags,
+				       GError **error)
 {
 	GPollFD fds = {
 	    .fd = self->fd,
@@ -308,8 +340,6 @@ fu_io_channel_read_byte_array(FuIOChannel *self,
 	};
 	g_autoptr(GByteArray) buf2 = g_byte_array_new();
 
-	g_return_val_if_fail(FU_IS_IO_CHANNEL(self), NULL);
-
 	/* blocking IO */
 	if (flags & FU_IO_CHANNEL_FLAG_USE_BLOCKING_IO) {
 		guint8 buf[1024];
@@ -411,6 +441,44 @@ fu_io_channel_read_byte_array(FuIOChannel *self,
 	return g_steal_pointer(&buf2);
 }
 
+/**
+ * fu_io_channel_read_byte_array:
+ * @self: a #FuIOChannel
+ * @max_size: maximum size of the returned blob, or -1 for no limit
+ * @timeout_ms: timeout in ms
+ * @flags: channel flags, e.g. %FU_IO_CHANNEL_FLAG_SINGLE_SHOT
+ * @error: (nullable): optional return location for an error
+ *
+ * Reads bytes from the TTY, that will fail if exceeding @timeout_ms.
+ *
+ * Returns: (transfer full): a #GByteArray, or %NULL for error
+ *
+ * Since: 1.3.2
+ **/
+GByteArray *
+fu_io_channel_read_byte_array(FuIOChannel *self,
+			      gssize max_size,
+			      guint timeout_ms,
+			      FuIOChannelFlags flags,
+			      GError **error)
+{
+	GByteArray *buf;
+	gint64 start = g_get_monotonic_time();
+
+	g_return_val_if_fail(FU_IS_IO_CHANNEL(self), NULL);
+
+	buf = fu_io_channel_read_byte_array_internal(self, max_size, timeout_ms, flags, error);
+	if (self->device != NULL) {
+		fu_device_add_io_stat(self->device,
+				      "read",
+				      buf != NULL ? buf->len : 0,
+				      0,
+				      g_get_monotonic_time() - start,
+				      buf != NULL);
+	}
+	return buf;
+}
+
 /**
  * fu_io_channel_read_raw:
  * @self: a #FuIOChannel
@@ -459,6 +527,8 @@ fu_io_channel_finalize(GObject *object)
 	FuIOChannel *self = FU_IO_CHANNEL(object);
 	if (self->fd != -1)
 		g_close(self->fd, NULL);
+	if (self->device != NULL)
+		g_object_remove_weak_pointer(G_OBJECT(self->device), (gpointer *)&self->device);
 	G_OBJECT_CLASS(fu_io_channel_parent_class)->finalize(object);
 }
 
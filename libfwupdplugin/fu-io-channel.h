@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include <glib-object.h>
+#include "fu-device.h"
 
 #define FU_TYPE_IO_CHANNEL (fu_io_channel_get_type())
 
@@ -37,6 +37,8 @@ fu_io_channel_new_file(const gchar *filename, GError **error) G_GNUC_WARN_UNUSED
 
 gint
 fu_io_channel_unix_get_fd(FuIOChannel *self);
+void
+fu_io_channel_set_device(FuIOChannel *self, FuDevice *device);
 gboolean
 fu_io_channel_shutdown(FuIOChannel *self, GError **error) G_GNUC_WARN_UNUSED_RESULT;
 gboolean
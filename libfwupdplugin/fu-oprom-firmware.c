@@ -403,7 +403,13 @@ fu_oprom_firmware_build(FuFirmware *firmware, XbNode *n, GError **error)
 static void
 fu_oprom_firmware_init(FuOpromFirmware *self)
 {
+	guint8 magic[2] = {0x0};
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_STORED_SIZE);
+	fu_memwrite_uint16(magic, FU_OPROM_HEADER_SIGNATURE, G_LITTLE_ENDIAN);
+	fu_firmware_set_search_magic(FU_FIRMWARE(self),
+				     magic,
+				     sizeof(magic),
+				     G_STRUCT_OFFSET(FuOpromFirmwareHeader2, signature));
 }
 
 static void
@@ -22,6 +22,8 @@ guint
 fu_plugin_get_priority(FuPlugin *self);
 void
 fu_plugin_set_priority(FuPlugin *self, guint priority);
+gboolean
+fu_plugin_get_thread_safe(FuPlugin *self);
 void
 fu_plugin_set_name(FuPlugin *self, const gchar *name);
 gchar *
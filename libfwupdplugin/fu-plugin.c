@@ -24,6 +24,7 @@
 #include "fu-plugin-private.h"
 #include "fu-security-attr.h"
 #include "fu-string.h"
+#include "fu-trace-private.h"
 
 /**
  * FuPlugin:
@@ -41,6 +42,7 @@ typedef struct {
 	guint order;
 	guint priority;
 	gboolean done_init;
+	gboolean thread_safe;
 	GPtrArray *rules[FU_PLUGIN_RULE_LAST];
 	GPtrArray *devices; /* (nullable) (element-type FuDevice) */
 	GHashTable *runtime_versions;
@@ -70,6 +72,15 @@ static guint signals[SIGNAL_LAST] = {0};
 G_DEFINE_TYPE_WITH_PRIVATE(FuPlugin, fu_plugin, FWUPD_TYPE_PLUGIN)
 #define GET_PRIVATE(o) (fu_plugin_get_instance_private(o))
 
+/* static tracepoints around each plugin vfunc, see fu-trace-private.h */
+#define FU_PLUGIN_TRACE_BEGIN(self, method, device)                                                \
+	FU_TRACE3(plugin_runner_begin,                                                             \
+		  fu_plugin_get_name(self),                                                        \
+		  method,                                                                          \
+		  (device) != NULL ? fu_device_get_id(device) : NULL)
+#define FU_PLUGIN_TRACE_END(self, method, ret)                                                     \
+	FU_TRACE3(plugin_runner_end, fu_plugin_get_name(self), method, ret)
+
 typedef void (*FuPluginInitVfuncsFunc)(FuPluginVfuncs *vfuncs);
 typedef gboolean (*FuPluginDeviceFunc)(FuPlugin *self, FuDevice *device, GError **error);
 typedef gboolean (*FuPluginDeviceProgressFunc)(FuPlugin *self,
@@ -413,6 +424,8 @@ fu_plugin_add_string(FuPlugin *self, guint idt, GString *str)
 		fu_string_append_ku(str, idt + 1, "Order", priv->order);
 	if (priv->priority != 0)
 		fu_string_append_ku(str, idt + 1, "Priority", priv->priority);
+	if (priv->thread_safe)
+		fu_string_append_kb(str, idt + 1, "ThreadSafe", priv->thread_safe);
 
 	/* optional */
 	if (vfuncs->to_string != NULL)
@@ -866,6 +879,7 @@ fu_plugin_runner_startup(FuPlugin *self, FuProgress *progress, GError **error)
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	g_autofree gchar *config_filename = fu_plugin_get_config_filename(self);
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 	g_autoptr(GFile) file = g_file_new_for_path(config_filename);
 
@@ -885,7 +899,10 @@ fu_plugin_runner_startup(FuPlugin *self, FuProgress *progress, GError **error)
 	if (vfuncs->startup == NULL)
 		return TRUE;
 	g_debug("startup(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->startup(self, progress, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, "startup", NULL);
+	ret = vfuncs->startup(self, progress, &error_local);
+	FU_PLUGIN_TRACE_END(self, "startup", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in startup(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -952,6 +969,7 @@ fu_plugin_runner_device_generic(FuPlugin *self,
 				FuPluginDeviceFunc device_func,
 				GError **error)
 {
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -962,7 +980,10 @@ fu_plugin_runner_device_generic(FuPlugin *self,
 	if (device_func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!device_func(self, device, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, symbol_name + 10, device);
+	ret = device_func(self, device, &error_local);
+	FU_PLUGIN_TRACE_END(self, symbol_name + 10, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -990,6 +1011,7 @@ fu_plugin_runner_device_generic_progress(FuPlugin *self,
 					 FuPluginDeviceProgressFunc device_func,
 					 GError **error)
 {
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -1000,7 +1022,10 @@ fu_plugin_runner_device_generic_progress(FuPlugin *self,
 	if (device_func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!device_func(self, device, progress, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, symbol_name + 10, device);
+	ret = device_func(self, device, progress, &error_local);
+	FU_PLUGIN_TRACE_END(self, symbol_name + 10, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -1029,6 +1054,7 @@ fu_plugin_runner_flagged_device_generic(FuPlugin *self,
 					FuPluginFlaggedDeviceFunc func,
 					GError **error)
 {
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -1039,7 +1065,10 @@ fu_plugin_runner_flagged_device_generic(FuPlugin *self,
 	if (func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!func(self, device, progress, flags, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, symbol_name + 10, device);
+	ret = func(self, device, progress, flags, &error_local);
+	FU_PLUGIN_TRACE_END(self, symbol_name + 10, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in %s(%s)",
 				   fu_plugin_get_name(self),
@@ -1066,6 +1095,7 @@ fu_plugin_runner_device_array_generic(FuPlugin *self,
 				      FuPluginDeviceArrayFunc func,
 				      GError **error)
 {
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	/* not enabled */
@@ -1076,7 +1106,10 @@ fu_plugin_runner_device_array_generic(FuPlugin *self,
 	if (func == NULL)
 		return TRUE;
 	g_debug("%s(%s)", symbol_name + 10, fu_plugin_get_name(self));
-	if (!func(self, devices, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, symbol_name + 10, NULL);
+	ret = func(self, devices, &error_local);
+	FU_PLUGIN_TRACE_END(self, symbol_name + 10, ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in for %s(%s)",
 				   fu_plugin_get_name(self),
@@ -1113,6 +1146,7 @@ fu_plugin_runner_coldplug(FuPlugin *self, FuProgress *progress, GError **error)
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1132,7 +1166,10 @@ fu_plugin_runner_coldplug(FuPlugin *self, FuProgress *progress, GError **error)
 	if (vfuncs->coldplug == NULL)
 		return TRUE;
 	g_debug("coldplug(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->coldplug(self, progress, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, "coldplug", NULL);
+	ret = vfuncs->coldplug(self, progress, &error_local);
+	FU_PLUGIN_TRACE_END(self, "coldplug", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in coldplug(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -1583,6 +1620,7 @@ fu_plugin_runner_backend_device_added(FuPlugin *self, FuDevice *device, GError *
 {
 	FuPluginPrivate *priv = GET_PRIVATE(self);
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1606,7 +1644,10 @@ fu_plugin_runner_backend_device_added(FuPlugin *self, FuDevice *device, GError *
 		return FALSE;
 	}
 	g_debug("backend_device_added(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->backend_device_added(self, device, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, "backend_device_added", device);
+	ret = vfuncs->backend_device_added(self, device, &error_local);
+	FU_PLUGIN_TRACE_END(self, "backend_device_added", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in backend_device_added(%s)",
 				   fu_plugin_get_name(self));
@@ -1640,6 +1681,7 @@ gboolean
 fu_plugin_runner_backend_device_changed(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1654,7 +1696,10 @@ fu_plugin_runner_backend_device_changed(FuPlugin *self, FuDevice *device, GError
 	if (vfuncs->backend_device_changed == NULL)
 		return TRUE;
 	g_debug("udev_device_changed(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->backend_device_changed(self, device, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, "backend_device_changed", device);
+	ret = vfuncs->backend_device_changed(self, device, &error_local);
+	FU_PLUGIN_TRACE_END(self, "backend_device_changed", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in udev_device_changed(%s)",
 				   fu_plugin_get_name(self));
@@ -1694,7 +1739,9 @@ fu_plugin_runner_device_added(FuPlugin *self, FuDevice *device)
 	if (vfuncs->device_added == NULL)
 		return;
 	g_debug("fu_plugin_device_added(%s)", fu_plugin_get_name(self));
+	FU_PLUGIN_TRACE_BEGIN(self, "device_added", device);
 	vfuncs->device_added(self, device);
+	FU_PLUGIN_TRACE_END(self, "device_added", TRUE);
 }
 
 /**
@@ -1741,7 +1788,9 @@ fu_plugin_runner_device_register(FuPlugin *self, FuDevice *device)
 	/* optional */
 	if (vfuncs->device_registered != NULL) {
 		g_debug("fu_plugin_device_registered(%s)", fu_plugin_get_name(self));
+		FU_PLUGIN_TRACE_BEGIN(self, "device_registered", device);
 		vfuncs->device_registered(self, device);
+		FU_PLUGIN_TRACE_END(self, "device_registered", TRUE);
 	}
 }
 
@@ -1761,6 +1810,7 @@ gboolean
 fu_plugin_runner_device_created(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -1774,7 +1824,10 @@ fu_plugin_runner_device_created(FuPlugin *self, FuDevice *device, GError **error
 	if (vfuncs->device_created == NULL)
 		return TRUE;
 	g_debug("fu_plugin_device_created(%s)", fu_plugin_get_name(self));
-	return vfuncs->device_created(self, device, error);
+	FU_PLUGIN_TRACE_BEGIN(self, "device_created", device);
+	ret = vfuncs->device_created(self, device, error);
+	FU_PLUGIN_TRACE_END(self, "device_created", ret);
+	return ret;
 }
 
 /**
@@ -1800,6 +1853,7 @@ fu_plugin_runner_verify(FuPlugin *self,
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
 	GPtrArray *checksums;
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -1840,7 +1894,10 @@ fu_plugin_runner_verify(FuPlugin *self,
 
 	/* run vfunc */
 	g_debug("verify(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->verify(self, device, progress, flags, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, "verify", device);
+	ret = vfuncs->verify(self, device, progress, flags, &error_local);
+	FU_PLUGIN_TRACE_END(self, "verify", ret);
+	if (!ret) {
 		g_autoptr(GError) error_attach = NULL;
 		if (error_local == NULL) {
 			g_critical("unset plugin error in verify(%s)", fu_plugin_get_name(self));
@@ -2003,6 +2060,7 @@ fu_plugin_runner_write_firmware(FuPlugin *self,
 				GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -2028,7 +2086,10 @@ fu_plugin_runner_write_firmware(FuPlugin *self,
 	}
 
 	/* online */
-	if (!vfuncs->write_firmware(self, device, blob_fw, progress, flags, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, "write_firmware", device);
+	ret = vfuncs->write_firmware(self, device, blob_fw, progress, flags, &error_local);
+	FU_PLUGIN_TRACE_END(self, "write_firmware", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in update(%s)", fu_plugin_get_name(self));
 			g_set_error_literal(&error_local,
@@ -2069,6 +2130,7 @@ gboolean
 fu_plugin_runner_clear_results(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -2083,7 +2145,10 @@ fu_plugin_runner_clear_results(FuPlugin *self, FuDevice *device, GError **error)
 	if (vfuncs->clear_results == NULL)
 		return TRUE;
 	g_debug("clear_result(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->clear_results(self, device, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, "clear_results", device);
+	ret = vfuncs->clear_results(self, device, &error_local);
+	FU_PLUGIN_TRACE_END(self, "clear_results", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in clear_result(%s)",
 				   fu_plugin_get_name(self));
@@ -2117,6 +2182,7 @@ gboolean
 fu_plugin_runner_get_results(FuPlugin *self, FuDevice *device, GError **error)
 {
 	FuPluginVfuncs *vfuncs = fu_plugin_get_vfuncs(self);
+	gboolean ret;
 	g_autoptr(GError) error_local = NULL;
 
 	g_return_val_if_fail(FU_IS_PLUGIN(self), FALSE);
@@ -2133,7 +2199,10 @@ fu_plugin_runner_get_results(FuPlugin *self, FuDevice *device, GError **error)
 		return fu_plugin_device_get_results(self, device, error);
 	}
 	g_debug("get_results(%s)", fu_plugin_get_name(self));
-	if (!vfuncs->get_results(self, device, &error_local)) {
+	FU_PLUGIN_TRACE_BEGIN(self, "get_results", device);
+	ret = vfuncs->get_results(self, device, &error_local);
+	FU_PLUGIN_TRACE_END(self, "get_results", ret);
+	if (!ret) {
 		if (error_local == NULL) {
 			g_critical("unset plugin error in get_results(%s)",
 				   fu_plugin_get_name(self));
@@ -2219,6 +2288,47 @@ fu_plugin_set_priority(FuPlugin *self, guint priority)
 	priv->priority = priority;
 }
 
+/**
+ * fu_plugin_get_thread_safe:
+ * @self: a #FuPlugin
+ *
+ * Gets if the plugin startup and coldplug vfuncs can be run from a worker thread.
+ *
+ * Returns: %TRUE if the plugin is thread safe
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_plugin_get_thread_safe(FuPlugin *self)
+{
+	FuPluginPrivate *priv = fu_plugin_get_instance_private(self);
+	return priv->thread_safe;
+}
+
+/**
+ * fu_plugin_set_thread_safe:
+ * @self: a #FuPlugin
+ * @thread_safe: boolean
+ *
+ * Sets if the plugin startup and coldplug vfuncs can be run from a worker thread
+ * at the same time as other plugins with the same order.
+ *
+ * Plugins should only set this if the vfuncs do not use any global state other than
+ * the #FuPluginData, and if they do not rely on the devices being added to the
+ * daemon before the vfunc returns.
+ *
+ * Libraries that are not thread safe, for instance GUdev, must not be used.
+ *
+ * Since: 1.8.5
+ **/
+void
+fu_plugin_set_thread_safe(FuPlugin *self, gboolean thread_safe)
+{
+	FuPluginPrivate *priv = fu_plugin_get_instance_private(self);
+	g_return_if_fail(FU_IS_PLUGIN(self));
+	priv->thread_safe = thread_safe;
+}
+
 /**
  * fu_plugin_add_rule:
  * @self: a #FuPlugin
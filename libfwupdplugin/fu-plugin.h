@@ -457,6 +457,8 @@ fu_plugin_get_devices(FuPlugin *self);
 void
 fu_plugin_add_rule(FuPlugin *self, FuPluginRule rule, const gchar *name);
 void
+fu_plugin_set_thread_safe(FuPlugin *self, gboolean thread_safe);
+void
 fu_plugin_add_report_metadata(FuPlugin *self, const gchar *key, const gchar *value);
 gchar *
 fu_plugin_get_config_value(FuPlugin *self, const gchar *key);
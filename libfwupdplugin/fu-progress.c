@@ -71,6 +71,11 @@ typedef struct {
 	GTimer *timer_child;
 	guint step_now;
 	FuProgress *parent; /* no-ref */
+	guint emit_interval;   /* ms */
+	gint64 emit_last;      /* monotonic, us */
+	gboolean emit_pending; /* percentage was saved but not emitted */
+	GSource *emit_source;  /* delivers the pending percentage if nothing else does */
+	guint64 emit_suppressed;
 } FuProgressPrivate;
 
 enum { SIGNAL_PERCENTAGE_CHANGED, SIGNAL_STATUS_CHANGED, SIGNAL_LAST };
@@ -288,6 +293,76 @@ fu_progress_has_flag(FuProgress *self, FuProgressFlags flag)
 	return (priv->flags & flag) > 0;
 }
 
+static void
+fu_progress_emit_source_clear(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	if (priv->emit_source == NULL)
+		return;
+	g_source_destroy(priv->emit_source);
+	g_source_unref(priv->emit_source);
+	priv->emit_source = NULL;
+}
+
+static void
+fu_progress_emit_percentage(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	fu_progress_emit_source_clear(self);
+	priv->emit_pending = FALSE;
+	if (priv->emit_interval > 0)
+		priv->emit_last = g_get_monotonic_time();
+	g_signal_emit(self, signals[SIGNAL_PERCENTAGE_CHANGED], 0, priv->percentage);
+}
+
+static gboolean
+fu_progress_emit_pending_cb(gpointer user_data)
+{
+	FuProgress *self = FU_PROGRESS(user_data);
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	if (priv->emit_pending)
+		fu_progress_emit_percentage(self);
+	else
+		fu_progress_emit_source_clear(self);
+	return G_SOURCE_REMOVE;
+}
+
+/* if no other value is set before the interval expires, deliver the pending one anyway */
+static void
+fu_progress_emit_source_ensure(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	gint64 elapsed;
+	guint delay = 1;
+
+	if (priv->emit_source != NULL)
+		return;
+	elapsed = (g_get_monotonic_time() - priv->emit_last) / 1000;
+	if (elapsed < priv->emit_interval)
+		delay = MAX(priv->emit_interval - (guint)elapsed, 1);
+	priv->emit_source = g_timeout_source_new(delay);
+	g_source_set_callback(priv->emit_source, fu_progress_emit_pending_cb, self, NULL);
+	g_source_attach(priv->emit_source, g_main_context_get_thread_default());
+}
+
+/* a value coalesced by a child is stale once the parent has moved on */
+static void
+fu_progress_emit_pending_discard(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	priv->emit_pending = FALSE;
+	fu_progress_emit_source_clear(self);
+	for (guint i = 0; i < priv->children->len; i++)
+		fu_progress_emit_pending_discard(g_ptr_array_index(priv->children, i));
+}
+
+static void
+fu_progress_add_suppressed(FuProgress *self)
+{
+	for (FuProgress *tmp = self; tmp != NULL; tmp = GET_PRIVATE(tmp)->parent)
+		GET_PRIVATE(tmp)->emit_suppressed++;
+}
+
 /**
  * fu_progress_set_status:
  * @self: a #FuProgress
@@ -307,6 +382,10 @@ fu_progress_set_status(FuProgress *self, FwupdStatus status)
 	if (priv->status == status)
 		return;
 
+	/* deliver any coalesced percentage first so it matches the old status */
+	if (priv->emit_pending)
+		fu_progress_emit_percentage(self);
+
 	/* save */
 	priv->status = status;
 	g_signal_emit(self, signals[SIGNAL_STATUS_CHANGED], 0, status);
@@ -340,6 +419,7 @@ fu_progress_set_parent(FuProgress *self, FuProgress *parent)
 	g_return_if_fail(FU_IS_PROGRESS(parent));
 	priv->parent = parent; /* no ref! */
 	priv->profile = fu_progress_get_profile(parent);
+	priv->emit_interval = GET_PRIVATE(parent)->emit_interval;
 }
 
 static guint
@@ -435,7 +515,58 @@ fu_progress_set_percentage(FuProgress *self, guint percentage)
 
 	/* save */
 	priv->percentage = percentage;
-	g_signal_emit(self, signals[SIGNAL_PERCENTAGE_CHANGED], 0, percentage);
+
+	/* coalesce with the next change if the last emission was too recent */
+	if (priv->emit_interval > 0 && percentage != 100 && priv->emit_last != 0 &&
+	    g_get_monotonic_time() - priv->emit_last < (gint64)priv->emit_interval * 1000) {
+		priv->emit_pending = TRUE;
+		fu_progress_add_suppressed(self);
+		fu_progress_emit_source_ensure(self);
+		return;
+	}
+	fu_progress_emit_percentage(self);
+}
+
+/**
+ * fu_progress_set_emit_interval:
+ * @self: a #FuProgress
+ * @emit_interval: minimum time between signal emissions in ms, or 0 for no limit
+ *
+ * Limits how often ::percentage-changed is emitted, which also limits how often the
+ * percentage is propagated to the parent. Any values set in between are coalesced
+ * into the next emission. The final 100% is always emitted, and any pending value is
+ * emitted before the status changes, or from the thread-default main context once the
+ * interval has expired if nothing else is set.
+ *
+ * Children created after this call inherit the same interval.
+ *
+ * Since: 1.8.5
+ **/
+void
+fu_progress_set_emit_interval(FuProgress *self, guint emit_interval)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FU_IS_PROGRESS(self));
+	priv->emit_interval = emit_interval;
+}
+
+/**
+ * fu_progress_get_emit_suppressed:
+ * @self: a #FuProgress
+ *
+ * Gets how many ::percentage-changed emissions were coalesced by this progress
+ * and all of its children, which is useful when profiling.
+ *
+ * Returns: integer
+ *
+ * Since: 1.8.5
+ **/
+guint64
+fu_progress_get_emit_suppressed(FuProgress *self)
+{
+	FuProgressPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_PROGRESS(self), 0);
+	return priv->emit_suppressed;
 }
 
 /**
@@ -512,6 +643,8 @@ fu_progress_reset(FuProgress *self)
 	/* reset values */
 	priv->step_now = 0;
 	priv->percentage = G_MAXUINT;
+	priv->emit_last = 0;
+	fu_progress_emit_pending_discard(self);
 
 	/* only use the timer if profiling; it's expensive */
 	if (priv->profile) {
@@ -751,6 +884,7 @@ fu_progress_finished(FuProgress *self)
 	for (guint i = 0; i < priv->children->len; i++) {
 		FuProgress *child = g_ptr_array_index(priv->children, i);
 		fu_progress_add_flag(child, FU_PROGRESS_FLAG_NO_TRACEBACK);
+		fu_progress_emit_pending_discard(child);
 	}
 }
 
@@ -903,6 +1037,10 @@ fu_progress_step_done(FuProgress *self)
 		}
 	}
 
+	/* the parent percentage for this step is set below */
+	if (child != NULL)
+		fu_progress_emit_pending_discard(child);
+
 	/* another */
 	priv->step_now++;
 
@@ -119,6 +119,10 @@ fu_progress_set_profile(FuProgress *self, gboolean profile);
 gboolean
 fu_progress_get_profile(FuProgress *self);
 void
+fu_progress_set_emit_interval(FuProgress *self, guint emit_interval);
+guint64
+fu_progress_get_emit_suppressed(FuProgress *self);
+void
 fu_progress_reset(FuProgress *self);
 void
 fu_progress_set_steps(FuProgress *self, guint step_max);
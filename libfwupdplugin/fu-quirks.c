@@ -21,6 +21,7 @@
 #include "fu-path.h"
 #include "fu-quirks.h"
 #include "fu-string.h"
+#include "fu-trace-private.h"
 
 #ifdef _WIN32
 #include <fwupd-windows.h>
@@ -62,6 +63,9 @@ struct _FuQuirks {
 	XbSilo *silo;
 	XbQuery *query_kv;
 	XbQuery *query_vs;
+	GPtrArray *silos_old; /* of XbSilo */
+	GMutex silo_mutex;    /* for building the silo */
+	GRWLock silo_lock;    /* for silo, query_kv and query_vs */
 	gboolean verbose;
 };
 
@@ -363,8 +367,9 @@ fu_quirks_add_quirks_for_resources(FuQuirks *self,
 			return FALSE;
 	}
 
-	/* add the hash of the current binary to verify it has not changed */
-	blob_self = fu_bytes_get_contents(self_exe, error);
+	/* add the hash of the current binary to verify it has not changed -- a running
+	 * executable cannot be written to, so it is safe to map */
+	blob_self = fu_bytes_map_contents(self_exe, error);
 	if (blob_self == NULL)
 		return FALSE;
 	hash_self = g_compute_checksum_for_bytes(G_CHECKSUM_SHA256, blob_self);
@@ -374,6 +379,8 @@ fu_quirks_add_quirks_for_resources(FuQuirks *self,
 	return TRUE;
 }
 
+/* the silo is only ever replaced with self->silo_mutex held, and the lookups hold
+ * self->silo_lock while using it */
 static gboolean
 fu_quirks_check_silo(FuQuirks *self, GError **error)
 {
@@ -381,8 +388,13 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 	g_autofree gchar *datadir = NULL;
 	g_autofree gchar *localstatedir = NULL;
 	g_autoptr(GFile) file = NULL;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->silo_mutex);
+	g_autoptr(GRWLockWriterLocker) locker_silo = NULL;
 	g_autoptr(XbBuilder) builder = NULL;
 	g_autoptr(XbNode) n_any = NULL;
+	g_autoptr(XbQuery) query_kv = NULL;
+	g_autoptr(XbQuery) query_vs = NULL;
+	g_autoptr(XbSilo) silo = NULL;
 
 	/* everything is okay */
 	if (self->silo != NULL && xb_silo_is_valid(self->silo))
@@ -421,8 +433,8 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 	}
 	if (self->load_flags & FU_QUIRKS_LOAD_FLAG_READONLY_FS)
 		compile_flags |= XB_BUILDER_COMPILE_FLAG_IGNORE_GUID;
-	self->silo = xb_builder_ensure(builder, file, compile_flags, NULL, error);
-	if (self->silo == NULL)
+	silo = xb_builder_ensure(builder, file, compile_flags, NULL, error);
+	if (silo == NULL)
 		return FALSE;
 
 	/* dump warnings to console, just once */
@@ -435,29 +447,38 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 
 	/* check if there is any quirk data to load, as older libxmlb versions will not be able to
 	 * create the prepared query with an unknown text ID */
-	n_any = xb_silo_query_first(self->silo, "quirk", NULL);
+	n_any = xb_silo_query_first(silo, "quirk", NULL);
 	if (n_any == NULL) {
 		g_debug("no quirk data, not creating prepared queries");
-		return TRUE;
+	} else {
+		/* create prepared queries to save time later */
+		query_kv = xb_query_new_full(silo,
+					     "quirk/device[@id=?]/value[@key=?]",
+					     XB_QUERY_FLAG_OPTIMIZE,
+					     error);
+		if (query_kv == NULL) {
+			g_prefix_error(error, "failed to prepare query: ");
+			return FALSE;
+		}
+		query_vs = xb_query_new_full(silo,
+					     "quirk/device[@id=?]/value",
+					     XB_QUERY_FLAG_OPTIMIZE,
+					     error);
+		if (query_vs == NULL) {
+			g_prefix_error(error, "failed to prepare query: ");
+			return FALSE;
+		}
 	}
 
-	/* create prepared queries to save time later */
-	self->query_kv = xb_query_new_full(self->silo,
-					   "quirk/device[@id=?]/value[@key=?]",
-					   XB_QUERY_FLAG_OPTIMIZE,
-					   error);
-	if (self->query_kv == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
-		return FALSE;
-	}
-	self->query_vs = xb_query_new_full(self->silo,
-					   "quirk/device[@id=?]/value",
-					   XB_QUERY_FLAG_OPTIMIZE,
-					   error);
-	if (self->query_vs == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
-		return FALSE;
-	}
+	/* the values returned from the old silo are still in use */
+	locker_silo = g_rw_lock_writer_locker_new(&self->silo_lock);
+	if (self->silo != NULL)
+		g_ptr_array_add(self->silos_old, g_steal_pointer(&self->silo));
+	g_clear_object(&self->query_kv);
+	g_clear_object(&self->query_vs);
+	self->silo = g_steal_pointer(&silo);
+	self->query_kv = g_steal_pointer(&query_kv);
+	self->query_vs = g_steal_pointer(&query_vs);
 
 	/* success */
 	return TRUE;
@@ -481,7 +502,10 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 	g_autoptr(GError) error = NULL;
 	g_autoptr(XbNode) n = NULL;
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+#else
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
 #endif
 
 	g_return_val_if_fail(FU_IS_QUIRKS(self), NULL);
@@ -494,11 +518,19 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 		return NULL;
 	}
 
+	/* older libxmlb binds the values to the shared query */
+#if LIBXMLB_CHECK_VERSION(0, 3, 0)
+	locker = g_rw_lock_reader_locker_new(&self->silo_lock);
+#else
+	locker = g_rw_lock_writer_locker_new(&self->silo_lock);
+#endif
+
 	/* no quirk data */
 	if (self->query_kv == NULL)
 		return NULL;
 
 	/* query */
+	FU_TRACE2(quirks_lookup_begin, guid, key);
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
 	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
@@ -515,6 +547,7 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 	}
 	n = xb_silo_query_first_full(self->silo, self->query_kv, &error);
 #endif
+	FU_TRACE3(quirks_lookup_end, guid, key, n != NULL);
 
 	if (n == NULL) {
 		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
@@ -551,7 +584,10 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GPtrArray) results = NULL;
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+#else
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
 #endif
 
 	g_return_val_if_fail(FU_IS_QUIRKS(self), FALSE);
@@ -564,11 +600,19 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 		return FALSE;
 	}
 
+	/* older libxmlb binds the values to the shared query */
+#if LIBXMLB_CHECK_VERSION(0, 3, 0)
+	locker = g_rw_lock_reader_locker_new(&self->silo_lock);
+#else
+	locker = g_rw_lock_writer_locker_new(&self->silo_lock);
+#endif
+
 	/* no quirk data */
 	if (self->query_vs == NULL)
 		return FALSE;
 
 	/* query */
+	FU_TRACE1(quirks_lookup_iter_begin, guid);
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
 	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
@@ -580,6 +624,7 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 	}
 	results = xb_silo_query_full(self->silo, self->query_vs, &error);
 #endif
+	FU_TRACE2(quirks_lookup_iter_end, guid, results != NULL);
 
 	if (results == NULL) {
 		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
@@ -589,6 +634,13 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 		g_warning("failed to query: %s", error->message);
 		return FALSE;
 	}
+
+	/* the callback may look up more quirks, and each node keeps a reference to the silo */
+#if LIBXMLB_CHECK_VERSION(0, 3, 0)
+	g_clear_pointer(&locker, g_rw_lock_reader_locker_free);
+#else
+	g_clear_pointer(&locker, g_rw_lock_writer_locker_free);
+#endif
 	for (guint i = 0; i < results->len; i++) {
 		XbNode *n = g_ptr_array_index(results, i);
 		if (self->verbose)
@@ -650,6 +702,9 @@ fu_quirks_init(FuQuirks *self)
 {
 	self->possible_keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->invalid_keys = g_ptr_array_new_with_free_func(g_free);
+	self->silos_old = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_mutex_init(&self->silo_mutex);
+	g_rw_lock_init(&self->silo_lock);
 
 	/* built in */
 	fu_quirks_add_possible_key(self, FU_QUIRKS_BRANCH);
@@ -706,6 +761,9 @@ fu_quirks_finalize(GObject *obj)
 		g_object_unref(self->query_vs);
 	if (self->silo != NULL)
 		g_object_unref(self->silo);
+	g_ptr_array_unref(self->silos_old);
+	g_mutex_clear(&self->silo_mutex);
+	g_rw_lock_clear(&self->silo_lock);
 	g_hash_table_unref(self->possible_keys);
 	g_ptr_array_unref(self->invalid_keys);
 	G_OBJECT_CLASS(fu_quirks_parent_class)->finalize(obj);
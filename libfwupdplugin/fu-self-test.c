@@ -8,9 +8,11 @@
 
 #include <fwupdplugin.h>
 
+#include <fcntl.h>
 #include <glib/gstdio.h>
 #include <libgcab.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "fwupd-bios-setting-private.h"
 #include "fwupd-security-attr-private.h"
@@ -182,6 +184,166 @@ fu_common_crc_func(void)
 	g_assert_cmpint(fu_crc32(buf, sizeof(buf)), ==, 0x40EFAB9E);
 }
 
+static void
+fu_common_sum_func(void)
+{
+	gsize bufsz = 2048;
+	g_autofree guint8 *buf = g_malloc(bufsz);
+
+	for (gsize i = 0; i < bufsz; i++)
+		buf[i] = (guint8)((i * 131) ^ (i >> 7));
+
+	/* compare with the simple implementation for all alignments and tail lengths */
+	for (gsize off = 0; off < 4; off++) {
+		for (gsize len = 0; len < 1100; len++) {
+			const guint8 *p = buf + off;
+			guint8 sum8 = 0;
+			guint16 sum16 = 0;
+			guint32 sum32 = 0;
+			guint16 sum16w_le = 0;
+			guint16 sum16w_be = 0;
+			guint32 sum32w_le = 0;
+			guint32 sum32w_be = 0;
+			for (gsize i = 0; i < len; i++) {
+				sum8 += p[i];
+				sum16 += p[i];
+				sum32 += p[i];
+			}
+			g_assert_cmpint(fu_sum8(p, len), ==, sum8);
+			g_assert_cmpint(fu_sum16(p, len), ==, sum16);
+			g_assert_cmpint(fu_sum32(p, len), ==, sum32);
+			if (len % 2 == 0) {
+				for (gsize i = 0; i < len; i += 2) {
+					sum16w_le += fu_memread_uint16(p + i, G_LITTLE_ENDIAN);
+					sum16w_be += fu_memread_uint16(p + i, G_BIG_ENDIAN);
+				}
+				g_assert_cmpint(fu_sum16w(p, len, G_LITTLE_ENDIAN), ==, sum16w_le);
+				g_assert_cmpint(fu_sum16w(p, len, G_BIG_ENDIAN), ==, sum16w_be);
+			}
+			if (len % 4 == 0) {
+				for (gsize i = 0; i < len; i += 4) {
+					sum32w_le += fu_memread_uint32(p + i, G_LITTLE_ENDIAN);
+					sum32w_be += fu_memread_uint32(p + i, G_BIG_ENDIAN);
+				}
+				g_assert_cmpint(fu_sum32w(p, len, G_LITTLE_ENDIAN), ==, sum32w_le);
+				g_assert_cmpint(fu_sum32w(p, len, G_BIG_ENDIAN), ==, sum32w_be);
+			}
+		}
+	}
+}
+
+/* the original bit-at-a-time implementations */
+static guint8
+fu_common_crc8_bitwise(const guint8 *buf, gsize bufsz, guint8 crc_init, guint8 polynomial)
+{
+	guint32 crc = crc_init;
+	for (gsize j = bufsz; j > 0; j--) {
+		crc ^= (*(buf++) << 8);
+		for (guint32 i = 8; i; i--) {
+			if (crc & 0x8000)
+				crc ^= ((polynomial | 0x100) << 7);
+			crc <<= 1;
+		}
+	}
+	return ~((guint8)(crc >> 8));
+}
+
+static guint16
+fu_common_crc16_bitwise(const guint8 *buf, gsize bufsz, guint16 crc, guint16 polynomial)
+{
+	for (gsize len = bufsz; len > 0; len--) {
+		crc = (guint16)(crc ^ (*buf++));
+		for (guint8 i = 0; i < 8; i++) {
+			if (crc & 0x1) {
+				crc = (crc >> 1) ^ polynomial;
+			} else {
+				crc >>= 1;
+			}
+		}
+	}
+	return ~crc;
+}
+
+static guint32
+fu_common_crc32_bitwise(const guint8 *buf, gsize bufsz, guint32 crc, guint32 polynomial)
+{
+	for (gsize idx = 0; idx < bufsz; idx++) {
+		crc = crc ^ buf[idx];
+		for (guint32 bit = 0; bit < 8; bit++) {
+			guint32 mask = -(crc & 1);
+			crc = (crc >> 1) ^ (polynomial & mask);
+		}
+	}
+	return ~crc;
+}
+
+static void
+fu_common_crc_tables_func(void)
+{
+	const guint8 polys8[] = {0x07, 0x1D, 0x31, 0x9B};
+	const guint16 polys16[] = {0xA001, 0x8408, 0x1021};
+	const guint32 polys32[] = {0xEDB88320, 0x82F63B78, 0xEB31D82E};
+	gsize bufsz = 4096;
+	g_autofree guint8 *buf = g_malloc(bufsz);
+	g_autoptr(GRand) rand = g_rand_new_with_seed(0x5EED);
+
+	for (gsize i = 0; i < bufsz; i++)
+		buf[i] = (guint8)g_rand_int_range(rand, 0, 0x100);
+
+	/* random offsets, lengths either side of the table threshold, and initial values */
+	for (guint i = 0; i < 500; i++) {
+		gsize off = g_rand_int_range(rand, 0, 8);
+		gsize len = g_rand_int_range(rand, 0, i < 250 ? 64 : bufsz - 8);
+		guint32 init = g_rand_int(rand);
+		for (guint j = 0; j < G_N_ELEMENTS(polys8); j++) {
+			g_assert_cmpint(fu_crc8_full(buf + off, len, (guint8)init, polys8[j]),
+					==,
+					fu_common_crc8_bitwise(buf + off,
+							       len,
+							       (guint8)init,
+							       polys8[j]));
+		}
+		for (guint j = 0; j < G_N_ELEMENTS(polys16); j++) {
+			g_assert_cmpint(fu_crc16_full(buf + off, len, (guint16)init, polys16[j]),
+					==,
+					fu_common_crc16_bitwise(buf + off,
+								len,
+								(guint16)init,
+								polys16[j]));
+		}
+		for (guint j = 0; j < G_N_ELEMENTS(polys32); j++) {
+			g_assert_cmpint(fu_crc32_full(buf + off, len, init, polys32[j]),
+					==,
+					fu_common_crc32_bitwise(buf + off, len, init, polys32[j]));
+		}
+	}
+}
+
+static void
+fu_common_crc_step_func(void)
+{
+	guint32 crc;
+	guint16 crc16;
+	guint8 crc8;
+	gsize bufsz = 8192;
+	g_autofree guint8 *buf = g_malloc(bufsz);
+
+	for (gsize i = 0; i < bufsz; i++)
+		buf[i] = (guint8)((i * 37) ^ (i >> 8));
+
+	/* incremental */
+	crc = fu_crc32_step(buf, 1000, 0xFFFFFFFF, 0xEDB88320);
+	crc = fu_crc32_step(buf + 1000, 3, crc, 0xEDB88320);
+	crc = fu_crc32_step(buf + 1003, 4093, crc, 0xEDB88320);
+	g_assert_cmpint(~crc, ==, fu_crc32(buf, 5096));
+	crc16 = fu_crc16_step(buf, 7, 0xFFFF, 0xA001);
+	crc16 = fu_crc16_step(buf + 7, 5089, crc16, 0xA001);
+	g_assert_cmpint((guint16)~crc16, ==, fu_crc16(buf, 5096));
+	crc8 = fu_crc8_step(buf, 1234, 0x00, 0x07);
+	crc8 = fu_crc8_step(buf + 1234, 3862, crc8, 0x07);
+	g_assert_cmpint((guint8)~crc8, ==, fu_crc8(buf, 5096));
+}
+
 static void
 fu_string_append_func(void)
 {
@@ -341,6 +503,42 @@ fu_device_metadata_func(void)
 	g_assert_cmpint(fu_device_get_metadata_integer(device, "huge"), ==, G_MAXUINT);
 }
 
+static void
+fu_device_io_stats_func(void)
+{
+	g_autoptr(FuDevice) device = fu_device_new(NULL);
+	g_autoptr(FuDevice) donor = fu_device_new(NULL);
+	g_autoptr(GHashTable) stats = NULL;
+	g_autoptr(GHashTable) stats_merged = NULL;
+	g_autoptr(GHashTable) stats_cleared = NULL;
+
+	fu_device_add_io_stat(device, "ioctl", 0, 0, 5, TRUE);
+	fu_device_add_io_stat(device, "ioctl", 0, 2, 2500, TRUE);
+	fu_device_add_io_stat(device, "ioctl", 0, 0, 5000000, FALSE);
+	fu_device_add_io_stat(device, "pread", 64, 0, 200, TRUE);
+	stats = fu_device_get_io_stats(device);
+	g_assert_cmpint(g_hash_table_size(stats), ==, 2);
+	g_assert_cmpstr(g_hash_table_lookup(stats, "ioctl"),
+			==,
+			"count=3 bytes=0 retries=2 errors=1 total=5002.5ms max=5000.0ms "
+			"latency=<10us:1,<100us:0,<1ms:0,<10ms:1,<100ms:0,<1s:0,>=1s:1");
+	g_assert_cmpstr(g_hash_table_lookup(stats, "pread"),
+			==,
+			"count=1 bytes=64 retries=0 errors=0 total=0.2ms max=0.2ms "
+			"latency=<10us:0,<100us:0,<1ms:1,<10ms:0,<100ms:0,<1s:0,>=1s:0");
+
+	/* carried over a replug */
+	fu_device_add_io_stat(donor, "ioctl", 0, 0, 5, TRUE);
+	fu_device_incorporate_io_stats(device, donor);
+	stats_merged = fu_device_get_io_stats(device);
+	g_assert_true(g_str_has_prefix(g_hash_table_lookup(stats_merged, "ioctl"), "count=4 "));
+
+	/* cleared before an update */
+	fu_device_clear_io_stats(device);
+	stats_cleared = fu_device_get_io_stats(device);
+	g_assert_cmpint(g_hash_table_size(stats_cleared), ==, 0);
+}
+
 static void
 fu_smbios_func(void)
 {
@@ -843,6 +1041,37 @@ fu_plugin_quirks_performance_func(void)
 	g_print("lookup=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
 }
 
+static gpointer
+fu_plugin_quirks_threaded_cb(gpointer user_data)
+{
+	FuQuirks *quirks = FU_QUIRKS(user_data);
+	for (guint i = 0; i < 1000; i++) {
+		const gchar *tmp =
+		    fu_quirks_lookup_by_id(quirks, "bb9ec3e2-77b3-53bc-a1f1-b05916715627", "Flags");
+		g_assert_cmpstr(tmp, ==, "clever");
+	}
+	return NULL;
+}
+
+static void
+fu_plugin_quirks_threaded_func(void)
+{
+	gboolean ret;
+	GThread *threads[4] = {NULL};
+	g_autoptr(FuQuirks) quirks = fu_quirks_new();
+	g_autoptr(GError) error = NULL;
+
+	ret = fu_quirks_load(quirks, FU_QUIRKS_LOAD_FLAG_NO_CACHE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* look up the same quirk from several threads at once */
+	for (guint i = 0; i < G_N_ELEMENTS(threads); i++)
+		threads[i] = g_thread_new("quirks", fu_plugin_quirks_threaded_cb, quirks);
+	for (guint i = 0; i < G_N_ELEMENTS(threads); i++)
+		g_thread_join(threads[i]);
+}
+
 static void
 fu_plugin_quirks_device_func(void)
 {
@@ -1022,6 +1251,152 @@ fu_common_cabinet_func(void)
 	g_assert_null(blob2);
 }
 
+static void
+fu_common_cabinet_lazy_func(void)
+{
+	gboolean ret;
+	const gchar *xml = "<component type=\"firmware\">\n"
+			   "  <id>com.acme.example.firmware</id>\n"
+			   "  <releases>\n"
+			   "    <release version=\"1.2.3\"/>\n"
+			   "  </releases>\n"
+			   "</component>\n";
+	g_autoptr(FuCabinet) cabinet1 = fu_cabinet_new();
+	g_autoptr(FuCabinet) cabinet2 = fu_cabinet_new();
+	g_autoptr(FuCabinet) cabinet3 = fu_cabinet_new();
+	g_autoptr(GBytes) blob_cab1 = NULL;
+	g_autoptr(GBytes) blob_cab2 = NULL;
+	g_autoptr(GBytes) blob_fw = g_bytes_new_static("firmware", 8);
+	g_autoptr(GBytes) blob_readme = g_bytes_new_static("readme", 6);
+	g_autoptr(GBytes) blob_tmp = NULL;
+	g_autoptr(GBytes) blob_xml = g_bytes_new_static(xml, strlen(xml));
+	g_autoptr(GError) error = NULL;
+
+	/* create an archive with a file not referenced by the metadata */
+	fu_cabinet_add_file(cabinet1, "firmware.metainfo.xml", blob_xml);
+	fu_cabinet_add_file(cabinet1, "firmware.bin", blob_fw);
+	fu_cabinet_add_file(cabinet1, "README.txt", blob_readme);
+	blob_cab1 = fu_cabinet_export(cabinet1, FU_CABINET_EXPORT_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_cab1);
+
+	/* the unreferenced file is only decompressed when asked for */
+	ret = fu_cabinet_parse(cabinet2, blob_cab1, FU_CABINET_PARSE_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob_tmp = fu_cabinet_get_file(cabinet2, "README.txt", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_tmp);
+	g_assert_cmpint(g_bytes_compare(blob_tmp, blob_readme), ==, 0);
+	g_clear_pointer(&blob_tmp, g_bytes_unref);
+
+	/* exporting a parsed archive includes every file */
+	blob_cab2 = fu_cabinet_export(cabinet2, FU_CABINET_EXPORT_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_cab2);
+	ret = fu_cabinet_parse(cabinet3, blob_cab2, FU_CABINET_PARSE_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob_tmp = fu_cabinet_get_file(cabinet3, "firmware.bin", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_tmp);
+	g_assert_cmpint(g_bytes_compare(blob_tmp, blob_fw), ==, 0);
+}
+
+static void
+fu_common_cabinet_lazy_release_func(void)
+{
+	gboolean ret;
+	const gchar *xml_used = "<component type=\"firmware\">\n"
+				"  <id>com.acme.used.firmware</id>\n"
+				"  <releases>\n"
+				"    <release version=\"1.2.3\">\n"
+				"      <checksum filename=\"used.bin\" target=\"content\"/>\n"
+				"    </release>\n"
+				"  </releases>\n"
+				"</component>\n";
+	const gchar *xml_unused = "<component type=\"firmware\">\n"
+				  "  <id>com.acme.unused.firmware</id>\n"
+				  "  <releases>\n"
+				  "    <release version=\"1.2.3\">\n"
+				  "      <checksum filename=\"unused.bin\" target=\"content\" "
+				  "type=\"sha1\">deadbeef</checksum>\n"
+				  "    </release>\n"
+				  "  </releases>\n"
+				  "</component>\n";
+	g_autoptr(FuCabinet) cabinet1 = fu_cabinet_new();
+	g_autoptr(FuCabinet) cabinet2 = fu_cabinet_new();
+	g_autoptr(GBytes) blob_cab = NULL;
+	g_autoptr(GBytes) blob_fw = g_bytes_new_static("firmware", 8);
+	g_autoptr(GBytes) blob_used = g_bytes_new_static(xml_used, strlen(xml_used));
+	g_autoptr(GBytes) blob_unused = g_bytes_new_static(xml_unused, strlen(xml_unused));
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) rel_used = NULL;
+	g_autoptr(XbNode) rel_unused = NULL;
+	g_autoptr(XbSilo) silo = NULL;
+#if LIBXMLB_CHECK_VERSION(0, 2, 0)
+	g_autoptr(XbQuery) query_used = NULL;
+	g_autoptr(XbQuery) query_unused = NULL;
+#endif
+
+	/* the payload of the unused release does not match the checksum */
+	fu_cabinet_add_file(cabinet1, "used.metainfo.xml", blob_used);
+	fu_cabinet_add_file(cabinet1, "unused.metainfo.xml", blob_unused);
+	fu_cabinet_add_file(cabinet1, "used.bin", blob_fw);
+	fu_cabinet_add_file(cabinet1, "unused.bin", blob_fw);
+	blob_cab = fu_cabinet_export(cabinet1, FU_CABINET_EXPORT_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_cab);
+
+	/* no payload is decompressed or verified when parsing */
+	ret = fu_cabinet_parse(cabinet2, blob_cab, FU_CABINET_PARSE_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	silo = fu_cabinet_get_silo(cabinet2);
+	g_assert_nonnull(silo);
+#if LIBXMLB_CHECK_VERSION(0, 2, 0)
+	query_used = xb_query_new_full(silo,
+				       "components/component/"
+				       "id[text()='com.acme.used.firmware']/../releases/release",
+				       XB_QUERY_FLAG_FORCE_NODE_CACHE,
+				       &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(query_used);
+	rel_used = xb_silo_query_first_full(silo, query_used, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(rel_used);
+	query_unused = xb_query_new_full(silo,
+					 "components/component/"
+					 "id[text()='com.acme.unused.firmware']/.."
+					 "/releases/release",
+					 XB_QUERY_FLAG_FORCE_NODE_CACHE,
+					 &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(query_unused);
+	rel_unused = xb_silo_query_first_full(silo, query_unused, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(rel_unused);
+#else
+	g_test_skip("libxmlb node cache required");
+	return;
+#endif
+	g_assert_null(xb_node_get_data(rel_used, "fwupd::FirmwareBlob"));
+	g_assert_null(xb_node_get_data(rel_unused, "fwupd::FirmwareBlob"));
+
+	/* only the requested payload is decompressed */
+	ret = fu_cabinet_load_release(rel_used, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_nonnull(xb_node_get_data(rel_used, "fwupd::FirmwareBlob"));
+	g_assert_null(xb_node_get_data(rel_unused, "fwupd::FirmwareBlob"));
+
+	/* the unused release fails verification when finally requested */
+	ret = fu_cabinet_load_release(rel_unused, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+	g_assert_false(ret);
+	g_assert_null(xb_node_get_data(rel_unused, "fwupd::FirmwareBlob"));
+}
+
 static void
 fu_common_bytes_get_data_func(void)
 {
@@ -1030,6 +1405,8 @@ fu_common_bytes_get_data_func(void)
 	gboolean ret;
 	g_autoptr(GBytes) bytes1 = NULL;
 	g_autoptr(GBytes) bytes2 = NULL;
+	g_autoptr(GBytes) bytes3 = NULL;
+	g_autoptr(GBytes) bytes4 = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GMappedFile) mmap = NULL;
 
@@ -1058,6 +1435,76 @@ fu_common_bytes_get_data_func(void)
 	buf = fu_bytes_get_data_safe(bytes2, NULL, &error);
 	g_assert_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
 	g_assert_null(buf);
+	g_clear_error(&error);
+
+	/* an empty file is read rather than mapped */
+	bytes3 = fu_bytes_map_contents(fn, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(bytes3);
+	g_assert_cmpint(g_bytes_get_size(bytes3), ==, 0);
+	g_assert_nonnull(g_bytes_get_data(bytes3, NULL));
+
+	/* mapped */
+	ret = g_file_set_contents(fn, "hello world", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	bytes4 = fu_bytes_map_contents(fn, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(bytes4);
+	g_assert_cmpint(g_bytes_get_size(bytes4), ==, 11);
+	g_assert_cmpint(memcmp(g_bytes_get_data(bytes4, NULL), "hello world", 11), ==, 0);
+}
+
+static void
+fu_common_bytes_get_contents_fd_func(void)
+{
+#if defined(HAVE_GIO_UNIX) && defined(HAVE_MEMFD_CREATE) && defined(F_ADD_SEALS)
+	gsize bufsz = 1024 * 1024;
+	g_autofree guint8 *buf = g_malloc(bufsz);
+	g_autoptr(GError) error = NULL;
+
+	for (gsize i = 0; i < bufsz; i++)
+		buf[i] = (guint8)i;
+
+	/* sealed, so mapped; unsealed, so read */
+	for (guint i = 0; i < 2; i++) {
+		gint fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		g_autoptr(GBytes) blob = NULL;
+		g_assert_cmpint(fd, >=, 0);
+		g_assert_cmpint(write(fd, buf, bufsz), ==, bufsz);
+		g_assert_cmpint(lseek(fd, 0, SEEK_SET), ==, 0);
+		if (i == 0) {
+			gint rc = fcntl(fd,
+					F_ADD_SEALS,
+					F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+			g_assert_cmpint(rc, ==, 0);
+		}
+		blob = fu_bytes_get_contents_fd(fd, bufsz, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(blob);
+		g_assert_cmpint(g_bytes_get_size(blob), ==, bufsz);
+		g_assert_cmpint(memcmp(g_bytes_get_data(blob, NULL), buf, bufsz), ==, 0);
+	}
+
+	/* too large */
+	for (guint i = 0; i < 2; i++) {
+		gint fd = memfd_create("fwupd", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		g_autoptr(GBytes) blob = NULL;
+		g_assert_cmpint(fd, >=, 0);
+		g_assert_cmpint(write(fd, buf, bufsz), ==, bufsz);
+		g_assert_cmpint(lseek(fd, 0, SEEK_SET), ==, 0);
+		if (i == 0) {
+			gint rc = fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_WRITE);
+			g_assert_cmpint(rc, ==, 0);
+		}
+		blob = fu_bytes_get_contents_fd(fd, bufsz - 1, &error);
+		g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
+		g_assert_null(blob);
+		g_clear_error(&error);
+	}
+#else
+	g_test_skip("no sealed memfd support");
+#endif
 }
 
 static gboolean
@@ -2319,6 +2766,52 @@ fu_firmware_fmap_func(void)
 	g_assert_true(ret);
 }
 
+static void
+fu_firmware_search_magic_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuFirmware) firmware = fu_fmap_firmware_new();
+	g_autoptr(FuFirmware) firmware_magic = fu_fmap_firmware_new();
+	g_autoptr(FuFirmware) firmware_nomagic = fu_fmap_firmware_new();
+	g_autoptr(FuFirmware) img = NULL;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) img_blob = g_bytes_new_static("hello world", 11);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* worst case: the header is at an unaligned offset at the end of a large image */
+	img = fu_firmware_new_from_bytes(img_blob);
+	fu_firmware_set_id(img, "FMAP");
+	fu_firmware_add_image(firmware, img);
+	fu_firmware_set_offset(firmware, 0x3FFF01);
+	blob = fu_firmware_write(firmware, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob);
+
+	/* only check where the magic is found */
+	g_timer_start(timer);
+	ret = fu_firmware_parse(firmware_magic, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_firmware_get_offset(firmware_magic), ==, 0x3FFF01);
+	if (g_test_perf()) {
+		gdouble elapsed = g_timer_elapsed(timer, NULL);
+		g_test_minimized_result(elapsed, "search-magic: %.3fms", elapsed * 1000.f);
+	}
+
+	/* check every offset */
+	fu_firmware_set_search_magic(firmware_nomagic, NULL, 0, 0);
+	g_timer_start(timer);
+	ret = fu_firmware_parse(firmware_nomagic, blob, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_firmware_get_offset(firmware_nomagic), ==, 0x3FFF01);
+	if (g_test_perf()) {
+		gdouble elapsed = g_timer_elapsed(timer, NULL);
+		g_test_minimized_result(elapsed, "search-every-offset: %.3fms", elapsed * 1000.f);
+	}
+}
+
 static void
 fu_firmware_new_from_gtypes_func(void)
 {
@@ -2586,6 +3079,96 @@ fu_firmware_dfu_patch_func(void)
 	g_assert_cmpstr(csum, ==, "0722727426092ac564861d1a11697182017be83f");
 }
 
+static void
+fu_firmware_patch_stream_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuFirmware) firmware = NULL;
+	g_autoptr(GBytes) blob = g_bytes_new_static("0123456789", 10);
+	g_autoptr(GBytes) data_patch0 = g_bytes_new_static("XX", 2);
+	g_autoptr(GBytes) data_patch1 = g_bytes_new_static("YY", 2);
+	g_autoptr(GBytes) data_patch2 = g_bytes_new_static("ZZZ", 3);
+	g_autoptr(GBytes) data_new = NULL;
+	g_autoptr(GBytes) data_stream = NULL;
+	g_autoptr(GBytes) data_overlap = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GOutputStream) stream = g_memory_output_stream_new_resizable();
+	g_autoptr(GOutputStream) stream_overlap = g_memory_output_stream_new_resizable();
+
+	/* patches are written in offset order without a copy */
+	firmware = fu_firmware_new_from_bytes(blob);
+	fu_firmware_add_patch(firmware, 6, data_patch1);
+	fu_firmware_add_patch(firmware, 0, data_patch0);
+	ret = fu_firmware_write_stream(firmware, stream, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_output_stream_close(stream, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	data_stream = g_memory_output_stream_steal_as_bytes(G_MEMORY_OUTPUT_STREAM(stream));
+	data_new = fu_firmware_write(firmware, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(data_new);
+	g_assert_true(g_bytes_equal(data_stream, data_new));
+	g_assert_cmpint(g_bytes_get_size(data_stream), ==, 10);
+	g_assert_cmpint(memcmp(g_bytes_get_data(data_stream, NULL), "XX2345YY89", 10), ==, 0);
+
+	/* an overlapping patch is applied after the earlier ones */
+	fu_firmware_add_patch(firmware, 1, data_patch2);
+	ret = fu_firmware_write_stream(firmware, stream_overlap, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_output_stream_close(stream_overlap, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	data_overlap =
+	    g_memory_output_stream_steal_as_bytes(G_MEMORY_OUTPUT_STREAM(stream_overlap));
+	g_assert_cmpint(g_bytes_get_size(data_overlap), ==, 10);
+	g_assert_cmpint(memcmp(g_bytes_get_data(data_overlap, NULL), "XZZZ45YY89", 10), ==, 0);
+}
+
+static void
+fu_firmware_write_file_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(FuFirmware) firmware = fu_firmware_new();
+	g_autoptr(FuFirmware) firmware_empty = fu_firmware_new();
+	g_autoptr(GBytes) blob = g_bytes_new_static("0123456789", 10);
+	g_autoptr(GBytes) blob_file = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) file = NULL;
+
+	fn = g_build_filename("/tmp", "fwupd-self-test", "firmware-write-file.bin", NULL);
+	file = g_file_new_for_path(fn);
+	g_unlink(fn);
+	ret = fu_path_mkdir_parent(fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* a failure does not leave a new empty file behind */
+	ret = fu_firmware_write_file(firmware_empty, file, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+	g_assert_false(g_file_query_exists(file, NULL));
+	g_clear_error(&error);
+
+	/* success */
+	fu_firmware_set_bytes(firmware, blob);
+	ret = fu_firmware_write_file(firmware, file, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* a failure does not touch the existing file */
+	ret = fu_firmware_write_file(firmware_empty, file, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+	blob_file = fu_bytes_get_contents(fn, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_file);
+	g_assert_true(g_bytes_equal(blob_file, blob));
+}
+
 static void
 fu_firmware_func(void)
 {
@@ -2910,6 +3493,121 @@ fu_device_retry_hardware_func(void)
 	g_assert_cmpint(helper.cnt_failed, ==, 2);
 }
 
+typedef struct {
+	guint pending;
+	guint pending_max;
+	guint finished;
+	guint fail_idx;
+} FuUsbDeviceTransfersHelper;
+
+static gboolean
+fu_usb_device_transfers_loopback_cb(gpointer user_data)
+{
+	GTask *task = G_TASK(user_data);
+	g_task_return_boolean(task, TRUE);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+fu_usb_device_transfers_loopback_submit(FuUsbDevice *self,
+					GByteArray *buf,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer callback_data,
+					gpointer user_data)
+{
+	FuUsbDeviceTransfersHelper *helper = (FuUsbDeviceTransfersHelper *)user_data;
+	g_autoptr(GTask) task = g_task_new(self, cancellable, callback, callback_data);
+	g_autoptr(GSource) source = g_timeout_source_new(1);
+
+	/* pretend the device takes 1ms to handle each packet */
+	helper->pending++;
+	helper->pending_max = MAX(helper->pending, helper->pending_max);
+	g_task_attach_source(task, source, fu_usb_device_transfers_loopback_cb);
+}
+
+static gboolean
+fu_usb_device_transfers_loopback_finish(FuUsbDevice *self,
+					GAsyncResult *res,
+					GByteArray *buf,
+					gpointer user_data,
+					GError **error)
+{
+	FuUsbDeviceTransfersHelper *helper = (FuUsbDeviceTransfersHelper *)user_data;
+	helper->pending--;
+	if (!g_task_propagate_boolean(G_TASK(res), error))
+		return FALSE;
+	if (buf->data[0] == helper->fail_idx) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE, "stalled");
+		return FALSE;
+	}
+	helper->finished++;
+	return TRUE;
+}
+
+static void
+fu_usb_device_transfers_func(void)
+{
+	guint queue_depths[] = {1, 8};
+	g_autoptr(FuUsbDevice) device = fu_usb_device_new(NULL, NULL);
+	g_autoptr(GPtrArray) bufs = NULL;
+
+	bufs = g_ptr_array_new_with_free_func((GDestroyNotify)g_byte_array_unref);
+
+	for (guint i = 0; i < 200; i++) {
+		GByteArray *buf = g_byte_array_new();
+		fu_byte_array_set_size(buf, 64, i);
+		g_ptr_array_add(bufs, buf);
+	}
+
+	/* benchmark against a loopback device */
+	for (guint j = 0; j < G_N_ELEMENTS(queue_depths); j++) {
+		gboolean ret;
+		FuUsbDeviceTransfersHelper helper = {.fail_idx = G_MAXUINT};
+		g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+		g_autoptr(GError) error = NULL;
+		g_autoptr(GTimer) timer = g_timer_new();
+
+		ret = fu_usb_device_transfers(device,
+					      bufs,
+					      queue_depths[j],
+					      fu_usb_device_transfers_loopback_submit,
+					      fu_usb_device_transfers_loopback_finish,
+					      &helper,
+					      progress,
+					      &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+		g_assert_cmpint(helper.finished, ==, bufs->len);
+		g_assert_cmpint(helper.pending, ==, 0);
+		g_assert_cmpint(helper.pending_max, ==, queue_depths[j]);
+		g_assert_cmpint(fu_progress_get_percentage(progress), ==, 100);
+		g_debug("queue depth %u: %.0f packets/s",
+			queue_depths[j],
+			bufs->len / g_timer_elapsed(timer, NULL));
+	}
+
+	/* the first failure is returned, and everything outstanding completes */
+	{
+		gboolean ret;
+		FuUsbDeviceTransfersHelper helper = {.fail_idx = 100};
+		g_autoptr(GError) error = NULL;
+
+		ret = fu_usb_device_transfers(device,
+					      bufs,
+					      8,
+					      fu_usb_device_transfers_loopback_submit,
+					      fu_usb_device_transfers_loopback_finish,
+					      &helper,
+					      NULL,
+					      &error);
+		g_assert_error(error, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE);
+		g_assert_false(ret);
+		g_assert_cmpint(helper.pending, ==, 0);
+		g_assert_cmpint(helper.finished, <, bufs->len);
+	}
+}
+
 static void
 fu_bios_settings_load_func(void)
 {
@@ -3405,6 +4103,109 @@ fu_progress_child_func(void)
 	g_assert_cmpint(helper.last_percentage, ==, 100);
 }
 
+static void
+fu_progress_emit_interval_func(void)
+{
+	FuProgressHelper helper = {0};
+	FuProgress *child;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	/* longer than the test will ever take */
+	fu_progress_set_emit_interval(progress, 60 * 1000);
+	fu_progress_add_step(progress, FWUPD_STATUS_DECOMPRESSING, 50, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, NULL);
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_progress_percentage_changed_cb),
+			 &helper);
+
+	/* only the first value is emitted */
+	child = fu_progress_get_child(progress);
+	for (guint i = 0; i <= 1000; i++)
+		fu_progress_set_percentage_full(child, i, 1000);
+	g_assert_cmpint(helper.updates, ==, 1);
+	g_assert_cmpint(helper.last_percentage, ==, 0);
+
+	/* the pending value is delivered before the status changes */
+	fu_progress_step_done(progress);
+	g_assert_cmpint(helper.updates, ==, 2);
+	g_assert_cmpint(helper.last_percentage, ==, 50);
+
+	/* the final 100% is always delivered */
+	child = fu_progress_get_child(progress);
+	for (guint i = 0; i <= 1000; i++)
+		fu_progress_set_percentage_full(child, i, 1000);
+	fu_progress_step_done(progress);
+	g_assert_cmpint(helper.updates, ==, 3);
+	g_assert_cmpint(helper.last_percentage, ==, 100);
+	g_assert_cmpint(fu_progress_get_emit_suppressed(progress), ==, 199);
+}
+
+static void
+fu_progress_emit_interval_flush_func(void)
+{
+	FuProgressHelper helper = {0};
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	fu_progress_set_emit_interval(progress, 50);
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_progress_percentage_changed_cb),
+			 &helper);
+	fu_progress_set_percentage(progress, 10);
+	fu_progress_set_percentage(progress, 20);
+	fu_progress_set_percentage(progress, 30);
+	g_assert_cmpint(helper.updates, ==, 1);
+	g_assert_cmpint(helper.last_percentage, ==, 10);
+
+	/* the last value is delivered once the interval expires, without any more changes */
+	while (helper.updates < 2)
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpint(helper.updates, ==, 2);
+	g_assert_cmpint(helper.last_percentage, ==, 30);
+}
+
+static void
+fu_progress_emit_interval_step_done_func(void)
+{
+	FuProgressHelper helper = {0};
+	FuProgress *child;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	fu_progress_set_emit_interval(progress, 50);
+	fu_progress_add_step(progress, FWUPD_STATUS_DECOMPRESSING, 50, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, NULL);
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_progress_percentage_changed_cb),
+			 &helper);
+
+	/* the child has a value pending when the parent moves on */
+	child = fu_progress_get_child(progress);
+	fu_progress_set_percentage(child, 10);
+	fu_progress_set_percentage(child, 20);
+	g_assert_cmpint(helper.updates, ==, 1);
+	g_assert_cmpint(helper.last_percentage, ==, 5);
+	fu_progress_step_done(progress);
+
+	/* only the parent value is delivered, and not the stale child value for the next step */
+	fu_test_loop_run_with_timeout(150);
+	fu_test_loop_quit();
+	g_assert_cmpint(helper.updates, ==, 2);
+	g_assert_cmpint(helper.last_percentage, ==, 50);
+	g_assert_cmpint(fu_progress_get_percentage(progress), ==, 50);
+
+	/* the same when finishing early */
+	child = fu_progress_get_child(progress);
+	fu_progress_set_percentage(child, 10);
+	fu_progress_set_percentage(child, 20);
+	fu_progress_finished(progress);
+	fu_test_loop_run_with_timeout(150);
+	fu_test_loop_quit();
+	g_assert_cmpint(helper.last_percentage, ==, 100);
+	g_assert_cmpint(fu_progress_get_percentage(progress), ==, 100);
+}
+
 static void
 fu_progress_parent_one_step_proxy_func(void)
 {
@@ -3589,6 +4390,11 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/progress{parent-1-step}", fu_progress_parent_one_step_proxy_func);
 	g_test_add_func("/fwupd/progress{no-equal}", fu_progress_non_equal_steps_func);
 	g_test_add_func("/fwupd/progress{finish}", fu_progress_finish_func);
+	g_test_add_func("/fwupd/progress{emit-interval}", fu_progress_emit_interval_func);
+	g_test_add_func("/fwupd/progress{emit-interval-flush}",
+			fu_progress_emit_interval_flush_func);
+	g_test_add_func("/fwupd/progress{emit-interval-step-done}",
+			fu_progress_emit_interval_step_done_func);
 	g_test_add_func("/fwupd/bios-attrs{load}", fu_bios_settings_load_func);
 	g_test_add_func("/fwupd/security-attrs{hsi}", fu_security_attrs_hsi_func);
 	g_test_add_func("/fwupd/plugin{devices}", fu_plugin_devices_func);
@@ -3597,6 +4403,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/plugin{delay}", fu_plugin_delay_func);
 	g_test_add_func("/fwupd/plugin{quirks}", fu_plugin_quirks_func);
 	g_test_add_func("/fwupd/plugin{quirks-performance}", fu_plugin_quirks_performance_func);
+	g_test_add_func("/fwupd/plugin{quirks-threaded}", fu_plugin_quirks_threaded_func);
 	g_test_add_func("/fwupd/plugin{quirks-device}", fu_plugin_quirks_device_func);
 	g_test_add_func("/fwupd/backend", fu_backend_func);
 	g_test_add_func("/fwupd/chunk", fu_chunk_func);
@@ -3604,6 +4411,9 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{gpt-type}", fu_common_gpt_type_func);
 	g_test_add_func("/fwupd/common{byte-array}", fu_common_byte_array_func);
 	g_test_add_func("/fwupd/common{crc}", fu_common_crc_func);
+	g_test_add_func("/fwupd/common{crc-tables}", fu_common_crc_tables_func);
+	g_test_add_func("/fwupd/common{crc-step}", fu_common_crc_step_func);
+	g_test_add_func("/fwupd/common{sum}", fu_common_sum_func);
 	g_test_add_func("/fwupd/common{string-append-kv}", fu_string_append_func);
 	g_test_add_func("/fwupd/common{version-guess-format}", fu_version_guess_format_func);
 	g_test_add_func("/fwupd/common{strtoull}", fu_strtoull_func);
@@ -3613,7 +4423,12 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/common{strstrip}", fu_strstrip_func);
 	g_test_add_func("/fwupd/common{endian}", fu_common_endian_func);
 	g_test_add_func("/fwupd/common{cabinet}", fu_common_cabinet_func);
+	g_test_add_func("/fwupd/common{cabinet-lazy}", fu_common_cabinet_lazy_func);
+	g_test_add_func("/fwupd/common{cabinet-lazy-release}",
+			fu_common_cabinet_lazy_release_func);
 	g_test_add_func("/fwupd/common{bytes-get-data}", fu_common_bytes_get_data_func);
+	g_test_add_func("/fwupd/common{bytes-get-contents-fd}",
+			fu_common_bytes_get_contents_fd_func);
 	g_test_add_func("/fwupd/common{kernel-lockdown}", fu_common_kernel_lockdown_func);
 	g_test_add_func("/fwupd/common{strsafe}", fu_strsafe_func);
 	g_test_add_func("/fwupd/efivar", fu_efivar_func);
@@ -3641,9 +4456,12 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{oprom}", fu_firmware_oprom_func);
 	g_test_add_func("/fwupd/firmware{dfu}", fu_firmware_dfu_func);
 	g_test_add_func("/fwupd/firmware{dfu-patch}", fu_firmware_dfu_patch_func);
+	g_test_add_func("/fwupd/firmware{patch-stream}", fu_firmware_patch_stream_func);
+	g_test_add_func("/fwupd/firmware{write-file}", fu_firmware_write_file_func);
 	g_test_add_func("/fwupd/firmware{dfuse}", fu_firmware_dfuse_func);
 	g_test_add_func("/fwupd/firmware{builder-round-trip}", fu_firmware_builder_round_trip_func);
 	g_test_add_func("/fwupd/firmware{fmap}", fu_firmware_fmap_func);
+	g_test_add_func("/fwupd/firmware{search-magic}", fu_firmware_search_magic_func);
 	g_test_add_func("/fwupd/firmware{gtypes}", fu_firmware_new_from_gtypes_func);
 	g_test_add_func("/fwupd/archive{invalid}", fu_archive_invalid_func);
 	g_test_add_func("/fwupd/archive{cab}", fu_archive_cab_func);
@@ -3663,11 +4481,13 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device-locker{fail}", fu_device_locker_fail_func);
 	g_test_add_func("/fwupd/device{name}", fu_device_name_func);
 	g_test_add_func("/fwupd/device{metadata}", fu_device_metadata_func);
+	g_test_add_func("/fwupd/device{io-stats}", fu_device_io_stats_func);
 	g_test_add_func("/fwupd/device{open-refcount}", fu_device_open_refcount_func);
 	g_test_add_func("/fwupd/device{version-format}", fu_device_version_format_func);
 	g_test_add_func("/fwupd/device{retry-success}", fu_device_retry_success_func);
 	g_test_add_func("/fwupd/device{retry-failed}", fu_device_retry_failed_func);
 	g_test_add_func("/fwupd/device{retry-hardware}", fu_device_retry_hardware_func);
 	g_test_add_func("/fwupd/device{cfi-device}", fu_device_cfi_device_func);
+	g_test_add_func("/fwupd/usb-device{transfers}", fu_usb_device_transfers_func);
 	return g_test_run();
 }
@@ -8,9 +8,132 @@
 
 #include "config.h"
 
-#include "fu-mem.h"
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "fu-sum.h"
 
+/*
+ * All of the sums can be derived from the totals of the bytes at each offset modulo 4, e.g. a
+ * little endian 16 bit word sum is the sum of the even bytes plus 256 times the sum of the odd
+ * bytes, so only one kernel is required for each instruction set.
+ */
+
+#if defined(__SSE2__)
+static gsize
+fu_sum_lanes_sse2(const guint8 *buf, gsize bufsz, guint64 lanes[4])
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	__m128i acc[4] = {zero, zero, zero, zero};
+	gsize i;
+
+	/* x86 is always little endian, and PSADBW sums each 8 bytes into a 64 bit value */
+	for (i = 0; i + 16 <= bufsz; i += 16) {
+		__m128i tmp = _mm_loadu_si128((const __m128i *)(buf + i));
+		__m128i b0 = _mm_and_si128(tmp, mask);
+		__m128i b1 = _mm_and_si128(_mm_srli_epi32(tmp, 8), mask);
+		__m128i b2 = _mm_and_si128(_mm_srli_epi32(tmp, 16), mask);
+		__m128i b3 = _mm_srli_epi32(tmp, 24);
+		acc[0] = _mm_add_epi64(acc[0], _mm_sad_epu8(b0, zero));
+		acc[1] = _mm_add_epi64(acc[1], _mm_sad_epu8(b1, zero));
+		acc[2] = _mm_add_epi64(acc[2], _mm_sad_epu8(b2, zero));
+		acc[3] = _mm_add_epi64(acc[3], _mm_sad_epu8(b3, zero));
+	}
+	for (guint j = 0; j < 4; j++) {
+		guint64 tmp[2];
+		_mm_storeu_si128((__m128i *)tmp, acc[j]);
+		lanes[j] += tmp[0] + tmp[1];
+	}
+	return i;
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+static gsize
+fu_sum_lanes_neon(const guint8 *buf, gsize bufsz, guint64 lanes[4])
+{
+	const uint32x4_t mask = vdupq_n_u32(0xFF);
+	gsize i = 0;
+
+	while (i + 16 <= bufsz) {
+		uint32x4_t acc[4] = {vdupq_n_u32(0),
+				     vdupq_n_u32(0),
+				     vdupq_n_u32(0),
+				     vdupq_n_u32(0)};
+
+		/* each 32 bit lane can hold 2^24 bytes before it overflows */
+		for (guint j = 0; j < 0x10000 && i + 16 <= bufsz; j++, i += 16) {
+			uint32x4_t tmp = vreinterpretq_u32_u8(vld1q_u8(buf + i));
+			acc[0] = vaddq_u32(acc[0], vandq_u32(tmp, mask));
+			acc[1] = vaddq_u32(acc[1], vandq_u32(vshrq_n_u32(tmp, 8), mask));
+			acc[2] = vaddq_u32(acc[2], vandq_u32(vshrq_n_u32(tmp, 16), mask));
+			acc[3] = vaddq_u32(acc[3], vshrq_n_u32(tmp, 24));
+		}
+		for (guint j = 0; j < 4; j++)
+			lanes[j] += vaddlvq_u32(acc[j]);
+	}
+	return i;
+}
+#else
+static gsize
+fu_sum_lanes_swar(const guint8 *buf, gsize bufsz, guint64 lanes[4])
+{
+	gsize i = 0;
+
+	while (i + 8 <= bufsz) {
+		guint64 even = 0;
+		guint64 odd = 0;
+
+		/* each 16 bit field can hold 256 bytes before it overflows */
+		for (guint j = 0; j < 256 && i + 8 <= bufsz; j++, i += 8) {
+			guint64 tmp;
+			memcpy(&tmp, buf + i, sizeof(tmp));
+			tmp = GUINT64_FROM_LE(tmp);
+			even += tmp & 0x00FF00FF00FF00FF;
+			odd += (tmp >> 8) & 0x00FF00FF00FF00FF;
+		}
+		lanes[0] += (even & 0xFFFF) + ((even >> 32) & 0xFFFF);
+		lanes[1] += (odd & 0xFFFF) + ((odd >> 32) & 0xFFFF);
+		lanes[2] += ((even >> 16) & 0xFFFF) + (even >> 48);
+		lanes[3] += ((odd >> 16) & 0xFFFF) + (odd >> 48);
+	}
+	return i;
+}
+#endif
+
+/* sets @lanes to the totals of the bytes at each offset modulo 4 */
+static void
+fu_sum_lanes(const guint8 *buf, gsize bufsz, guint64 lanes[4])
+{
+	gsize i;
+
+	for (guint j = 0; j < 4; j++)
+		lanes[j] = 0;
+#if defined(__SSE2__)
+	i = fu_sum_lanes_sse2(buf, bufsz, lanes);
+#elif defined(__ARM_NEON) && defined(__aarch64__) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+	i = fu_sum_lanes_neon(buf, bufsz, lanes);
+#else
+	i = fu_sum_lanes_swar(buf, bufsz, lanes);
+#endif
+
+	/* the kernels always consume a multiple of 4 bytes */
+	for (; i < bufsz; i++)
+		lanes[i % 4] += buf[i];
+}
+
+static guint64
+fu_sum_total(const guint8 *buf, gsize bufsz)
+{
+	guint64 lanes[4];
+	fu_sum_lanes(buf, bufsz, lanes);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
 /**
  * fu_sum8:
  * @buf: memory buffer
@@ -25,11 +148,8 @@
 guint8
 fu_sum8(const guint8 *buf, gsize bufsz)
 {
-	guint8 checksum = 0;
 	g_return_val_if_fail(buf != NULL, G_MAXUINT8);
-	for (gsize i = 0; i < bufsz; i++)
-		checksum += buf[i];
-	return checksum;
+	return (guint8)fu_sum_total(buf, bufsz);
 }
 
 /**
@@ -65,11 +185,8 @@ fu_sum8_bytes(GBytes *blob)
 guint16
 fu_sum16(const guint8 *buf, gsize bufsz)
 {
-	guint16 checksum = 0;
 	g_return_val_if_fail(buf != NULL, G_MAXUINT16);
-	for (gsize i = 0; i < bufsz; i++)
-		checksum += buf[i];
-	return checksum;
+	return (guint16)fu_sum_total(buf, bufsz);
 }
 
 /**
@@ -106,10 +223,26 @@ guint16
 fu_sum16w(const guint8 *buf, gsize bufsz, FuEndianType endian)
 {
 	guint16 checksum = 0;
+	guint64 lanes[4];
+	guint64 even;
+	guint64 odd;
+
 	g_return_val_if_fail(buf != NULL, G_MAXUINT16);
 	g_return_val_if_fail(bufsz % 2 == 0, G_MAXUINT16);
-	for (gsize i = 0; i < bufsz; i += 2)
-		checksum += fu_memread_uint16(&buf[i], endian);
+
+	fu_sum_lanes(buf, bufsz, lanes);
+	even = lanes[0] + lanes[2];
+	odd = lanes[1] + lanes[3];
+	switch (endian) {
+	case G_BIG_ENDIAN:
+		checksum = (guint16)((even << 8) + odd);
+		break;
+	case G_LITTLE_ENDIAN:
+		checksum = (guint16)(even + (odd << 8));
+		break;
+	default:
+		g_assert_not_reached();
+	}
 	return checksum;
 }
 
@@ -146,11 +279,8 @@ fu_sum16w_bytes(GBytes *blob, FuEndianType endian)
 guint32
 fu_sum32(const guint8 *buf, gsize bufsz)
 {
-	guint32 checksum = 0;
 	g_return_val_if_fail(buf != NULL, G_MAXUINT32);
-	for (gsize i = 0; i < bufsz; i++)
-		checksum += buf[i];
-	return checksum;
+	return (guint32)fu_sum_total(buf, bufsz);
 }
 
 /**
@@ -187,10 +317,22 @@ guint32
 fu_sum32w(const guint8 *buf, gsize bufsz, FuEndianType endian)
 {
 	guint32 checksum = 0;
+	guint64 lanes[4];
+
 	g_return_val_if_fail(buf != NULL, G_MAXUINT32);
 	g_return_val_if_fail(bufsz % 4 == 0, G_MAXUINT32);
-	for (gsize i = 0; i < bufsz; i += 4)
-		checksum += fu_memread_uint32(&buf[i], endian);
+
+	fu_sum_lanes(buf, bufsz, lanes);
+	switch (endian) {
+	case G_BIG_ENDIAN:
+		checksum = (lanes[0] << 24) + (lanes[1] << 16) + (lanes[2] << 8) + lanes[3];
+		break;
+	case G_LITTLE_ENDIAN:
+		checksum = lanes[0] + (lanes[1] << 8) + (lanes[2] << 16) + (lanes[3] << 24);
+		break;
+	default:
+		g_assert_not_reached();
+	}
 	return checksum;
 }
 
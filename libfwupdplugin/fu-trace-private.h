@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022 agent <agent@local>
+ *
+ * SPDX-License-Identifier: LGPL-2.1+
+ */
+
+#pragma once
+
+/*
+ * Static tracepoints in the `fwupd` provider, compiled in when <sys/sdt.h> is available.
+ *
+ * Each probe is a single NOP in the instruction stream until a tracer attaches, and the probe
+ * arguments must be cheap to evaluate as they are computed even when nothing is listening.
+ * Probes come in `_begin` and `_end` pairs so that the time of each phase can be measured.
+ *
+ * The engine_ and silo_ probes are compiled into the daemon and fwupdtool, and all the others
+ * into libfwupdplugin, so the tracer has to attach to the shared library for those -- where it is
+ * installed depends on the libdir, e.g.
+ *
+ *   bpftrace -e 'usdt:/usr/lib64/libfwupdplugin.so.7:fwupd:plugin_runner_begin
+ *                { @start[tid] = nsecs; }
+ *                usdt:/usr/lib64/libfwupdplugin.so.7:fwupd:plugin_runner_end /@start[tid]/
+ *                { @us[str(arg0), str(arg1)] = hist((nsecs - @start[tid]) / 1000); }'
+ *
+ *   bpftrace -e 'usdt:/usr/libexec/fwupd/fwupd:fwupd:silo_query_begin
+ *                { @[str(arg0)] = count(); }'
+ *
+ * The `_end` probes for operations that can fail take a gboolean success as the last argument.
+ *
+ * Probes:
+ *  - engine_backend_device_added_{begin,end}: backend ID
+ *  - plugin_runner_{begin,end}: plugin name, vfunc name, device ID (may be NULL)
+ *  - device_{open,close,write_firmware}_{begin,end}: device ID
+ *  - quirks_lookup_{begin,end}: GUID, key
+ *  - quirks_lookup_iter_{begin,end}: GUID
+ *  - silo_query_{begin,end}: query name, GUID or device ID
+ */
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define FU_TRACE1(name, a1)		STAP_PROBE1(fwupd, name, a1)
+#define FU_TRACE2(name, a1, a2)		STAP_PROBE2(fwupd, name, a1, a2)
+#define FU_TRACE3(name, a1, a2, a3)	STAP_PROBE3(fwupd, name, a1, a2, a3)
+#else
+#define FU_TRACE1(name, a1)                                                                        \
+	do {                                                                                       \
+	} while (0)
+#define FU_TRACE2(name, a1, a2)                                                                    \
+	do {                                                                                       \
+	} while (0)
+#define FU_TRACE3(name, a1, a2, a3)                                                                \
+	do {                                                                                       \
+	} while (0)
+#endif
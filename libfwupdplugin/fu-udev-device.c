@@ -67,6 +67,10 @@ static guint signals[SIGNAL_LAST] = {0};
 
 #define GET_PRIVATE(o) (fu_udev_device_get_instance_private(o))
 
+/* backoff used for FU_UDEV_DEVICE_FLAG_IOCTL_RETRY, in ms */
+#define FU_UDEV_DEVICE_IOCTL_RETRY_DELAY_MIN 1
+#define FU_UDEV_DEVICE_IOCTL_RETRY_DELAY_MAX 50
+
 /**
  * fu_udev_device_emit_changed:
  * @self: a #FuUdevDevice
@@ -1518,6 +1522,10 @@ fu_udev_device_ioctl(FuUdevDevice *self,
 #ifdef HAVE_IOCTL_H
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
 	gint rc_tmp;
+	gint errno_tmp;
+	guint delay = FU_UDEV_DEVICE_IOCTL_RETRY_DELAY_MIN;
+	guint retries = 0;
+	gboolean poll_useful = TRUE;
 	g_autoptr(GTimer) timer = g_timer_new();
 
 	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
@@ -1536,16 +1544,52 @@ fu_udev_device_ioctl(FuUdevDevice *self,
 		return FALSE;
 	}
 
-	/* poll if required  up to the timeout */
-	do {
+	/* retry if required up to the timeout, backing off exponentially */
+	while (TRUE) {
+		gdouble elapsed;
+		GPollFD pfd = {.fd = priv->fd, .events = G_IO_IN | G_IO_PRI | G_IO_OUT};
+
 		rc_tmp = ioctl(priv->fd, request, buf);
 		if (rc_tmp >= 0)
 			break;
-	} while ((priv->flags & FU_UDEV_DEVICE_FLAG_IOCTL_RETRY) &&
-		 (errno == EINTR || errno == EAGAIN) &&
-		 g_timer_elapsed(timer, NULL) < timeout * 1000.f);
+		if ((priv->flags & FU_UDEV_DEVICE_FLAG_IOCTL_RETRY) == 0)
+			break;
+		if (errno != EINTR && errno != EAGAIN)
+			break;
+		elapsed = g_timer_elapsed(timer, NULL) * 1000.f;
+		if (elapsed >= timeout)
+			break;
+
+		/* interrupted by a signal, so just try again */
+		retries++;
+		if (errno == EINTR)
+			continue;
+
+		/* wait for the device to become ready, or for the backoff delay */
+		delay = MIN(delay, timeout - (guint)elapsed);
+		if (poll_useful) {
+			gint64 poll_start = g_get_monotonic_time();
+			/* if the fd is always "ready" then poll() cannot tell us anything */
+			if (g_poll(&pfd, 1, delay) > 0 &&
+			    g_get_monotonic_time() - poll_start < 1000)
+				poll_useful = FALSE;
+		} else {
+			g_usleep(delay * 1000);
+		}
+		delay = MIN(delay * 2, FU_UDEV_DEVICE_IOCTL_RETRY_DELAY_MAX);
+	}
 	if (rc != NULL)
 		*rc = rc_tmp;
+
+	/* recording the statistic may clobber errno */
+	errno_tmp = errno;
+	fu_device_add_io_stat(FU_DEVICE(self),
+			      "ioctl",
+			      0,
+			      retries,
+			      g_timer_elapsed(timer, NULL) * G_USEC_PER_SEC,
+			      rc_tmp >= 0);
+	errno = errno_tmp;
 	if (rc_tmp < 0) {
 #ifdef HAVE_ERRNO_H
 		if (errno == EPERM) {
@@ -1573,6 +1617,12 @@ fu_udev_device_ioctl(FuUdevDevice *self,
 #endif
 		return FALSE;
 	}
+	if (retries > 0) {
+		g_debug("ioctl 0x%lx succeeded after %u retries in %.1fms",
+			request,
+			retries,
+			g_timer_elapsed(timer, NULL) * 1000.f);
+	}
 	return TRUE;
 #else
 	g_set_error(error,
@@ -1601,6 +1651,9 @@ gboolean
 fu_udev_device_pread(FuUdevDevice *self, goffset port, guint8 *buf, gsize bufsz, GError **error)
 {
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+#ifdef HAVE_PWRITE
+	gint64 start;
+#endif
 
 	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
 	g_return_val_if_fail(buf != NULL, FALSE);
@@ -1618,6 +1671,7 @@ fu_udev_device_pread(FuUdevDevice *self, goffset port, guint8 *buf, gsize bufsz,
 	}
 
 #ifdef HAVE_PWRITE
+	start = g_get_monotonic_time();
 	if (pread(priv->fd, buf, bufsz, port) != (gssize)bufsz) {
 		g_set_error(error,
 			    G_IO_ERROR,
@@ -1625,8 +1679,20 @@ fu_udev_device_pread(FuUdevDevice *self, goffset port, guint8 *buf, gsize bufsz,
 			    "failed to read from port 0x%04x: %s",
 			    (guint)port,
 			    strerror(errno));
+		fu_device_add_io_stat(FU_DEVICE(self),
+				      "pread",
+				      0,
+				      0,
+				      g_get_monotonic_time() - start,
+				      FALSE);
 		return FALSE;
 	}
+	fu_device_add_io_stat(FU_DEVICE(self),
+			      "pread",
+			      bufsz,
+			      0,
+			      g_get_monotonic_time() - start,
+			      TRUE);
 	return TRUE;
 #else
 	g_set_error_literal(error,
@@ -1710,6 +1776,9 @@ fu_udev_device_pwrite(FuUdevDevice *self,
 		      GError **error)
 {
 	FuUdevDevicePrivate *priv = GET_PRIVATE(self);
+#ifdef HAVE_PWRITE
+	gint64 start;
+#endif
 
 	g_return_val_if_fail(FU_IS_UDEV_DEVICE(self), FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
@@ -1726,6 +1795,7 @@ fu_udev_device_pwrite(FuUdevDevice *self,
 	}
 
 #ifdef HAVE_PWRITE
+	start = g_get_monotonic_time();
 	if (pwrite(priv->fd, buf, bufsz, port) != (gssize)bufsz) {
 		g_set_error(error,
 			    G_IO_ERROR,
@@ -1733,8 +1803,20 @@ fu_udev_device_pwrite(FuUdevDevice *self,
 			    "failed to write to port %04x: %s",
 			    (guint)port,
 			    strerror(errno));
+		fu_device_add_io_stat(FU_DEVICE(self),
+				      "pwrite",
+				      0,
+				      0,
+				      g_get_monotonic_time() - start,
+				      FALSE);
 		return FALSE;
 	}
+	fu_device_add_io_stat(FU_DEVICE(self),
+			      "pwrite",
+			      bufsz,
+			      0,
+			      g_get_monotonic_time() - start,
+			      TRUE);
 	return TRUE;
 #else
 	g_set_error_literal(error,
@@ -711,6 +711,363 @@ fu_usb_device_get_dev(FuUsbDevice *device)
 	return priv->usb_device;
 }
 
+typedef struct {
+	FuUsbDevice *self;
+	GPtrArray *bufs; /* of GByteArray */
+	guint queue_depth;
+	guint idx_submit;
+	guint idx_done;
+	guint pending;
+	FuUsbDeviceSubmitFunc submit_func;
+	FuUsbDeviceFinishFunc finish_func;
+	gpointer user_data;
+	GCancellable *cancellable;
+	GMainLoop *loop;
+	FuProgress *progress;
+	GError *error;
+} FuUsbDeviceTransferHelper;
+
+typedef struct {
+	FuUsbDeviceTransferHelper *helper; /* no-ref */
+	guint idx;
+	gint64 start;
+} FuUsbDeviceTransferItem;
+
+static void
+fu_usb_device_transfers_cb(GObject *source, GAsyncResult *res, gpointer user_data);
+
+static void
+fu_usb_device_transfers_submit(FuUsbDeviceTransferHelper *helper)
+{
+	while (helper->error == NULL && helper->pending < helper->queue_depth &&
+	       helper->idx_submit < helper->bufs->len) {
+		FuUsbDeviceTransferItem *item = g_new0(FuUsbDeviceTransferItem, 1);
+		item->helper = helper;
+		item->idx = helper->idx_submit++;
+		item->start = g_get_monotonic_time();
+		helper->pending++;
+		helper->submit_func(helper->self,
+				    g_ptr_array_index(helper->bufs, item->idx),
+				    helper->cancellable,
+				    fu_usb_device_transfers_cb,
+				    item,
+				    helper->user_data);
+	}
+}
+
+static void
+fu_usb_device_transfers_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FuUsbDeviceTransferItem *item = (FuUsbDeviceTransferItem *)user_data;
+	FuUsbDeviceTransferHelper *helper = item->helper;
+	GByteArray *buf = g_ptr_array_index(helper->bufs, item->idx);
+	g_autoptr(GError) error_local = NULL;
+
+	helper->pending--;
+	if (!helper->finish_func(helper->self, res, buf, helper->user_data, &error_local)) {
+		/* only the first failure is interesting, the rest were cancelled */
+		if (helper->error == NULL) {
+			fu_device_add_io_stat(FU_DEVICE(helper->self),
+					      "usb-transfer",
+					      0,
+					      0,
+					      g_get_monotonic_time() - item->start,
+					      FALSE);
+			g_propagate_prefixed_error(&helper->error,
+						   g_steal_pointer(&error_local),
+						   "failed to transfer packet 0x%x: ",
+						   item->idx);
+			g_cancellable_cancel(helper->cancellable);
+		}
+	} else if (helper->error == NULL) {
+		fu_device_add_io_stat(FU_DEVICE(helper->self),
+				      "usb-transfer",
+				      buf->len,
+				      0,
+				      g_get_monotonic_time() - item->start,
+				      TRUE);
+		helper->idx_done++;
+		if (helper->progress != NULL)
+			fu_progress_set_percentage_full(helper->progress,
+							helper->idx_done,
+							helper->bufs->len);
+	}
+	g_free(item);
+
+	/* keep the queue full */
+	fu_usb_device_transfers_submit(helper);
+	if (helper->pending == 0)
+		g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fu_usb_device_transfers:
+ * @self: a #FuUsbDevice
+ * @bufs: (element-type GByteArray): packets to send or receive
+ * @queue_depth: maximum number of transfers to have outstanding at once
+ * @submit_func: (scope call): function to start one asynchronous transfer
+ * @finish_func: (scope call): function to complete one transfer
+ * @user_data: user data passed to @submit_func and @finish_func
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Runs a set of asynchronous transfers, keeping up to @queue_depth outstanding so that the
+ * device does not have to wait for the host between packets. Transfers are submitted in the
+ * order of @bufs, and on failure no more are submitted and any outstanding are cancelled.
+ *
+ * The completions are dispatched from a private #GMainContext, so no other events are
+ * processed while this function is running.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_usb_device_transfers(FuUsbDevice *self,
+			GPtrArray *bufs,
+			guint queue_depth,
+			FuUsbDeviceSubmitFunc submit_func,
+			FuUsbDeviceFinishFunc finish_func,
+			gpointer user_data,
+			FuProgress *progress,
+			GError **error)
+{
+	FuUsbDeviceTransferHelper helper = {
+	    .self = self,
+	    .bufs = bufs,
+	    .queue_depth = MAX(queue_depth, 1),
+	    .submit_func = submit_func,
+	    .finish_func = finish_func,
+	    .user_data = user_data,
+	    .progress = progress,
+	};
+	g_autoptr(GMainContext) context = g_main_context_new();
+	g_autoptr(GMainLoop) loop = g_main_loop_new(context, FALSE);
+	g_autoptr(GCancellable) cancellable = g_cancellable_new();
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	g_return_val_if_fail(FU_IS_USB_DEVICE(self), FALSE);
+	g_return_val_if_fail(bufs != NULL, FALSE);
+	g_return_val_if_fail(submit_func != NULL, FALSE);
+	g_return_val_if_fail(finish_func != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	/* the async results are returned to the thread-default context */
+	helper.loop = loop;
+	helper.cancellable = cancellable;
+	g_main_context_push_thread_default(context);
+	fu_usb_device_transfers_submit(&helper);
+	if (helper.pending > 0)
+		g_main_loop_run(loop);
+	g_main_context_pop_thread_default(context);
+	if (helper.error != NULL) {
+		g_propagate_error(error, helper.error);
+		return FALSE;
+	}
+	if (g_getenv("FU_USB_DEVICE_VERBOSE") != NULL && bufs->len > 0) {
+		gdouble elapsed = g_timer_elapsed(timer, NULL);
+		g_debug("%u transfers with queue depth %u took %.1fms (%.0f packets/s)",
+			bufs->len,
+			helper.queue_depth,
+			elapsed * 1000.f,
+			elapsed > 0 ? bufs->len / elapsed : 0.f);
+	}
+	return TRUE;
+}
+
+#ifdef HAVE_GUSB
+typedef struct {
+	guint8 endpoint;
+	guint timeout;
+} FuUsbDeviceEndpointHelper;
+
+static gboolean
+fu_usb_device_transfer_check_actual(FuUsbDeviceEndpointHelper *helper,
+				    GByteArray *buf,
+				    gssize actual_len,
+				    GError **error)
+{
+	if (actual_len < 0)
+		return FALSE;
+
+	/* truncate reads to what was returned */
+	if (helper->endpoint & 0x80) {
+		g_byte_array_set_size(buf, actual_len);
+		return TRUE;
+	}
+	if ((gsize)actual_len != buf->len) {
+		g_set_error(error,
+			    G_IO_ERROR,
+			    G_IO_ERROR_INVALID_DATA,
+			    "wrote %" G_GSSIZE_FORMAT ", requested %u bytes",
+			    actual_len,
+			    buf->len);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static void
+fu_usb_device_bulk_transfer_submit(FuUsbDevice *self,
+				   GByteArray *buf,
+				   GCancellable *cancellable,
+				   GAsyncReadyCallback callback,
+				   gpointer callback_data,
+				   gpointer user_data)
+{
+	FuUsbDevicePrivate *priv = GET_PRIVATE(self);
+	FuUsbDeviceEndpointHelper *helper = (FuUsbDeviceEndpointHelper *)user_data;
+	g_usb_device_bulk_transfer_async(priv->usb_device,
+					 helper->endpoint,
+					 buf->data,
+					 buf->len,
+					 helper->timeout,
+					 cancellable,
+					 callback,
+					 callback_data);
+}
+
+static gboolean
+fu_usb_device_bulk_transfer_finish(FuUsbDevice *self,
+				   GAsyncResult *res,
+				   GByteArray *buf,
+				   gpointer user_data,
+				   GError **error)
+{
+	FuUsbDevicePrivate *priv = GET_PRIVATE(self);
+	FuUsbDeviceEndpointHelper *helper = (FuUsbDeviceEndpointHelper *)user_data;
+	gssize actual_len = g_usb_device_bulk_transfer_finish(priv->usb_device, res, error);
+	return fu_usb_device_transfer_check_actual(helper, buf, actual_len, error);
+}
+
+static void
+fu_usb_device_interrupt_transfer_submit(FuUsbDevice *self,
+					GByteArray *buf,
+					GCancellable *cancellable,
+					GAsyncReadyCallback callback,
+					gpointer callback_data,
+					gpointer user_data)
+{
+	FuUsbDevicePrivate *priv = GET_PRIVATE(self);
+	FuUsbDeviceEndpointHelper *helper = (FuUsbDeviceEndpointHelper *)user_data;
+	g_usb_device_interrupt_transfer_async(priv->usb_device,
+					      helper->endpoint,
+					      buf->data,
+					      buf->len,
+					      helper->timeout,
+					      cancellable,
+					      callback,
+					      callback_data);
+}
+
+static gboolean
+fu_usb_device_interrupt_transfer_finish(FuUsbDevice *self,
+					GAsyncResult *res,
+					GByteArray *buf,
+					gpointer user_data,
+					GError **error)
+{
+	FuUsbDevicePrivate *priv = GET_PRIVATE(self);
+	FuUsbDeviceEndpointHelper *helper = (FuUsbDeviceEndpointHelper *)user_data;
+	gssize actual_len = g_usb_device_interrupt_transfer_finish(priv->usb_device, res, error);
+	return fu_usb_device_transfer_check_actual(helper, buf, actual_len, error);
+}
+#endif
+
+/**
+ * fu_usb_device_bulk_transfers:
+ * @self: a #FuUsbDevice
+ * @endpoint: the endpoint address, where 0x80 is set for reads
+ * @bufs: (element-type GByteArray): packets to send, or buffers to receive into
+ * @queue_depth: maximum number of transfers to have outstanding at once
+ * @timeout: timeout for each transfer in ms
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Sends or receives a number of bulk transfers, keeping up to @queue_depth in flight.
+ *
+ * Short writes are an error, and each buffer used for a read is truncated to the number of
+ * bytes actually received.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_usb_device_bulk_transfers(FuUsbDevice *self,
+			     guint8 endpoint,
+			     GPtrArray *bufs,
+			     guint queue_depth,
+			     guint timeout,
+			     FuProgress *progress,
+			     GError **error)
+{
+#ifdef HAVE_GUSB
+	FuUsbDeviceEndpointHelper helper = {.endpoint = endpoint, .timeout = timeout};
+	return fu_usb_device_transfers(self,
+				       bufs,
+				       queue_depth,
+				       fu_usb_device_bulk_transfer_submit,
+				       fu_usb_device_bulk_transfer_finish,
+				       &helper,
+				       progress,
+				       error);
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as <gusb.h> is unavailable");
+	return FALSE;
+#endif
+}
+
+/**
+ * fu_usb_device_interrupt_transfers:
+ * @self: a #FuUsbDevice
+ * @endpoint: the endpoint address, where 0x80 is set for reads
+ * @bufs: (element-type GByteArray): packets to send, or buffers to receive into
+ * @queue_depth: maximum number of transfers to have outstanding at once
+ * @timeout: timeout for each transfer in ms
+ * @progress: (nullable): a #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Sends or receives a number of interrupt transfers, keeping up to @queue_depth in flight.
+ *
+ * Short writes are an error, and each buffer used for a read is truncated to the number of
+ * bytes actually received.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_usb_device_interrupt_transfers(FuUsbDevice *self,
+				  guint8 endpoint,
+				  GPtrArray *bufs,
+				  guint queue_depth,
+				  guint timeout,
+				  FuProgress *progress,
+				  GError **error)
+{
+#ifdef HAVE_GUSB
+	FuUsbDeviceEndpointHelper helper = {.endpoint = endpoint, .timeout = timeout};
+	return fu_usb_device_transfers(self,
+				       bufs,
+				       queue_depth,
+				       fu_usb_device_interrupt_transfer_submit,
+				       fu_usb_device_interrupt_transfer_finish,
+				       &helper,
+				       progress,
+				       error);
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as <gusb.h> is unavailable");
+	return FALSE;
+#endif
+}
+
 static void
 fu_usb_device_incorporate(FuDevice *self, FuDevice *donor)
 {
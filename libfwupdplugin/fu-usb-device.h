@@ -27,6 +27,41 @@ struct _FuUsbDeviceClass {
 	gpointer __reserved[31];
 };
 
+/**
+ * FuUsbDeviceSubmitFunc:
+ * @self: a #FuUsbDevice
+ * @buf: the packet to transfer
+ * @cancellable: a #GCancellable
+ * @callback: the function to call when the transfer has completed
+ * @callback_data: the data to pass to @callback
+ * @user_data: user data
+ *
+ * Starts one asynchronous transfer.
+ **/
+typedef void (*FuUsbDeviceSubmitFunc)(FuUsbDevice *self,
+				      GByteArray *buf,
+				      GCancellable *cancellable,
+				      GAsyncReadyCallback callback,
+				      gpointer callback_data,
+				      gpointer user_data);
+/**
+ * FuUsbDeviceFinishFunc:
+ * @self: a #FuUsbDevice
+ * @res: a #GAsyncResult
+ * @buf: the packet that was transferred
+ * @user_data: user data
+ * @error: (nullable): optional return location for an error
+ *
+ * Completes one asynchronous transfer.
+ *
+ * Returns: %TRUE for success
+ **/
+typedef gboolean (*FuUsbDeviceFinishFunc)(FuUsbDevice *self,
+					  GAsyncResult *res,
+					  GByteArray *buf,
+					  gpointer user_data,
+					  GError **error);
+
 FuUsbDevice *
 fu_usb_device_new(FuContext *ctx, GUsbDevice *usb_device);
 guint16
@@ -47,3 +82,28 @@ void
 fu_usb_device_set_configuration(FuUsbDevice *device, gint configuration);
 void
 fu_usb_device_add_interface(FuUsbDevice *device, guint8 number);
+gboolean
+fu_usb_device_transfers(FuUsbDevice *self,
+			GPtrArray *bufs,
+			guint queue_depth,
+			FuUsbDeviceSubmitFunc submit_func,
+			FuUsbDeviceFinishFunc finish_func,
+			gpointer user_data,
+			FuProgress *progress,
+			GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_usb_device_bulk_transfers(FuUsbDevice *self,
+			     guint8 endpoint,
+			     GPtrArray *bufs,
+			     guint queue_depth,
+			     guint timeout,
+			     FuProgress *progress,
+			     GError **error) G_GNUC_WARN_UNUSED_RESULT;
+gboolean
+fu_usb_device_interrupt_transfers(FuUsbDevice *self,
+				  guint8 endpoint,
+				  GPtrArray *bufs,
+				  guint queue_depth,
+				  guint timeout,
+				  FuProgress *progress,
+				  GError **error) G_GNUC_WARN_UNUSED_RESULT;
@@ -260,6 +260,12 @@ typedef enum {
  * Requires Force Detach in wIndex to bypass status checking.
  */
 #define FU_DFU_DEVICE_FLAG_INDEX_FORCE_DETACH (1ull << (8 + 19))
+/**
+ * FU_DFU_DEVICE_FLAG_SKIP_UNCHANGED:
+ *
+ * Upload the existing firmware first and only erase and write the sectors that differ.
+ */
+#define FU_DFU_DEVICE_FLAG_SKIP_UNCHANGED (1ull << (8 + 20))
 
 const gchar *
 fu_dfu_state_to_string(FuDfuState state);
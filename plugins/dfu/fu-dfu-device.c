@@ -427,6 +427,39 @@ fu_dfu_device_get_timeout(FuDfuDevice *self)
 	return priv->timeout_ms;
 }
 
+/**
+ * fu_dfu_device_get_download_stats:
+ * @self: a #FuDfuDevice
+ *
+ * Gets a summary of the last download for each target that was written.
+ *
+ * Returns: a string, or %NULL if nothing has been downloaded
+ **/
+gchar *
+fu_dfu_device_get_download_stats(FuDfuDevice *self)
+{
+	FuDfuDevicePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GString) str = g_string_new(NULL);
+
+	g_return_val_if_fail(FU_IS_DFU_DEVICE(self), NULL);
+
+	for (guint i = 0; i < priv->targets->len; i++) {
+		FuDfuTarget *target = g_ptr_array_index(priv->targets, i);
+		g_autofree gchar *tmp = fu_dfu_target_get_download_stats(target);
+		if (tmp == NULL)
+			continue;
+		if (str->len > 0)
+			g_string_append_c(str, '\n');
+		g_string_append_printf(str,
+				       "%s: %s",
+				       fu_device_get_logical_id(FU_DEVICE(target)),
+				       tmp);
+	}
+	if (str->len == 0)
+		return NULL;
+	return g_string_free(g_steal_pointer(&str), FALSE);
+}
+
 /**
  * fu_dfu_device_get_state:
  * @device: a #FuDfuDevice
@@ -1475,6 +1508,8 @@ fu_dfu_device_download(FuDfuDevice *self,
 		/* download onto target */
 		if (flags & DFU_TARGET_TRANSFER_FLAG_VERIFY)
 			flags_local = DFU_TARGET_TRANSFER_FLAG_VERIFY;
+		if (flags & DFU_TARGET_TRANSFER_FLAG_SKIP_UNCHANGED)
+			flags_local |= DFU_TARGET_TRANSFER_FLAG_SKIP_UNCHANGED;
 		if (!FU_IS_DFU_FIRMWARE(firmware) ||
 		    fu_dfu_firmware_get_version(FU_DFU_FIRMWARE(firmware)) == 0x0)
 			flags_local |= DFU_TARGET_TRANSFER_FLAG_ADDR_HEURISTIC;
@@ -1584,6 +1619,8 @@ fu_dfu_device_write_firmware(FuDevice *device,
 		transfer_flags |= DFU_TARGET_TRANSFER_FLAG_WILDCARD_VID;
 		transfer_flags |= DFU_TARGET_TRANSFER_FLAG_WILDCARD_PID;
 	}
+	if (fu_device_has_private_flag(device, FU_DFU_DEVICE_FLAG_SKIP_UNCHANGED))
+		transfer_flags |= DFU_TARGET_TRANSFER_FLAG_SKIP_UNCHANGED;
 
 	/* hit hardware */
 	return fu_dfu_device_download(self, firmware, progress, transfer_flags, error);
@@ -1766,4 +1803,7 @@ fu_dfu_device_init(FuDfuDevice *self)
 	fu_device_register_private_flag(FU_DEVICE(self),
 					FU_DFU_DEVICE_FLAG_INDEX_FORCE_DETACH,
 					"index-force-detach");
+	fu_device_register_private_flag(FU_DEVICE(self),
+					FU_DFU_DEVICE_FLAG_SKIP_UNCHANGED,
+					"skip-unchanged");
 }
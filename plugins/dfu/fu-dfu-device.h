@@ -64,6 +64,8 @@ guint16
 fu_dfu_device_get_version(FuDfuDevice *self);
 guint
 fu_dfu_device_get_timeout(FuDfuDevice *self);
+gchar *
+fu_dfu_device_get_download_stats(FuDfuDevice *self);
 
 void
 fu_dfu_device_set_transfer_size(FuDfuDevice *self, guint16 transfer_size);
@@ -14,6 +14,7 @@
 #include "fu-dfu-device.h"
 #include "fu-dfu-sector.h"
 #include "fu-dfu-target-private.h"
+#include "fu-dfu-target-stm.h"
 
 static void
 fu_dfu_enums_func(void)
@@ -149,6 +150,86 @@ fu_dfu_target_dfuse_func(void)
 	g_assert_false(ret);
 }
 
+static void
+fu_dfu_target_stm_dirty_func(void)
+{
+	gboolean ret;
+	guint8 buf[0x1000] = {0x0};
+	guint8 buf_old[0x1000] = {0x0};
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuDfuDevice) device = fu_dfu_device_new(ctx, NULL);
+	g_autoptr(FuDfuTarget) target = fu_dfu_target_stm_new();
+	g_autoptr(GBytes) bytes = NULL;
+	g_autoptr(GBytes) bytes_old = NULL;
+	g_autoptr(GBytes) bytes_short = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) chunks = NULL;
+
+	/* four erasable 1K sectors, written in 512 byte chunks */
+	fu_device_set_proxy(FU_DEVICE(target), FU_DEVICE(device));
+	ret = fu_dfu_target_parse_sectors(target, "@Flash /0x08000000/4*001Kg", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	buf[0x400] = 0xff;
+	buf[0xe00] = 0xff;
+	bytes = g_bytes_new(buf, sizeof(buf));
+	chunks = fu_chunk_array_new_from_bytes(bytes, 0x08000000, 0x0, 0x200);
+	g_assert_cmpint(chunks->len, ==, 8);
+
+	/* identical contents */
+	bytes_old = g_bytes_new(buf, sizeof(buf));
+	{
+		g_autofree gboolean *dirty = fu_dfu_target_stm_get_chunks_dirty(target,
+										  chunks,
+										  bytes_old);
+		g_autofree guint16 *block_nums = fu_dfu_target_stm_get_block_nums(chunks, dirty);
+		for (guint i = 0; i < chunks->len; i++) {
+			g_assert_false(dirty[i]);
+			g_assert_cmpint(block_nums[i], ==, 0);
+		}
+	}
+	g_bytes_unref(bytes_old);
+
+	/* chunks 2 and 7 changed, which also dirties the rest of their sectors */
+	bytes_old = g_bytes_new(buf_old, sizeof(buf_old));
+	{
+		const gboolean dirty_expected[] =
+		    {FALSE, FALSE, TRUE, TRUE, FALSE, FALSE, TRUE, TRUE};
+		const guint16 block_nums_expected[] = {0, 0, 2, 3, 0, 0, 2, 3};
+		g_autofree gboolean *dirty = fu_dfu_target_stm_get_chunks_dirty(target,
+										  chunks,
+										  bytes_old);
+		g_autofree guint16 *block_nums = fu_dfu_target_stm_get_block_nums(chunks, dirty);
+		for (guint i = 0; i < chunks->len; i++) {
+			g_assert_cmpint(dirty[i], ==, dirty_expected[i]);
+			g_assert_cmpint(block_nums[i], ==, block_nums_expected[i]);
+		}
+	}
+
+	/* old contents are too short, so the tail is always written */
+	bytes_short = g_bytes_new(buf, 0x900);
+	{
+		const gboolean dirty_expected[] =
+		    {FALSE, FALSE, FALSE, FALSE, TRUE, TRUE, TRUE, TRUE};
+		const guint16 block_nums_expected[] = {0, 0, 0, 0, 2, 3, 4, 5};
+		g_autofree gboolean *dirty = fu_dfu_target_stm_get_chunks_dirty(target,
+										  chunks,
+										  bytes_short);
+		g_autofree guint16 *block_nums = fu_dfu_target_stm_get_block_nums(chunks, dirty);
+		for (guint i = 0; i < chunks->len; i++) {
+			g_assert_cmpint(dirty[i], ==, dirty_expected[i]);
+			g_assert_cmpint(block_nums[i], ==, block_nums_expected[i]);
+		}
+	}
+
+	/* everything is written when the old contents are unknown */
+	{
+		g_autofree guint16 *block_nums = fu_dfu_target_stm_get_block_nums(chunks, NULL);
+		for (guint i = 0; i < chunks->len; i++)
+			g_assert_cmpint(block_nums[i], ==, i + 2);
+	}
+}
+
 int
 main(int argc, char **argv)
 {
@@ -167,5 +248,6 @@ main(int argc, char **argv)
 	/* tests go here */
 	g_test_add_func("/dfu/enums", fu_dfu_enums_func);
 	g_test_add_func("/dfu/target(DfuSe}", fu_dfu_target_dfuse_func);
+	g_test_add_func("/dfu/target-stm{dirty}", fu_dfu_target_stm_dirty_func);
 	return g_test_run();
 }
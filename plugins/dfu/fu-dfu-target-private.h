@@ -28,6 +28,17 @@ fu_dfu_target_download_chunk(FuDfuTarget *self,
 			     FuProgress *progress,
 			     GError **error);
 gboolean
+fu_dfu_target_download_chunk_submit(FuDfuTarget *self,
+				    guint16 index,
+				    GBytes *bytes,
+				    FuProgress *progress,
+				    gint64 *deadline,
+				    GError **error);
+gboolean
+fu_dfu_target_download_chunk_wait(FuDfuTarget *self, gint64 deadline, GError **error);
+void
+fu_dfu_target_add_chunks_skipped(FuDfuTarget *self, guint chunks_skipped);
+gboolean
 fu_dfu_target_attach(FuDfuTarget *self, FuProgress *progress, GError **error);
 void
 fu_dfu_target_set_alt_idx(FuDfuTarget *self, guint8 alt_idx);
@@ -256,6 +256,7 @@ fu_dfu_target_stm_erase_address(FuDfuTarget *target,
 static gboolean
 fu_dfu_target_stm_download_element1(FuDfuTarget *target,
 				    GPtrArray *chunks,
+				    const gboolean *dirty,
 				    GPtrArray *sectors_array,
 				    FuProgress *progress,
 				    GError **error)
@@ -275,6 +276,10 @@ fu_dfu_target_stm_download_element1(FuDfuTarget *target,
 	for (guint i = 0; i < chunks->len; i++) {
 		guint32 offset_dev = i * transfer_size;
 
+		/* the contents already match and the sector is not being erased */
+		if (dirty != NULL && !dirty[i])
+			continue;
+
 		/* for DfuSe devices we need to handle the erase and setting
 		 * the sectory address manually */
 		while (offset_dev < (i + 1) * transfer_size) {
@@ -340,23 +345,66 @@ fu_dfu_target_stm_download_element2(FuDfuTarget *target,
 	return TRUE;
 }
 
+/* the block number counts up from the last address set, which has to happen again after
+ * skipping any unchanged chunks -- skipped chunks are returned as zero */
+guint16 *
+fu_dfu_target_stm_get_block_nums(GPtrArray *chunks, const gboolean *dirty)
+{
+	gboolean address_stale = FALSE;
+	guint idx_base = 0;
+	guint16 *block_nums = g_new0(guint16, chunks->len);
+
+	for (guint i = 0; i < chunks->len; i++) {
+		if (dirty != NULL && !dirty[i]) {
+			address_stale = TRUE;
+			continue;
+		}
+		if (address_stale) {
+			address_stale = FALSE;
+			idx_base = i;
+		}
+		/* ST uses wBlockNum=0 for DfuSe commands and wBlockNum=1 is reserved */
+		block_nums[i] = (i - idx_base) + 2;
+	}
+	return block_nums;
+}
+
 static gboolean
 fu_dfu_target_stm_download_element3(FuDfuTarget *target,
 				    GPtrArray *chunks,
-				    GPtrArray *sectors_array,
+				    const gboolean *dirty,
 				    FuProgress *progress,
 				    GError **error)
 {
+	gboolean address_stale = FALSE;
 	guint zone_last = G_MAXUINT;
+	g_autofree guint16 *block_nums = fu_dfu_target_stm_get_block_nums(chunks, dirty);
+	g_autoptr(GBytes) bytes_next = NULL;
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, chunks->len);
+	if (chunks->len > 0)
+		bytes_next = fu_chunk_get_bytes(g_ptr_array_index(chunks, 0));
 	for (guint i = 0; i < chunks->len; i++) {
 		FuChunk *chk_tmp = g_ptr_array_index(chunks, i);
 		FuDfuSector *sector;
 		guint32 offset_dev = fu_chunk_get_address(chk_tmp);
-		g_autoptr(GBytes) bytes_tmp = NULL;
+		gint64 deadline = 0;
+		g_autoptr(GBytes) bytes_tmp = g_steal_pointer(&bytes_next);
+
+		/* prepare the next chunk */
+		if (i + 1 < chunks->len)
+			bytes_next = fu_chunk_get_bytes(g_ptr_array_index(chunks, i + 1));
+
+		/* already matches what is on the device, so the block number no longer
+		 * follows on from the address pointer */
+		if (dirty != NULL && !dirty[i]) {
+			fu_dfu_target_add_chunks_skipped(target, 1);
+			address_stale = TRUE;
+			fu_progress_step_done(progress);
+			continue;
+		}
 
 		/* for DfuSe devices we need to set the address manually */
 		sector = fu_dfu_target_get_sector_for_addr(target, offset_dev);
@@ -370,7 +418,7 @@ fu_dfu_target_stm_download_element3(FuDfuTarget *target,
 		}
 
 		/* manually set the sector address */
-		if (fu_dfu_sector_get_zone(sector) != zone_last) {
+		if (fu_dfu_sector_get_zone(sector) != zone_last || address_stale) {
 			g_autoptr(FuProgress) progress_tmp = fu_progress_new(G_STRLOC);
 			g_debug("setting address to 0x%04x", (guint)offset_dev);
 			if (!fu_dfu_target_stm_set_address(target,
@@ -379,19 +427,21 @@ fu_dfu_target_stm_download_element3(FuDfuTarget *target,
 							   error))
 				return FALSE;
 			zone_last = fu_dfu_sector_get_zone(sector);
+			address_stale = FALSE;
 		}
 
 		/* we have to write one final zero-sized chunk for EOF */
-		bytes_tmp = fu_chunk_get_bytes(chk_tmp);
 		g_debug("writing sector at 0x%04x (0x%" G_GSIZE_FORMAT ")",
 			offset_dev,
 			g_bytes_get_size(bytes_tmp));
-		/* ST uses wBlockNum=0 for DfuSe commands and wBlockNum=1 is reserved */
-		if (!fu_dfu_target_download_chunk(target,
-						  (i + 2),
-						  bytes_tmp,
-						  fu_progress_get_child(progress),
-						  error))
+		if (!fu_dfu_target_download_chunk_submit(target,
+							 block_nums[i],
+							 bytes_tmp,
+							 fu_progress_get_child(progress),
+							 &deadline,
+							 error))
+			return FALSE;
+		if (!fu_dfu_target_download_chunk_wait(target, deadline, error))
 			return FALSE;
 
 		/* getting the status moves the state machine to DNLOAD-IDLE */
@@ -406,6 +456,85 @@ fu_dfu_target_stm_download_element3(FuDfuTarget *target,
 	return TRUE;
 }
 
+/* returns %TRUE if either the chunk or any of the erasable sectors it touches became dirty */
+static gboolean
+fu_dfu_target_stm_mark_dirty(FuDfuTarget *target,
+			     FuChunk *chk,
+			     gboolean *dirty,
+			     GHashTable *sectors_dirty)
+{
+	gboolean changed = FALSE;
+	guint32 addr = fu_chunk_get_address(chk);
+	guint32 addr_end = addr + fu_chunk_get_data_sz(chk);
+
+	while (addr < addr_end) {
+		FuDfuSector *sector = fu_dfu_target_get_sector_for_addr(target, addr);
+		guint32 addr_next;
+		if (sector == NULL)
+			break;
+		if (fu_dfu_sector_has_cap(sector, DFU_SECTOR_CAP_ERASEABLE)) {
+			gboolean sector_dirty = g_hash_table_contains(sectors_dirty, sector);
+			if (*dirty && !sector_dirty) {
+				g_hash_table_add(sectors_dirty, sector);
+				changed = TRUE;
+			} else if (!*dirty && sector_dirty) {
+				*dirty = TRUE;
+				changed = TRUE;
+			}
+		}
+		addr_next = fu_dfu_sector_get_address(sector) + fu_dfu_sector_get_size(sector);
+		if (addr_next <= addr)
+			break;
+		addr = addr_next;
+	}
+	return changed;
+}
+
+/* a chunk has to be written if it differs from the old contents, or if it shares an
+ * erasable sector with a chunk that does -- which may then dirty more sectors */
+gboolean *
+fu_dfu_target_stm_get_chunks_dirty(FuDfuTarget *target, GPtrArray *chunks, GBytes *bytes_old)
+{
+	gboolean changed = TRUE;
+	gboolean *dirty = g_new0(gboolean, chunks->len);
+	gsize bufsz_old = 0;
+	const guint8 *buf_old = g_bytes_get_data(bytes_old, &bufsz_old);
+	guint32 address = 0;
+	guint chunks_dirty = 0;
+	g_autoptr(GHashTable) sectors_dirty = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	/* compare contents */
+	if (chunks->len > 0)
+		address = fu_chunk_get_address(g_ptr_array_index(chunks, 0));
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		gsize offset = fu_chunk_get_address(chk) - address;
+		gsize bufsz = fu_chunk_get_data_sz(chk);
+		if (offset + bufsz > bufsz_old ||
+		    memcmp(fu_chunk_get_data(chk), buf_old + offset, bufsz) != 0)
+			dirty[i] = TRUE;
+	}
+
+	/* propagate through erasable sectors until nothing changes */
+	while (changed) {
+		changed = FALSE;
+		for (guint i = 0; i < chunks->len; i++) {
+			FuChunk *chk = g_ptr_array_index(chunks, i);
+			if (fu_dfu_target_stm_mark_dirty(target, chk, &dirty[i], sectors_dirty))
+				changed = TRUE;
+		}
+	}
+	for (guint i = 0; i < chunks->len; i++) {
+		if (dirty[i])
+			chunks_dirty++;
+	}
+	g_debug("%u of %u chunks changed in %u sectors",
+		chunks_dirty,
+		chunks->len,
+		g_hash_table_size(sectors_dirty));
+	return dirty;
+}
+
 static gboolean
 fu_dfu_target_stm_download_element(FuDfuTarget *target,
 				   FuChunk *chk,
@@ -414,24 +543,62 @@ fu_dfu_target_stm_download_element(FuDfuTarget *target,
 				   GError **error)
 {
 	FuDfuDevice *device = FU_DFU_DEVICE(fu_device_get_proxy(FU_DEVICE(target)));
+	gboolean skip_unchanged = FALSE;
+	g_autofree gboolean *dirty = NULL;
 	g_autoptr(GBytes) bytes = NULL;
 	g_autoptr(GPtrArray) chunks = NULL;
 	g_autoptr(GPtrArray) sectors_array = g_ptr_array_new();
 
+	/* only possible if we can read back the old contents */
+	if (flags & DFU_TARGET_TRANSFER_FLAG_SKIP_UNCHANGED &&
+	    fu_device_has_private_flag(FU_DEVICE(device), FU_DFU_DEVICE_FLAG_CAN_UPLOAD))
+		skip_unchanged = TRUE;
+
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
+	if (skip_unchanged)
+		fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_READ, 20, NULL);
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_BUSY, 1, NULL);
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 49, NULL);
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 50, NULL);
 
-	/* 1st pass: work out which sectors need erasing */
+	/* split into the same chunks that get written */
 	bytes = fu_chunk_get_bytes(chk);
 	chunks = fu_chunk_array_new_from_bytes(bytes,
 					       fu_chunk_get_address(chk),
 					       0x0,
 					       fu_dfu_device_get_transfer_size(device));
+
+	/* read the existing contents so unchanged sectors can be left alone */
+	if (skip_unchanged) {
+		g_autoptr(FuChunk) chk_old = NULL;
+		g_autoptr(GError) error_local = NULL;
+		chk_old = fu_dfu_target_stm_upload_element(target,
+							   fu_chunk_get_address(chk),
+							   g_bytes_get_size(bytes),
+							   g_bytes_get_size(bytes),
+							   fu_progress_get_child(progress),
+							   &error_local);
+		if (chk_old == NULL) {
+			g_debug("writing everything, failed to read existing contents: %s",
+				error_local->message);
+			/* the failed upload may have left the device in dfuUPLOAD-IDLE or
+			 * dfuERROR, so get back to dfuIDLE before erasing anything */
+			if (!fu_dfu_device_refresh_and_clear(device, error)) {
+				g_prefix_error(error, "failed to recover from read failure: ");
+				return FALSE;
+			}
+		} else {
+			g_autoptr(GBytes) bytes_old = fu_chunk_get_bytes(chk_old);
+			dirty = fu_dfu_target_stm_get_chunks_dirty(target, chunks, bytes_old);
+		}
+		fu_progress_step_done(progress);
+	}
+
+	/* 1st pass: work out which sectors need erasing */
 	if (!fu_dfu_target_stm_download_element1(target,
 						 chunks,
+						 dirty,
 						 sectors_array,
 						 fu_progress_get_child(progress),
 						 error))
@@ -449,7 +616,7 @@ fu_dfu_target_stm_download_element(FuDfuTarget *target,
 	/* 3rd pass: write data */
 	if (!fu_dfu_target_stm_download_element3(target,
 						 chunks,
-						 sectors_array,
+						 dirty,
 						 fu_progress_get_child(progress),
 						 error))
 		return FALSE;
@@ -17,3 +17,7 @@ struct _FuDfuTargetStmClass {
 
 FuDfuTarget *
 fu_dfu_target_stm_new(void);
+gboolean *
+fu_dfu_target_stm_get_chunks_dirty(FuDfuTarget *target, GPtrArray *chunks, GBytes *bytes_old);
+guint16 *
+fu_dfu_target_stm_get_block_nums(GPtrArray *chunks, const gboolean *dirty);
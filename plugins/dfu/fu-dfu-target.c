@@ -36,6 +36,12 @@ typedef struct {
 	guint8 alt_setting;
 	guint8 alt_idx;
 	GPtrArray *sectors; /* of FuDfuSector */
+	/* for the last download, all in us */
+	gint64 time_transfer;
+	gint64 time_status;
+	gint64 time_wait;
+	guint chunks_written;
+	guint chunks_skipped;
 } FuDfuTargetPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuDfuTarget, fu_dfu_target, FU_TYPE_DEVICE)
@@ -72,6 +78,76 @@ fu_dfu_target_to_string(FuDevice *device, guint idt, GString *str)
 		g_autofree gchar *tmp2 = fu_dfu_sector_to_string(sector);
 		fu_string_append(str, idt + 1, tmp1, tmp2);
 	}
+	if (priv->chunks_written > 0 || priv->chunks_skipped > 0) {
+		g_autofree gchar *tmp = fu_dfu_target_get_download_stats(self);
+		fu_string_append(str, idt, "DownloadStats", tmp);
+	}
+}
+
+static void
+fu_dfu_target_reset_download_stats(FuDfuTarget *self)
+{
+	FuDfuTargetPrivate *priv = GET_PRIVATE(self);
+	priv->time_transfer = 0;
+	priv->time_status = 0;
+	priv->time_wait = 0;
+	priv->chunks_written = 0;
+	priv->chunks_skipped = 0;
+}
+
+/**
+ * fu_dfu_target_get_download_stats:
+ * @self: a #FuDfuTarget
+ *
+ * Gets a summary of where the time went in the last download.
+ *
+ * Returns: a string, or %NULL if nothing has been downloaded
+ **/
+gchar *
+fu_dfu_target_get_download_stats(FuDfuTarget *self)
+{
+	FuDfuTargetPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_DFU_TARGET(self), NULL);
+	if (priv->chunks_written == 0 && priv->chunks_skipped == 0)
+		return NULL;
+	return g_strdup_printf("%u chunks written, %u skipped: "
+			       "%.1fms in DNLOAD, %.1fms in GETSTATUS, %.1fms waiting for device",
+			       priv->chunks_written,
+			       priv->chunks_skipped,
+			       (gdouble)priv->time_transfer / 1000.f,
+			       (gdouble)priv->time_status / 1000.f,
+			       (gdouble)priv->time_wait / 1000.f);
+}
+
+void
+fu_dfu_target_add_chunks_skipped(FuDfuTarget *self, guint chunks_skipped)
+{
+	FuDfuTargetPrivate *priv = GET_PRIVATE(self);
+	priv->chunks_skipped += chunks_skipped;
+}
+
+/* get the device status, which also returns the new bwPollTimeout */
+static gboolean
+fu_dfu_target_refresh(FuDfuTarget *self, GError **error)
+{
+	FuDfuDevice *device = FU_DFU_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
+	FuDfuTargetPrivate *priv = GET_PRIVATE(self);
+	gint64 start = g_get_monotonic_time();
+	gboolean ret = fu_dfu_device_refresh(device, error);
+	priv->time_status += g_get_monotonic_time() - start;
+	return ret;
+}
+
+/* sleep for whatever is left of the bwPollTimeout */
+static void
+fu_dfu_target_wait_until(FuDfuTarget *self, gint64 deadline)
+{
+	FuDfuTargetPrivate *priv = GET_PRIVATE(self);
+	gint64 now = g_get_monotonic_time();
+	if (deadline <= now)
+		return;
+	g_usleep(deadline - now);
+	priv->time_wait += deadline - now;
 }
 
 FuDfuSector *
@@ -450,14 +526,16 @@ fu_dfu_target_check_status(FuDfuTarget *self, GError **error)
 	g_autoptr(GTimer) timer = g_timer_new();
 
 	/* get the status */
-	if (!fu_dfu_device_refresh(device, error))
+	if (!fu_dfu_target_refresh(self, error))
 		return FALSE;
 
 	/* wait for dfuDNBUSY to not be set */
 	while (fu_dfu_device_get_state(device) == FU_DFU_STATE_DFU_DNBUSY) {
+		gint64 deadline = g_get_monotonic_time() +
+				  (gint64)fu_dfu_device_get_download_timeout(device) * 1000;
 		g_debug("waiting for FU_DFU_STATE_DFU_DNBUSY to clear");
-		g_usleep(fu_dfu_device_get_download_timeout(device) * 1000);
-		if (!fu_dfu_device_refresh(device, error))
+		fu_dfu_target_wait_until(self, deadline);
+		if (!fu_dfu_target_refresh(self, error))
 			return FALSE;
 		/* this is a really long time to save fwupd in case
 		 * the device has got wedged */
@@ -680,17 +758,34 @@ fu_dfu_target_mass_erase(FuDfuTarget *self, FuProgress *progress, GError **error
 	return klass->mass_erase(self, progress, error);
 }
 
+/**
+ * fu_dfu_target_download_chunk_submit:
+ * @self: a #FuDfuTarget
+ * @index: the block number
+ * @bytes: data to send
+ * @progress: a #FuProgress
+ * @deadline: (out): the monotonic time to wait until before checking the status
+ * @error: (nullable): optional return location for an error
+ *
+ * Sends DFU_DNLOAD without waiting for the device to process the data. The caller can
+ * prepare the next block and then must call fu_dfu_target_download_chunk_wait().
+ *
+ * Returns: %TRUE for success
+ **/
 gboolean
-fu_dfu_target_download_chunk(FuDfuTarget *self,
-			     guint16 index,
-			     GBytes *bytes,
-			     FuProgress *progress,
-			     GError **error)
+fu_dfu_target_download_chunk_submit(FuDfuTarget *self,
+				    guint16 index,
+				    GBytes *bytes,
+				    FuProgress *progress,
+				    gint64 *deadline,
+				    GError **error)
 {
 	FuDfuDevice *device = FU_DFU_DEVICE(fu_device_get_proxy(FU_DEVICE(self)));
+	FuDfuTargetPrivate *priv = GET_PRIVATE(self);
 	GUsbDevice *usb_device = fu_usb_device_get_dev(FU_USB_DEVICE(device));
 	g_autoptr(GError) error_local = NULL;
 	gsize actual_length;
+	gint64 start = g_get_monotonic_time();
 
 	/* low level packet debugging */
 	if (g_getenv("FWUPD_DFU_VERBOSE") != NULL)
@@ -718,31 +813,60 @@ fu_dfu_target_download_chunk(FuDfuTarget *self,
 			    error_local->message);
 		return FALSE;
 	}
+	priv->time_transfer += g_get_monotonic_time() - start;
+	priv->chunks_written++;
+	g_assert_cmpint(actual_length, ==, g_bytes_get_size(bytes));
 
 	/* for STM32 devices, the action only occurs when we do GetStatus */
 	if (fu_dfu_device_get_version(device) == FU_DFU_FIRMARE_VERSION_DFUSE) {
-		if (!fu_dfu_device_refresh(device, error))
+		if (!fu_dfu_target_refresh(self, error))
 			return FALSE;
 	}
 
-	/* wait for the device to write contents to the EEPROM */
+	/* the device writes contents to the EEPROM for bwPollTimeout from now */
 	if (g_bytes_get_size(bytes) == 0 && fu_dfu_device_get_download_timeout(device) > 0)
 		fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_BUSY);
-	if (fu_dfu_device_get_download_timeout(device) > 0) {
-		g_debug("sleeping for %ums…", fu_dfu_device_get_download_timeout(device));
-		g_usleep(fu_dfu_device_get_download_timeout(device) * 1000);
-	}
+	*deadline =
+	    g_get_monotonic_time() + (gint64)fu_dfu_device_get_download_timeout(device) * 1000;
+	return TRUE;
+}
+
+/**
+ * fu_dfu_target_download_chunk_wait:
+ * @self: a #FuDfuTarget
+ * @deadline: the value returned from fu_dfu_target_download_chunk_submit()
+ * @error: (nullable): optional return location for an error
+ *
+ * Waits for the rest of the poll timeout and then for the device to no longer be busy.
+ *
+ * Returns: %TRUE for success
+ **/
+gboolean
+fu_dfu_target_download_chunk_wait(FuDfuTarget *self, gint64 deadline, GError **error)
+{
+	fu_dfu_target_wait_until(self, deadline);
 
 	/* find out if the write was successful, waiting for BUSY to clear */
 	if (!fu_dfu_target_check_status(self, error)) {
 		g_prefix_error(error, "cannot wait for busy: ");
 		return FALSE;
 	}
-
-	g_assert_cmpint(actual_length, ==, g_bytes_get_size(bytes));
 	return TRUE;
 }
 
+gboolean
+fu_dfu_target_download_chunk(FuDfuTarget *self,
+			     guint16 index,
+			     GBytes *bytes,
+			     FuProgress *progress,
+			     GError **error)
+{
+	gint64 deadline = 0;
+	if (!fu_dfu_target_download_chunk_submit(self, index, bytes, progress, &deadline, error))
+		return FALSE;
+	return fu_dfu_target_download_chunk_wait(self, deadline, error);
+}
+
 GBytes *
 fu_dfu_target_upload_chunk(FuDfuTarget *self,
 			   guint16 index,
@@ -1052,6 +1176,25 @@ _g_bytes_compare_verbose(GBytes *bytes1, GBytes *bytes2)
 	return NULL;
 }
 
+/* we have to write one final zero-sized chunk for EOF */
+static GBytes *
+fu_dfu_target_download_element_dfu_get_bytes(GBytes *bytes,
+					     guint32 idx,
+					     guint32 nr_chunks,
+					     guint16 transfer_size,
+					     GError **error)
+{
+	gsize length;
+	guint32 offset = idx * transfer_size;
+
+	if (idx == nr_chunks)
+		return g_bytes_new(NULL, 0);
+	length = g_bytes_get_size(bytes) - offset;
+	if (length > transfer_size)
+		length = transfer_size;
+	return fu_bytes_new_offset(bytes, offset, length, error);
+}
+
 static gboolean
 fu_dfu_target_download_element_dfu(FuDfuTarget *self,
 				   FuChunk *chk,
@@ -1063,6 +1206,7 @@ fu_dfu_target_download_element_dfu(FuDfuTarget *self,
 	guint32 nr_chunks;
 	guint16 transfer_size = fu_dfu_device_get_transfer_size(device);
 	g_autoptr(GBytes) bytes = NULL;
+	g_autoptr(GBytes) bytes_next = NULL;
 
 	/* round up as we have to transfer incomplete blocks */
 	bytes = fu_chunk_get_bytes(chk);
@@ -1074,30 +1218,37 @@ fu_dfu_target_download_element_dfu(FuDfuTarget *self,
 				    "zero-length firmware");
 		return FALSE;
 	}
+	bytes_next =
+	    fu_dfu_target_download_element_dfu_get_bytes(bytes, 0, nr_chunks, transfer_size, error);
+	if (bytes_next == NULL)
+		return FALSE;
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
 	for (guint32 i = 0; i < nr_chunks + 1; i++) {
-		gsize length;
-		guint32 offset;
-		g_autoptr(GBytes) bytes_tmp = NULL;
+		gint64 deadline = 0;
+		g_autoptr(GBytes) bytes_tmp = g_steal_pointer(&bytes_next);
 
-		/* caclulate the offset into the chunk data */
-		offset = i * transfer_size;
+		g_debug("writing #%04x chunk of size %" G_GSIZE_FORMAT,
+			i,
+			g_bytes_get_size(bytes_tmp));
+		if (!fu_dfu_target_download_chunk_submit(self,
+							 i,
+							 bytes_tmp,
+							 progress,
+							 &deadline,
+							 error))
+			return FALSE;
 
-		/* we have to write one final zero-sized chunk for EOF */
+		/* prepare the next chunk while the device is busy */
 		if (i < nr_chunks) {
-			length = g_bytes_get_size(bytes) - offset;
-			if (length > transfer_size)
-				length = transfer_size;
-			bytes_tmp = fu_bytes_new_offset(bytes, offset, length, error);
-			if (bytes_tmp == NULL)
+			bytes_next = fu_dfu_target_download_element_dfu_get_bytes(bytes,
+										  i + 1,
+										  nr_chunks,
+										  transfer_size,
+										  error);
+			if (bytes_next == NULL)
 				return FALSE;
-		} else {
-			bytes_tmp = g_bytes_new(NULL, 0);
 		}
-		g_debug("writing #%04x chunk of size %" G_GSIZE_FORMAT,
-			i,
-			g_bytes_get_size(bytes_tmp));
-		if (!fu_dfu_target_download_chunk(self, i, bytes_tmp, progress, error))
+		if (!fu_dfu_target_download_chunk_wait(self, deadline, error))
 			return FALSE;
 
 		/* update UI */
@@ -1222,6 +1373,7 @@ fu_dfu_target_download(FuDfuTarget *self,
 	/* use correct alt */
 	if (!fu_dfu_target_use_alt_setting(self, error))
 		return FALSE;
+	fu_dfu_target_reset_download_stats(self);
 
 	/* download all chunks in the image to the device */
 	chunks = fu_firmware_get_chunks(image, error);
@@ -1268,6 +1420,10 @@ fu_dfu_target_download(FuDfuTarget *self,
 			return FALSE;
 
 	/* success */
+	if (g_getenv("FWUPD_DFU_VERBOSE") != NULL) {
+		g_autofree gchar *stats = fu_dfu_target_get_download_stats(self);
+		g_debug("%s", stats);
+	}
 	return TRUE;
 }
 
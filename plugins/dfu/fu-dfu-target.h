@@ -21,6 +21,8 @@ G_DECLARE_DERIVABLE_TYPE(FuDfuTarget, fu_dfu_target, FU, DFU_TARGET, FuDevice)
  * @DFU_TARGET_TRANSFER_FLAG_WILDCARD_VID:	Allow downloading images with wildcard VIDs
  * @DFU_TARGET_TRANSFER_FLAG_WILDCARD_PID:	Allow downloading images with wildcard PIDs
  * @DFU_TARGET_TRANSFER_FLAG_ADDR_HEURISTIC:	Automatically detect the address to use
+ * @DFU_TARGET_TRANSFER_FLAG_SKIP_UNCHANGED:	Read the device first and do not erase or
+ *						write sectors that already match
  *
  * The optional flags used for transferring firmware.
  **/
@@ -30,6 +32,7 @@ typedef enum {
 	DFU_TARGET_TRANSFER_FLAG_WILDCARD_VID = (1 << 4),
 	DFU_TARGET_TRANSFER_FLAG_WILDCARD_PID = (1 << 5),
 	DFU_TARGET_TRANSFER_FLAG_ADDR_HEURISTIC = (1 << 7),
+	DFU_TARGET_TRANSFER_FLAG_SKIP_UNCHANGED = (1 << 8),
 	/*< private >*/
 	DFU_TARGET_TRANSFER_FLAG_LAST
 } FuDfuTargetTransferFlags;
@@ -75,3 +78,5 @@ fu_dfu_target_download(FuDfuTarget *self,
 		       GError **error);
 gboolean
 fu_dfu_target_mass_erase(FuDfuTarget *self, FuProgress *progress, GError **error);
+gchar *
+fu_dfu_target_get_download_stats(FuDfuTarget *self);
@@ -24,6 +24,7 @@ typedef struct {
 	GCancellable *cancellable;
 	GPtrArray *cmd_array;
 	gboolean force;
+	gboolean skip_unchanged;
 	gchar *device_vid_pid;
 	guint16 transfer_size;
 	FuContext *ctx;
@@ -503,6 +504,7 @@ fu_dfu_tool_write_alt(FuDfuTool *self, gchar **values, GError **error)
 {
 	FuDfuTargetTransferFlags flags = DFU_TARGET_TRANSFER_FLAG_VERIFY;
 	g_autofree gchar *str_debug = NULL;
+	g_autofree gchar *str_stats = NULL;
 	g_autoptr(FuDfuDevice) device = NULL;
 	g_autoptr(FuFirmware) firmware = NULL;
 	g_autoptr(FuFirmware) image = NULL;
@@ -607,8 +609,11 @@ fu_dfu_tool_write_alt(FuDfuTool *self, gchar **values, GError **error)
 	}
 
 	/* transfer */
+	if (self->skip_unchanged)
+		flags |= DFU_TARGET_TRANSFER_FLAG_SKIP_UNCHANGED;
 	if (!fu_dfu_target_download(target, image, progress, flags, error))
 		return FALSE;
+	str_stats = fu_dfu_target_get_download_stats(target);
 
 	/* do host reset */
 	if (!fu_device_attach_full(FU_DEVICE(device), progress, error))
@@ -621,6 +626,8 @@ fu_dfu_tool_write_alt(FuDfuTool *self, gchar **values, GError **error)
 
 	/* success */
 	g_print("Successfully downloaded to device\n");
+	if (str_stats != NULL)
+		g_print("%s\n", str_stats);
 	return TRUE;
 }
 
@@ -628,6 +635,7 @@ static gboolean
 fu_dfu_tool_write(FuDfuTool *self, gchar **values, GError **error)
 {
 	FwupdInstallFlags flags = FWUPD_INSTALL_FLAG_NO_SEARCH;
+	g_autofree gchar *str_stats = NULL;
 	g_autoptr(FuDfuDevice) device = NULL;
 	g_autoptr(GBytes) fw = NULL;
 	g_autoptr(FuDeviceLocker) locker = NULL;
@@ -673,6 +681,8 @@ fu_dfu_tool_write(FuDfuTool *self, gchar **values, GError **error)
 		flags |= FWUPD_INSTALL_FLAG_IGNORE_VID_PID;
 		flags |= FWUPD_INSTALL_FLAG_IGNORE_CHECKSUM;
 	}
+	if (self->skip_unchanged)
+		fu_device_add_private_flag(FU_DEVICE(device), FU_DFU_DEVICE_FLAG_SKIP_UNCHANGED);
 
 	/* transfer */
 	g_signal_connect(FU_PROGRESS(progress),
@@ -685,6 +695,7 @@ fu_dfu_tool_write(FuDfuTool *self, gchar **values, GError **error)
 			 self);
 	if (!fu_device_write_firmware(FU_DEVICE(device), fw, progress, flags, error))
 		return FALSE;
+	str_stats = fu_dfu_device_get_download_stats(device);
 
 	/* do host reset */
 	if (!fu_device_attach_full(FU_DEVICE(device), progress, error))
@@ -700,6 +711,8 @@ fu_dfu_tool_write(FuDfuTool *self, gchar **values, GError **error)
 
 	/* success */
 	g_print("%u bytes successfully downloaded to device\n", (guint)g_bytes_get_size(fw));
+	if (str_stats != NULL)
+		g_print("%s\n", str_stats);
 	return TRUE;
 }
 
@@ -754,6 +767,13 @@ main(int argc, char *argv[])
 	     &self->force,
 	     N_("Force the action ignoring all warnings"),
 	     NULL},
+	    {"skip-unchanged",
+	     '\0',
+	     0,
+	     G_OPTION_ARG_NONE,
+	     &self->skip_unchanged,
+	     N_("Only erase and write sectors that differ from the device contents"),
+	     NULL},
 	    {NULL}};
 
 	setlocale(LC_ALL, "");
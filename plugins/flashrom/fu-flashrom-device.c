@@ -8,6 +8,7 @@
 #include "config.h"
 
 #include <libflashrom.h>
+#include <string.h>
 
 #include "fu-flashrom-cmos.h"
 #include "fu-flashrom-device.h"
@@ -24,6 +25,12 @@
  */
 #define FU_FLASHROM_DEVICE_FLAG_FN_M_ME_UNLOCK (1 << 1)
 
+/*
+ * The smallest erase block used by SPI flash chips, used to report how much of the region has
+ * changed -- flashrom itself only erases and writes the blocks that differ from the refbuffer.
+ */
+#define FU_FLASHROM_DEVICE_ERASE_BLOCK_SIZE 0x1000
+
 struct _FuFlashromDevice {
 	FuUdevDevice parent_instance;
 	FuIfdRegion region;
@@ -180,6 +187,74 @@ fu_flashrom_device_prepare(FuDevice *device,
 	return TRUE;
 }
 
+static gboolean
+fu_flashrom_device_get_region_range(FuFlashromDevice *self,
+				    GBytes *blob,
+				    gsize *offset,
+				    gsize *size,
+				    GError **error)
+{
+	g_autoptr(FuFirmware) firmware = fu_ifd_firmware_new();
+	g_autoptr(FuFirmware) img = NULL;
+
+	if (!fu_firmware_parse(firmware, blob, FWUPD_INSTALL_FLAG_NO_SEARCH, error))
+		return FALSE;
+	img = fu_firmware_get_image_by_idx(firmware, self->region, error);
+	if (img == NULL)
+		return FALSE;
+	*offset = fu_firmware_get_addr(img);
+	*size = fu_firmware_get_size(img);
+	return TRUE;
+}
+
+/* returns the number of bytes in the erase blocks that differ, or G_MAXSIZE if unknown */
+static gsize
+fu_flashrom_device_get_region_changed(FuFlashromDevice *self, GBytes *blob_old, GBytes *blob_new)
+{
+	gsize offset_old = 0;
+	gsize offset_new = 0;
+	gsize size_old = 0;
+	gsize size_new = 0;
+	gsize changed = 0;
+	const guint8 *buf_old = g_bytes_get_data(blob_old, NULL);
+	const guint8 *buf_new = g_bytes_get_data(blob_new, NULL);
+	g_autoptr(GError) error_local = NULL;
+
+	/* flashrom uses the layout of the descriptor currently on the chip */
+	if (!fu_flashrom_device_get_region_range(self,
+						 blob_old,
+						 &offset_old,
+						 &size_old,
+						 &error_local) ||
+	    !fu_flashrom_device_get_region_range(self,
+						 blob_new,
+						 &offset_new,
+						 &size_new,
+						 &error_local)) {
+		g_debug("cannot compare %s region: %s",
+			fu_ifd_region_to_string(self->region),
+			error_local->message);
+		return G_MAXSIZE;
+	}
+	if (offset_old != offset_new || size_old != size_new ||
+	    offset_old + size_old > g_bytes_get_size(blob_old) ||
+	    offset_new + size_new > g_bytes_get_size(blob_new)) {
+		g_debug("%s region layout changed", fu_ifd_region_to_string(self->region));
+		return G_MAXSIZE;
+	}
+	for (gsize i = offset_old; i < offset_old + size_old;
+	     i += FU_FLASHROM_DEVICE_ERASE_BLOCK_SIZE) {
+		gsize chunksz = MIN(FU_FLASHROM_DEVICE_ERASE_BLOCK_SIZE, offset_old + size_old - i);
+		if (memcmp(buf_old + i, buf_new + i, chunksz) != 0)
+			changed += chunksz;
+	}
+	g_debug("%s region has 0x%x bytes changed, skipping 0x%x bytes",
+		fu_ifd_region_to_string(self->region),
+		(guint)changed,
+		(guint)(size_old - changed));
+	return changed;
+}
+
 static gboolean
 fu_flashrom_device_write_firmware(FuDevice *device,
 				  FuFirmware *firmware,
@@ -192,11 +267,13 @@ fu_flashrom_device_write_firmware(FuDevice *device,
 	gint rc;
 	const guint8 *buf;
 	g_autoptr(GBytes) blob_fw = NULL;
+	g_autoptr(GBytes) blob_old = NULL;
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
-	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 90, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_READ, 10, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 80, NULL);
 	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 10, NULL);
 
 	/* read early */
@@ -215,7 +292,32 @@ fu_flashrom_device_write_firmware(FuDevice *device,
 			    (guint)fu_device_get_firmware_size_max(device));
 		return FALSE;
 	}
-	rc = flashrom_image_write(self->flashctx, (void *)buf, sz, NULL /* refbuffer */);
+
+	/* always read the current contents, as the flash may have been changed since ->prepare(),
+	 * so that only the changed erase blocks are written */
+	blob_old = fu_flashrom_device_dump_firmware(device, fu_progress_get_child(progress), error);
+	if (blob_old == NULL)
+		return FALSE;
+	fu_progress_step_done(progress);
+	if (g_bytes_get_size(blob_old) != sz) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "invalid flash size 0x%x, expected 0x%x",
+			    (guint)g_bytes_get_size(blob_old),
+			    (guint)sz);
+		return FALSE;
+	}
+	if (fu_flashrom_device_get_region_changed(self, blob_old, blob_fw) == 0) {
+		g_debug("%s region unchanged, skipping write",
+			fu_ifd_region_to_string(self->region));
+		fu_progress_finished(progress);
+		return TRUE;
+	}
+	rc = flashrom_image_write(self->flashctx,
+				  (void *)buf,
+				  sz,
+				  (void *)g_bytes_get_data(blob_old, NULL));
 	if (rc != 0) {
 		g_set_error(error,
 			    FWUPD_ERROR,
@@ -17,6 +17,7 @@
 #endif
 
 #include <gio/gunixinputstream.h>
+#include <string.h>
 
 #include "fu-ifd-device.h"
 #include "fu-intel-spi-common.h"
@@ -370,11 +371,13 @@ fu_intel_spi_device_setup(FuDevice *device, GError **error)
 	return TRUE;
 }
 
+/* a 64 byte cycle completes in a few microseconds, which is much less than the scheduler
+ * latency of g_usleep() -- so poll the status register until the deadline instead */
 static gboolean
 fu_intel_spi_device_wait(FuIntelSpiDevice *self, guint timeout_ms, GError **error)
 {
-	g_usleep(1);
-	for (guint i = 0; i < timeout_ms * 100; i++) {
+	gint64 deadline = g_get_monotonic_time() + (gint64)timeout_ms * 1000;
+	do {
 		guint16 hsfs = fu_mmio_read16(self->spibar, ICH9_REG_HSFS);
 		if (hsfs & HSFS_FDONE)
 			return TRUE;
@@ -382,8 +385,7 @@ fu_intel_spi_device_wait(FuIntelSpiDevice *self, guint timeout_ms, GError **erro
 			g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED, "HSFS transaction error");
 			return FALSE;
 		}
-		g_usleep(10);
-	}
+	} while (g_get_monotonic_time() < deadline);
 	g_set_error(error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "HSFS timed out");
 	return FALSE;
 }
@@ -404,14 +406,18 @@ fu_intel_spi_device_dump(FuIntelSpiDevice *self,
 			 GError **error)
 {
 	guint8 block_len = 0x40;
-	g_autoptr(GByteArray) buf = g_byte_array_sized_new(length);
+	guint32 fdata[0x40 / sizeof(guint32)] = {0x0};
+	g_autofree guint8 *buf = g_malloc0(length);
+	g_autoptr(GTimer) timer = g_timer_new();
 
-	/* set FDONE, FCERR, AEL */
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_READ);
-	fu_mmio_write16(self->spibar, ICH9_REG_HSFS, fu_mmio_read16(self->spibar, ICH9_REG_HSFS));
 	for (guint32 addr = offset; addr < offset + length; addr += block_len) {
 		guint16 hsfc;
-		guint32 buftmp32 = 0;
+		guint32 chunksz = MIN(block_len, offset + length - addr);
+
+		/* clear FDONE, FCERR and AEL from the previous cycle, as otherwise the wait would
+		 * return before this cycle has completed */
+		fu_mmio_write16(self->spibar, ICH9_REG_HSFS, HSFS_FDONE | HSFS_FCERR | HSFS_AEL);
 
 		/* set up read */
 		fu_intel_spi_device_set_addr(self, addr);
@@ -420,7 +426,7 @@ fu_intel_spi_device_dump(FuIntelSpiDevice *self,
 		hsfc &= ~HSFC_FDBC;
 
 		/* set byte count */
-		hsfc |= ((block_len - 1) << 8) & HSFC_FDBC;
+		hsfc |= ((chunksz - 1) << 8) & HSFC_FDBC;
 		hsfc |= HSFC_FGO;
 		fu_mmio_write16(self->spibar, ICH9_REG_HSFC, hsfc);
 		if (!fu_intel_spi_device_wait(self, FU_INTEL_SPI_READ_TIMEOUT, error)) {
@@ -428,19 +434,29 @@ fu_intel_spi_device_dump(FuIntelSpiDevice *self,
 			return NULL;
 		}
 
-		/* copy out data */
-		for (guint i = 0; i < block_len; i++) {
-			if (i % 4 == 0)
-				buftmp32 = fu_mmio_read32(self->spibar, ICH9_REG_FDATA0 + i);
-			fu_byte_array_append_uint8(buf, buftmp32 >> ((i % 4) * 8));
+		/* copy out whole FDATA words, which are little endian */
+		for (guint i = 0; i < chunksz; i += sizeof(guint32)) {
+			guint32 tmp = fu_mmio_read32(self->spibar, ICH9_REG_FDATA0 + i);
+			fdata[i / sizeof(guint32)] = GUINT32_TO_LE(tmp);
 		}
+		memcpy(buf + (addr - offset), fdata, chunksz);
 
 		/* progress */
-		fu_progress_set_percentage_full(progress, addr - offset + block_len, length);
+		fu_progress_set_percentage_full(progress, addr - offset + chunksz, length);
+	}
+
+	/* this is used for HSI, so make slowdowns obvious */
+	if (g_getenv("FWUPD_INTEL_SPI_VERBOSE") != NULL) {
+		gdouble elapsed = g_timer_elapsed(timer, NULL);
+		g_debug("read 0x%x bytes @0x%x in %.0fms [%.1f MiB/s]",
+			length,
+			offset,
+			elapsed * 1000.f,
+			elapsed > 0.f ? (gdouble)length / (elapsed * 1024.f * 1024.f) : 0.f);
 	}
 
 	/* success */
-	return g_byte_array_free_to_bytes(g_steal_pointer(&buf));
+	return g_bytes_new_take(g_steal_pointer(&buf), length);
 }
 
 static GBytes *
@@ -19,6 +19,8 @@ static void
 fu_plugin_linux_swap_init(FuPlugin *plugin)
 {
 	fu_plugin_alloc_data(plugin, sizeof(FuPluginData));
+	/* startup only reads a kernel file and sets up a monitor on it */
+	fu_plugin_set_thread_safe(plugin, TRUE);
 }
 
 static void
@@ -10,23 +10,33 @@
 #include <mtd/mtd-user.h>
 #endif
 
+#include <string.h>
+
 #include "fu-mtd-device.h"
 
 struct _FuMtdDevice {
 	FuUdevDevice parent_instance;
 	guint64 erasesize;
+	guint64 writesize;
 };
 
 G_DEFINE_TYPE(FuMtdDevice, fu_mtd_device, FU_TYPE_UDEV_DEVICE)
 
 #define FU_MTD_DEVICE_IOCTL_TIMEOUT 5000 /* ms */
 
+/*
+ * Read back each erase block and only erase and write the blocks that have changed.
+ */
+#define FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED_BLOCKS (1 << 0)
+
 static void
 fu_mtd_device_to_string(FuDevice *device, guint idt, GString *str)
 {
 	FuMtdDevice *self = FU_MTD_DEVICE(device);
 	if (self->erasesize > 0)
 		fu_string_append_kx(str, idt, "EraseSize", self->erasesize);
+	if (self->writesize > 0)
+		fu_string_append_kx(str, idt, "WriteSize", self->writesize);
 }
 
 static gboolean
@@ -181,10 +191,56 @@ fu_mtd_device_probe(FuDevice *device, GError **error)
 		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
 #endif
 
+	/* optional, and only larger than one byte for NAND */
+	if (!fu_udev_device_get_sysfs_attr_uint64(FU_UDEV_DEVICE(device),
+						  "writesize",
+						  &self->writesize,
+						  &error_local)) {
+		g_debug("ignoring writesize: %s", error_local->message);
+		self->writesize = 0;
+	}
+
 	/* success */
 	return TRUE;
 }
 
+/* the default chunk size, rounded down to a whole number of NAND pages */
+static guint32
+fu_mtd_device_get_write_chunk_size(FuMtdDevice *self)
+{
+	guint32 chunksz = 10 * 1024;
+	if (self->writesize > 1)
+		chunksz = MAX(self->writesize, chunksz - (chunksz % self->writesize));
+	return chunksz;
+}
+
+static gboolean
+fu_mtd_device_erase_chunk(FuMtdDevice *self, FuChunk *chk, GError **error)
+{
+#ifdef HAVE_MTD_USER_H
+	struct erase_info_user erase = {
+	    .start = fu_chunk_get_address(chk),
+	    .length = fu_chunk_get_data_sz(chk),
+	};
+	if (!fu_udev_device_ioctl(FU_UDEV_DEVICE(self),
+				  MEMERASE,
+				  (guint8 *)&erase,
+				  NULL,
+				  FU_MTD_DEVICE_IOCTL_TIMEOUT,
+				  error)) {
+		g_prefix_error(error, "failed to erase @0x%x: ", (guint)erase.start);
+		return FALSE;
+	}
+	return TRUE;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as mtd-user.h is unavailable");
+	return FALSE;
+#endif
+}
+
 static gboolean
 fu_mtd_device_erase(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
 {
@@ -198,19 +254,8 @@ fu_mtd_device_erase(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError
 	/* erase each chunk */
 	for (guint i = 0; i < chunks->len; i++) {
 		FuChunk *chk = g_ptr_array_index(chunks, i);
-		struct erase_info_user erase = {
-		    .start = fu_chunk_get_address(chk),
-		    .length = fu_chunk_get_data_sz(chk),
-		};
-		if (!fu_udev_device_ioctl(FU_UDEV_DEVICE(self),
-					  2,
-					  (guint8 *)&erase,
-					  NULL,
-					  FU_MTD_DEVICE_IOCTL_TIMEOUT,
-					  error)) {
-			g_prefix_error(error, "failed to erase @0x%x: ", (guint)erase.start);
+		if (!fu_mtd_device_erase_chunk(self, chk, error))
 			return FALSE;
-		}
 		fu_progress_step_done(progress);
 	}
 
@@ -299,7 +344,8 @@ fu_mtd_device_verify(FuMtdDevice *self, GPtrArray *chunks, FuProgress *progress,
 static gboolean
 fu_mtd_device_write_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
 {
-	g_autoptr(GPtrArray) chunks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, 10 * 1024);
+	g_autoptr(GPtrArray) chunks =
+	    fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, fu_mtd_device_get_write_chunk_size(self));
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
@@ -321,6 +367,122 @@ fu_mtd_device_write_verify(FuMtdDevice *self, GBytes *fw, FuProgress *progress,
 	return TRUE;
 }
 
+static gboolean
+fu_mtd_device_is_erased(const guint8 *buf, gsize bufsz)
+{
+	for (gsize i = 0; i < bufsz; i++) {
+		if (buf[i] != 0xFF)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/* erases and writes one erase block, skipping the pages that would be left erased */
+static gboolean
+fu_mtd_device_write_block(FuMtdDevice *self, FuChunk *chk, gboolean erased, GError **error)
+{
+	g_autoptr(GBytes) blob = fu_chunk_get_bytes(chk);
+	g_autoptr(GPtrArray) pages = NULL;
+
+	if (!erased) {
+		if (!fu_mtd_device_erase_chunk(self, chk, error))
+			return FALSE;
+	}
+	pages = fu_chunk_array_new_from_bytes(blob,
+					      fu_chunk_get_address(chk),
+					      0x0,
+					      fu_mtd_device_get_write_chunk_size(self));
+	for (guint i = 0; i < pages->len; i++) {
+		FuChunk *page = g_ptr_array_index(pages, i);
+		if (fu_mtd_device_is_erased(fu_chunk_get_data(page), fu_chunk_get_data_sz(page)))
+			continue;
+		if (!fu_udev_device_pwrite(FU_UDEV_DEVICE(self),
+					   fu_chunk_get_address(page),
+					   fu_chunk_get_data(page),
+					   fu_chunk_get_data_sz(page),
+					   error)) {
+			g_prefix_error(error,
+				       "failed to write @0x%x: ",
+				       (guint)fu_chunk_get_address(page));
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_mtd_device_write_changed(FuMtdDevice *self, GBytes *fw, FuProgress *progress, GError **error)
+{
+	guint blocks_erased = 0;
+	guint blocks_skipped = 0;
+	guint blocks_written = 0;
+	g_autofree guint8 *buf = g_malloc0(self->erasesize);
+	g_autoptr(GPtrArray) chunks = fu_chunk_array_new_from_bytes(fw, 0x0, 0x0, self->erasesize);
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, chunks->len);
+
+	/* compare each erase block with what is already on the device */
+	for (guint i = 0; i < chunks->len; i++) {
+		FuChunk *chk = g_ptr_array_index(chunks, i);
+		gboolean erased;
+
+		if (!fu_udev_device_pread(FU_UDEV_DEVICE(self),
+					  fu_chunk_get_address(chk),
+					  buf,
+					  fu_chunk_get_data_sz(chk),
+					  error)) {
+			g_prefix_error(error,
+				       "failed to read @0x%x: ",
+				       (guint)fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		if (memcmp(buf, fu_chunk_get_data(chk), fu_chunk_get_data_sz(chk)) == 0) {
+			blocks_skipped++;
+			fu_progress_step_done(progress);
+			continue;
+		}
+		erased = fu_mtd_device_is_erased(buf, fu_chunk_get_data_sz(chk));
+		if (!erased)
+			blocks_erased++;
+		if (!fu_mtd_device_write_block(self, chk, erased, error))
+			return FALSE;
+		blocks_written++;
+
+		/* verify */
+		if (!fu_udev_device_pread(FU_UDEV_DEVICE(self),
+					  fu_chunk_get_address(chk),
+					  buf,
+					  fu_chunk_get_data_sz(chk),
+					  error)) {
+			g_prefix_error(error,
+				       "failed to read @0x%x: ",
+				       (guint)fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		if (!fu_memcmp_safe(buf,
+				    fu_chunk_get_data_sz(chk),
+				    fu_chunk_get_data(chk),
+				    fu_chunk_get_data_sz(chk),
+				    error)) {
+			g_prefix_error(error,
+				       "failed to verify @0x%x: ",
+				       (guint)fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		fu_progress_step_done(progress);
+	}
+	g_debug("erased %u, wrote %u and skipped %u of %u blocks",
+		blocks_erased,
+		blocks_written,
+		blocks_skipped,
+		chunks->len);
+
+	/* success */
+	return TRUE;
+}
+
 static GBytes *
 fu_mtd_device_dump_firmware(FuDevice *device, FuProgress *progress, GError **error)
 {
@@ -383,6 +545,12 @@ fu_mtd_device_write_firmware(FuDevice *device,
 	if (self->erasesize == 0)
 		return fu_mtd_device_write_verify(self, fw, progress, error);
 
+	/* only erase and write what has changed */
+	if (fu_device_has_private_flag(device, FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED_BLOCKS)) {
+		fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
+		return fu_mtd_device_write_changed(self, fw, progress, error);
+	}
+
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
@@ -416,6 +584,9 @@ fu_mtd_device_init(FuMtdDevice *self)
 	fu_udev_device_set_flags(FU_UDEV_DEVICE(self),
 				 FU_UDEV_DEVICE_FLAG_OPEN_READ | FU_UDEV_DEVICE_FLAG_OPEN_WRITE |
 				     FU_UDEV_DEVICE_FLAG_OPEN_SYNC);
+	fu_device_register_private_flag(FU_DEVICE(self),
+					FU_MTD_DEVICE_FLAG_SKIP_UNCHANGED_BLOCKS,
+					"skip-unchanged-blocks");
 }
 
 static void
@@ -6,6 +6,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "fu-context-private.h"
 #include "fu-mtd-device.h"
 
@@ -21,6 +23,8 @@ fu_test_mtd_device_func(void)
 	g_autoptr(FuProgress) progress = fu_progress_new(NULL);
 	g_autoptr(GByteArray) buf = g_byte_array_new();
 	g_autoptr(GBytes) fw2 = NULL;
+	g_autoptr(GBytes) fw3 = NULL;
+	g_autoptr(GBytes) fw4 = NULL;
 	g_autoptr(GBytes) fw = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GRand) rand = g_rand_new_with_seed(0);
@@ -88,6 +92,27 @@ fu_test_mtd_device_func(void)
 	ret = fu_bytes_compare(fw, fw2, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+
+	/* only write the erase blocks that have changed */
+	fu_device_set_custom_flags(device, "skip-unchanged-blocks");
+	buf = g_byte_array_new();
+	fu_byte_array_append_bytes(buf, fw);
+	buf->data[0x1234] ^= 0xFF;
+	memset(buf->data + 0x20000, 0xFF, 0x10000);
+	fw3 = g_byte_array_free_to_bytes(g_steal_pointer(&buf));
+	fu_progress_reset(progress);
+	ret = fu_device_write_firmware(device, fw3, progress, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* dump back */
+	fu_progress_reset(progress);
+	fw4 = fu_device_dump_firmware(device, progress, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fw4);
+	ret = fu_bytes_compare(fw3, fw4, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 #else
 	g_test_skip("no GUdev support");
 #endif
@@ -339,6 +339,7 @@ fu_synaptics_rmi_hid_device_open(FuDevice *device, GError **error)
 
 	/* set up touchpad so we can query it */
 	self->io_channel = fu_io_channel_unix_new(fu_udev_device_get_fd(FU_UDEV_DEVICE(device)));
+	fu_io_channel_set_device(self->io_channel, device);
 	if (!fu_synaptics_rmi_hid_device_set_mode(self, HID_RMI4_MODE_ATTN_REPORTS, error))
 		return FALSE;
 
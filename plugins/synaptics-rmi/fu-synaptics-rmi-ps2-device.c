@@ -805,6 +805,7 @@ fu_synaptics_rmi_ps2_device_open(FuDevice *device, GError **error)
 
 	/* create channel */
 	self->io_channel = fu_io_channel_unix_new(fu_udev_device_get_fd(FU_UDEV_DEVICE(device)));
+	fu_io_channel_set_device(self->io_channel, device);
 
 	/* in serio_raw mode */
 	if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_IS_BOOTLOADER)) {
@@ -284,6 +284,10 @@ fu_plugin_test_write_firmware(FuPlugin *plugin,
 		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_ANOTHER_WRITE_REQUIRED);
 	}
 
+	/* for the self tests only, the device re-enumerates after the write */
+	if (fu_device_get_metadata_boolean(device, "WaitForReplug"))
+		fu_device_add_flag(device, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG);
+
 	/* for the self tests only */
 	fu_device_set_metadata_integer(device,
 				       "nr-update",
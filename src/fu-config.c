@@ -37,6 +37,11 @@ struct _FuConfig {
 	gboolean ignore_power;
 	gboolean only_trusted;
 	gboolean show_device_private;
+	gboolean incremental_metadata;
+	gboolean parallel_coldplug;
+	gboolean parallel_plugin_startup;
+	gboolean parallel_install;
+	guint progress_emit_interval;
 };
 
 G_DEFINE_TYPE(FuConfig, fu_config, G_TYPE_OBJECT)
@@ -67,6 +72,10 @@ fu_config_reload(FuConfig *self, GError **error)
 	g_autoptr(GError) error_only_trusted = NULL;
 	g_autoptr(GError) error_show_device_private = NULL;
 	g_autoptr(GError) error_enumerate_all = NULL;
+	g_autoptr(GError) error_incremental_metadata = NULL;
+	g_autoptr(GError) error_parallel_coldplug = NULL;
+	g_autoptr(GError) error_parallel_plugin_startup = NULL;
+	g_autoptr(GError) error_parallel_install = NULL;
 	g_autoptr(GByteArray) buf = g_byte_array_new();
 
 	/* we have to load each file into a buffer as g_key_file_load_from_file() clears the
@@ -236,6 +245,51 @@ fu_config_reload(FuConfig *self, GError **error)
 		self->show_device_private = TRUE;
 	}
 
+	/* whether to compile each remote into a separate silo */
+	self->incremental_metadata = g_key_file_get_boolean(keyfile,
+							    "fwupd",
+							    "IncrementalMetadata",
+							    &error_incremental_metadata);
+	if (!self->incremental_metadata && error_incremental_metadata != NULL) {
+		g_debug("failed to read IncrementalMetadata key: %s",
+			error_incremental_metadata->message);
+		self->incremental_metadata = FALSE;
+	}
+
+	/* whether to probe devices using a thread pool */
+	self->parallel_coldplug = g_key_file_get_boolean(keyfile,
+							 "fwupd",
+							 "ParallelColdplug",
+							 &error_parallel_coldplug);
+	if (!self->parallel_coldplug && error_parallel_coldplug != NULL) {
+		g_debug("failed to read ParallelColdplug key: %s",
+			error_parallel_coldplug->message);
+		self->parallel_coldplug = FALSE;
+	}
+
+	/* whether to run plugins that are thread safe at the same time */
+	self->parallel_plugin_startup = g_key_file_get_boolean(keyfile,
+							       "fwupd",
+							       "ParallelPluginStartup",
+							       &error_parallel_plugin_startup);
+	if (!self->parallel_plugin_startup && error_parallel_plugin_startup != NULL) {
+		g_debug("failed to read ParallelPluginStartup key: %s",
+			error_parallel_plugin_startup->message);
+		self->parallel_plugin_startup = FALSE;
+	}
+
+	/* whether to write independent devices at the same time */
+	self->parallel_install =
+	    g_key_file_get_boolean(keyfile, "fwupd", "ParallelInstall", &error_parallel_install);
+	if (!self->parallel_install && error_parallel_install != NULL) {
+		g_debug("failed to read ParallelInstall key: %s", error_parallel_install->message);
+		self->parallel_install = FALSE;
+	}
+
+	/* minimum time between progress updates, in ms */
+	self->progress_emit_interval =
+	    g_key_file_get_uint64(keyfile, "fwupd", "ProgressEmitInterval", NULL);
+
 	/* fetch host best known configuration */
 	host_bkc = g_key_file_get_string(keyfile, "fwupd", "HostBkc", NULL);
 	if (host_bkc != NULL && host_bkc[0] != '\0')
@@ -437,6 +491,41 @@ fu_config_get_enumerate_all_devices(FuConfig *self)
 	return self->enumerate_all_devices;
 }
 
+gboolean
+fu_config_get_incremental_metadata(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), FALSE);
+	return self->incremental_metadata;
+}
+
+gboolean
+fu_config_get_parallel_coldplug(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), FALSE);
+	return self->parallel_coldplug;
+}
+
+gboolean
+fu_config_get_parallel_plugin_startup(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), FALSE);
+	return self->parallel_plugin_startup;
+}
+
+gboolean
+fu_config_get_parallel_install(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), FALSE);
+	return self->parallel_install;
+}
+
+guint
+fu_config_get_progress_emit_interval(FuConfig *self)
+{
+	g_return_val_if_fail(FU_IS_CONFIG(self), 0);
+	return self->progress_emit_interval;
+}
+
 const gchar *
 fu_config_get_host_bkc(FuConfig *self)
 {
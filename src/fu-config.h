@@ -44,5 +44,15 @@ gboolean
 fu_config_get_only_trusted(FuConfig *self);
 gboolean
 fu_config_get_show_device_private(FuConfig *self);
+gboolean
+fu_config_get_incremental_metadata(FuConfig *self);
+gboolean
+fu_config_get_parallel_coldplug(FuConfig *self);
+gboolean
+fu_config_get_parallel_plugin_startup(FuConfig *self);
+gboolean
+fu_config_get_parallel_install(FuConfig *self);
+guint
+fu_config_get_progress_emit_interval(FuConfig *self);
 const gchar *
 fu_config_get_host_bkc(FuConfig *self);
@@ -689,6 +689,12 @@ fu_daemon_modify_config_cb(GObject *source, GAsyncResult *res, gpointer user_dat
 	g_dbus_method_invocation_return_value(helper->invocation, NULL);
 }
 
+static guint
+fu_daemon_get_progress_emit_interval(FuDaemon *self)
+{
+	return fu_config_get_progress_emit_interval(fu_engine_get_config(self->engine));
+}
+
 static void
 fu_daemon_progress_percentage_changed_cb(FuProgress *progress, guint percentage, FuDaemon *self)
 {
@@ -726,6 +732,7 @@ fu_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointer use
 
 	/* progress */
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_emit_interval(progress, fu_daemon_get_progress_emit_interval(helper->self));
 	g_signal_connect(FU_PROGRESS(progress),
 			 "percentage-changed",
 			 G_CALLBACK(fu_daemon_progress_percentage_changed_cb),
@@ -769,6 +776,7 @@ fu_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* progress */
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_emit_interval(progress, fu_daemon_get_progress_emit_interval(helper->self));
 	g_signal_connect(FU_PROGRESS(progress),
 			 "percentage-changed",
 			 G_CALLBACK(fu_daemon_progress_percentage_changed_cb),
@@ -877,6 +885,7 @@ fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 
 	/* all authenticated, so install all the things */
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_emit_interval(progress, fu_daemon_get_progress_emit_interval(helper->self));
 	g_signal_connect(FU_PROGRESS(progress),
 			 "percentage-changed",
 			 G_CALLBACK(fu_daemon_progress_percentage_changed_cb),
@@ -896,6 +905,10 @@ fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 					 helper->flags,
 					 &error);
 	self->update_in_progress = FALSE;
+	if (fu_progress_get_emit_suppressed(progress) > 0) {
+		g_debug("coalesced %" G_GUINT64_FORMAT " progress updates",
+			fu_progress_get_emit_suppressed(progress));
+	}
 	if (self->pending_stop)
 		g_main_loop_quit(self->loop);
 	if (!ret) {
@@ -1566,6 +1579,33 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
 		return;
 	}
+	if (g_strcmp0(method_name, "GetDeviceStats") == 0) {
+		GHashTableIter iter;
+		GVariantBuilder builder;
+		const gchar *device_id = NULL;
+		const gchar *key;
+		const gchar *value;
+		g_autoptr(GHashTable) stats = NULL;
+
+		g_variant_get(parameters, "(&s)", &device_id);
+		g_debug("Called %s(%s)", method_name, device_id);
+		if (!fu_daemon_device_id_valid(device_id, &error)) {
+			g_dbus_method_invocation_return_gerror(invocation, error);
+			return;
+		}
+		stats = fu_engine_get_device_stats(self->engine, device_id, &error);
+		if (stats == NULL) {
+			g_dbus_method_invocation_return_gerror(invocation, error);
+			return;
+		}
+		g_variant_builder_init(&builder, G_VARIANT_TYPE("a{ss}"));
+		g_hash_table_iter_init(&iter, stats);
+		while (g_hash_table_iter_next(&iter, (gpointer *)&key, (gpointer *)&value))
+			g_variant_builder_add_value(&builder, g_variant_new("{ss}", key, value));
+		val = g_variant_builder_end(&builder);
+		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+		return;
+	}
 	if (g_strcmp0(method_name, "UpdateMetadata") == 0) {
 #ifdef HAVE_GIO_UNIX
 		GDBusMessage *message;
@@ -1806,6 +1846,7 @@ fu_daemon_daemon_method_call(GDBusConnection *connection,
 
 		/* progress */
 		fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+		fu_progress_set_emit_interval(progress, fu_daemon_get_progress_emit_interval(self));
 		g_signal_connect(FU_PROGRESS(progress),
 				 "percentage-changed",
 				 G_CALLBACK(fu_daemon_progress_percentage_changed_cb),
@@ -2293,6 +2334,7 @@ fu_daemon_setup(FuDaemon *self, const gchar *socket_address, GError **error)
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	fu_progress_set_emit_interval(progress, fu_daemon_get_progress_emit_interval(self));
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 99, "load-engine");
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "load-introspection");
 #ifdef HAVE_POLKIT
@@ -9,6 +9,7 @@
 #include "config.h"
 
 #include <string.h>
+#include <time.h>
 
 #include "fu-device-list.h"
 #include "fu-device-private.h"
@@ -30,23 +31,58 @@
 static void
 fu_device_list_finalize(GObject *obj);
 
+typedef struct {
+	GHashTable *guids;	  /* guid:GPtrArray of FuDeviceItem */
+	GHashTable *physical_ids; /* physical-id:GPtrArray of FuDeviceItem */
+	GArray *ids;		  /* of FuDeviceListIdEntry, sorted by ID then order */
+} FuDeviceListIndex;
+
 struct _FuDeviceList {
 	GObject parent_instance;
 	GPtrArray *devices; /* of FuDeviceItem */
 	GRWLock devices_mutex;
+	/* lookup tables, only modified with devices_mutex held for writing */
+	FuDeviceListIndex index;
+	FuDeviceListIndex index_old;
+	guint item_order;
+	/* signalled when a device waiting for replug comes back */
+	GMutex replug_mutex;
+	GCond replug_cond;
+	guint replug_serial;
 };
 
+/* how often to re-check the flags when waiting from a worker thread, in ms */
+#define FU_DEVICE_LIST_REPLUG_POLL_INTERVAL 100
+
 enum { SIGNAL_ADDED, SIGNAL_REMOVED, SIGNAL_CHANGED, SIGNAL_LAST };
 
 static guint signals[SIGNAL_LAST] = {0};
 
+/* the values a device was indexed with, as the device may have changed since */
+typedef struct {
+	GPtrArray *guids; /* of lowercase GUID */
+	gchar *physical_id;
+	gchar *ids[2]; /* device-id, equivalent-id */
+} FuDeviceListKeys;
+
 typedef struct {
 	FuDevice *device;
 	FuDevice *device_old;
 	FuDeviceList *self; /* no ref */
 	guint remove_id;
+	gulong identity_id;
+	gulong identity_old_id;
+	guint order; /* increases as items are added, so matches the devices array */
+	FuDeviceListKeys *keys;
+	FuDeviceListKeys *keys_old;
 } FuDeviceItem;
 
+typedef struct {
+	gchar *id;
+	FuDeviceItem *item;
+	guint order; /* item order, then device-id before equivalent-id */
+} FuDeviceListIdEntry;
+
 G_DEFINE_TYPE(FuDeviceList, fu_device_list, G_TYPE_OBJECT)
 
 static void
@@ -223,6 +259,246 @@ fu_device_list_get_active(FuDeviceList *self)
 	return devices;
 }
 
+static void
+fu_device_list_id_entry_clear(FuDeviceListIdEntry *entry)
+{
+	g_free(entry->id);
+}
+
+static gint
+fu_device_list_id_entry_cmp(const FuDeviceListIdEntry *entry, const gchar *id, guint order)
+{
+	gint rc = strcmp(entry->id, id);
+	if (rc != 0)
+		return rc;
+	if (entry->order < order)
+		return -1;
+	if (entry->order > order)
+		return 1;
+	return 0;
+}
+
+/* returns the position of the first entry that does not sort before @id and @order */
+static guint
+fu_device_list_index_ids_bsearch(GArray *ids, const gchar *id, guint order)
+{
+	guint lo = 0;
+	guint hi = ids->len;
+	while (lo < hi) {
+		guint mid = lo + (hi - lo) / 2;
+		FuDeviceListIdEntry *entry = &g_array_index(ids, FuDeviceListIdEntry, mid);
+		if (fu_device_list_id_entry_cmp(entry, id, order) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/* convert to the form used as the GUID index key, matching fu_device_has_guid() */
+static gchar *
+fu_device_list_index_guid_key(const gchar *guid)
+{
+	if (!fwupd_guid_is_valid(guid))
+		return fwupd_guid_hash_string(guid);
+	return g_ascii_strdown(guid, -1);
+}
+
+static void
+fu_device_list_index_init(FuDeviceListIndex *index)
+{
+	index->guids = g_hash_table_new_full(g_str_hash,
+					     g_str_equal,
+					     g_free,
+					     (GDestroyNotify)g_ptr_array_unref);
+	index->physical_ids = g_hash_table_new_full(g_str_hash,
+						    g_str_equal,
+						    g_free,
+						    (GDestroyNotify)g_ptr_array_unref);
+	index->ids = g_array_new(FALSE, FALSE, sizeof(FuDeviceListIdEntry));
+	g_array_set_clear_func(index->ids, (GDestroyNotify)fu_device_list_id_entry_clear);
+}
+
+static void
+fu_device_list_index_clear(FuDeviceListIndex *index)
+{
+	g_hash_table_unref(index->guids);
+	g_hash_table_unref(index->physical_ids);
+	g_array_unref(index->ids);
+}
+
+static FuDeviceListKeys *
+fu_device_list_keys_new(FuDevice *device)
+{
+	FuDeviceListKeys *keys = g_new0(FuDeviceListKeys, 1);
+	GPtrArray *guids = fu_device_get_guids(device);
+
+	keys->guids = g_ptr_array_new_with_free_func(g_free);
+	for (guint i = 0; i < guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(guids, i);
+		if (!fwupd_guid_is_valid(guid))
+			continue;
+		g_ptr_array_add(keys->guids, g_ascii_strdown(guid, -1));
+	}
+	keys->physical_id = g_strdup(fu_device_get_physical_id(device));
+	keys->ids[0] = g_strdup(fu_device_get_id(device));
+	keys->ids[1] = g_strdup(fu_device_get_equivalent_id(device));
+	return keys;
+}
+
+static void
+fu_device_list_keys_free(FuDeviceListKeys *keys)
+{
+	g_ptr_array_unref(keys->guids);
+	g_free(keys->physical_id);
+	g_free(keys->ids[0]);
+	g_free(keys->ids[1]);
+	g_free(keys);
+}
+
+static void
+fu_device_list_index_table_insert(GHashTable *hash, const gchar *key, FuDeviceItem *item)
+{
+	GPtrArray *items = g_hash_table_lookup(hash, key);
+	if (items == NULL) {
+		items = g_ptr_array_new();
+		g_hash_table_insert(hash, g_strdup(key), items);
+	}
+	for (guint i = 0; i < items->len; i++) {
+		if (g_ptr_array_index(items, i) == item)
+			return;
+	}
+	g_ptr_array_add(items, item);
+}
+
+static void
+fu_device_list_index_table_remove(GHashTable *hash, const gchar *key, FuDeviceItem *item)
+{
+	GPtrArray *items = g_hash_table_lookup(hash, key);
+	if (items == NULL)
+		return;
+	g_ptr_array_remove(items, item);
+	if (items->len == 0)
+		g_hash_table_remove(hash, key);
+}
+
+static void
+fu_device_list_index_insert(FuDeviceListIndex *index, FuDeviceItem *item, FuDeviceListKeys *keys)
+{
+	for (guint i = 0; i < keys->guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(keys->guids, i);
+		fu_device_list_index_table_insert(index->guids, guid, item);
+	}
+	if (keys->physical_id != NULL)
+		fu_device_list_index_table_insert(index->physical_ids, keys->physical_id, item);
+	for (guint j = 0; j < G_N_ELEMENTS(keys->ids); j++) {
+		FuDeviceListIdEntry entry = {
+		    .item = item,
+		    .order = (item->order * 2) + j,
+		};
+		guint idx;
+		if (keys->ids[j] == NULL)
+			continue;
+		entry.id = g_strdup(keys->ids[j]);
+		idx = fu_device_list_index_ids_bsearch(index->ids, entry.id, entry.order);
+		g_array_insert_val(index->ids, idx, entry);
+	}
+}
+
+static void
+fu_device_list_index_remove(FuDeviceListIndex *index, FuDeviceItem *item, FuDeviceListKeys *keys)
+{
+	for (guint i = 0; i < keys->guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(keys->guids, i);
+		fu_device_list_index_table_remove(index->guids, guid, item);
+	}
+	if (keys->physical_id != NULL)
+		fu_device_list_index_table_remove(index->physical_ids, keys->physical_id, item);
+	for (guint j = 0; j < G_N_ELEMENTS(keys->ids); j++) {
+		FuDeviceListIdEntry *entry;
+		guint order = (item->order * 2) + j;
+		guint idx;
+		if (keys->ids[j] == NULL)
+			continue;
+		idx = fu_device_list_index_ids_bsearch(index->ids, keys->ids[j], order);
+		if (idx >= index->ids->len)
+			continue;
+		entry = &g_array_index(index->ids, FuDeviceListIdEntry, idx);
+		if (fu_device_list_id_entry_cmp(entry, keys->ids[j], order) == 0)
+			g_array_remove_index(index->ids, idx);
+	}
+}
+
+/* must be called with devices_mutex held for writing */
+static void
+fu_device_list_item_unindex(FuDeviceItem *item)
+{
+	FuDeviceList *self = item->self;
+	if (item->keys != NULL) {
+		fu_device_list_index_remove(&self->index, item, item->keys);
+		g_clear_pointer(&item->keys, fu_device_list_keys_free);
+	}
+	if (item->keys_old != NULL) {
+		fu_device_list_index_remove(&self->index_old, item, item->keys_old);
+		g_clear_pointer(&item->keys_old, fu_device_list_keys_free);
+	}
+}
+
+/* must be called with devices_mutex held for writing */
+static void
+fu_device_list_item_index(FuDeviceItem *item)
+{
+	FuDeviceList *self = item->self;
+	fu_device_list_item_unindex(item);
+	if (item->device != NULL) {
+		item->keys = fu_device_list_keys_new(item->device);
+		fu_device_list_index_insert(&self->index, item, item->keys);
+	}
+	if (item->device_old != NULL) {
+		item->keys_old = fu_device_list_keys_new(item->device_old);
+		fu_device_list_index_insert(&self->index_old, item, item->keys_old);
+	}
+}
+
+/* the first item in the list wins */
+static FuDeviceItem *
+fu_device_list_index_find_first(GPtrArray *items)
+{
+	FuDeviceItem *item_best = NULL;
+	for (guint i = 0; items != NULL && i < items->len; i++) {
+		FuDeviceItem *item = g_ptr_array_index(items, i);
+		if (item_best == NULL || item->order < item_best->order)
+			item_best = item;
+	}
+	return item_best;
+}
+
+static FuDeviceItem *
+fu_device_list_index_find_by_id(GArray *index_ids,
+				const gchar *device_id,
+				gboolean *multiple_matches)
+{
+	FuDeviceListIdEntry *entry_best = NULL;
+	gsize device_id_len = strlen(device_id);
+
+	/* all IDs with the prefix are contiguous, and the last in the list wins */
+	for (guint i = fu_device_list_index_ids_bsearch(index_ids, device_id, 0);
+	     i < index_ids->len;
+	     i++) {
+		FuDeviceListIdEntry *entry = &g_array_index(index_ids, FuDeviceListIdEntry, i);
+		if (strncmp(entry->id, device_id, device_id_len) != 0)
+			break;
+		if (entry_best != NULL) {
+			if (multiple_matches != NULL)
+				*multiple_matches = TRUE;
+			if (entry->order < entry_best->order)
+				continue;
+		}
+		entry_best = entry;
+	}
+	return entry_best != NULL ? entry_best->item : NULL;
+}
+
 static FuDeviceItem *
 fu_device_list_find_by_device(FuDeviceList *self, FuDevice *device)
 {
@@ -244,21 +520,18 @@ fu_device_list_find_by_device(FuDeviceList *self, FuDevice *device)
 static FuDeviceItem *
 fu_device_list_find_by_guid(FuDeviceList *self, const gchar *guid)
 {
-	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
+	FuDeviceItem *item;
+	g_autofree gchar *key = fu_device_list_index_guid_key(guid);
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
+
+	if (key == NULL)
+		return NULL;
+	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (fu_device_has_guid(item->device, guid))
-			return item;
-	}
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (item->device_old == NULL)
-			continue;
-		if (fu_device_has_guid(item->device_old, guid))
-			return item;
-	}
-	return NULL;
+	item = fu_device_list_index_find_first(g_hash_table_lookup(self->index.guids, key));
+	if (item != NULL)
+		return item;
+	return fu_device_list_index_find_first(g_hash_table_lookup(self->index_old.guids, key));
 }
 
 static FuDeviceItem *
@@ -266,35 +539,40 @@ fu_device_list_find_by_connection(FuDeviceList *self,
 				  const gchar *physical_id,
 				  const gchar *logical_id)
 {
+	FuDeviceItem *item = NULL;
+	GPtrArray *items;
 	g_autoptr(GRWLockReaderLocker) locker = NULL;
+
 	if (physical_id == NULL)
 		return NULL;
 	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		FuDevice *device = item_tmp->device;
-		if (device != NULL &&
-		    g_strcmp0(fu_device_get_physical_id(device), physical_id) == 0 &&
-		    g_strcmp0(fu_device_get_logical_id(device), logical_id) == 0)
-			return item_tmp;
+	items = g_hash_table_lookup(self->index.physical_ids, physical_id);
+	for (guint i = 0; items != NULL && i < items->len; i++) {
+		FuDeviceItem *item_tmp = g_ptr_array_index(items, i);
+		if (item != NULL && item->order < item_tmp->order)
+			continue;
+		if (g_strcmp0(fu_device_get_logical_id(item_tmp->device), logical_id) == 0)
+			item = item_tmp;
 	}
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		FuDevice *device = item_tmp->device_old;
-		if (device != NULL &&
-		    g_strcmp0(fu_device_get_physical_id(device), physical_id) == 0 &&
-		    g_strcmp0(fu_device_get_logical_id(device), logical_id) == 0)
-			return item_tmp;
+	if (item != NULL)
+		return item;
+	items = g_hash_table_lookup(self->index_old.physical_ids, physical_id);
+	for (guint i = 0; items != NULL && i < items->len; i++) {
+		FuDeviceItem *item_tmp = g_ptr_array_index(items, i);
+		if (item != NULL && item->order < item_tmp->order)
+			continue;
+		if (g_strcmp0(fu_device_get_logical_id(item_tmp->device_old), logical_id) == 0)
+			item = item_tmp;
 	}
-	return NULL;
+	return item;
 }
 
 static FuDeviceItem *
 fu_device_list_find_by_id(FuDeviceList *self, const gchar *device_id, gboolean *multiple_matches)
 {
-	FuDeviceItem *item = NULL;
-	gsize device_id_len;
+	FuDeviceItem *item;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
 
 	/* sanity check */
 	if (device_id == NULL) {
@@ -303,44 +581,14 @@ fu_device_list_find_by_id(FuDeviceList *self, const gchar *device_id, gboolean *
 	}
 
 	/* support abbreviated hashes */
-	device_id_len = strlen(device_id);
-	g_rw_lock_reader_lock(&self->devices_mutex);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		const gchar *ids[] = {fu_device_get_id(item_tmp->device),
-				      fu_device_get_equivalent_id(item_tmp->device),
-				      NULL};
-		for (guint j = 0; ids[j] != NULL; j++) {
-			if (strncmp(ids[j], device_id, device_id_len) == 0) {
-				if (item != NULL && multiple_matches != NULL)
-					*multiple_matches = TRUE;
-				item = item_tmp;
-			}
-		}
-	}
-	g_rw_lock_reader_unlock(&self->devices_mutex);
+	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
+	g_return_val_if_fail(locker != NULL, NULL);
+	item = fu_device_list_index_find_by_id(self->index.ids, device_id, multiple_matches);
 	if (item != NULL)
 		return item;
 
 	/* only search old devices if we didn't find the active device */
-	g_rw_lock_reader_lock(&self->devices_mutex);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		const gchar *ids[3] = {NULL};
-		if (item_tmp->device_old == NULL)
-			continue;
-		ids[0] = fu_device_get_id(item_tmp->device_old);
-		ids[1] = fu_device_get_equivalent_id(item_tmp->device_old);
-		for (guint j = 0; ids[j] != NULL; j++) {
-			if (strncmp(ids[j], device_id, device_id_len) == 0) {
-				if (item != NULL && multiple_matches != NULL)
-					*multiple_matches = TRUE;
-				item = item_tmp;
-			}
-		}
-	}
-	g_rw_lock_reader_unlock(&self->devices_mutex);
-	return item;
+	return fu_device_list_index_find_by_id(self->index_old.ids, device_id, multiple_matches);
 }
 
 /**
@@ -557,24 +805,73 @@ fu_device_list_item_finalized_cb(gpointer data, GObject *where_the_object_was)
 	g_critical("FuDevice %p was finalized without being removed from "
 		   "FuDeviceList, removing item!",
 		   where_the_object_was);
+	item->identity_id = 0; /* already destroyed */
 	g_rw_lock_writer_lock(&self->devices_mutex);
 	g_ptr_array_remove(self->devices, item);
 	g_rw_lock_writer_unlock(&self->devices_mutex);
 }
 
+static void
+fu_device_list_device_identity_changed_cb(FuDevice *device, gpointer user_data)
+{
+	FuDeviceItem *item = (FuDeviceItem *)user_data;
+	FuDeviceList *self = FU_DEVICE_LIST(item->self);
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->devices_mutex);
+	fu_device_list_item_index(item);
+}
+
+/* called with the writer lock held, and the caller must update the index */
+static void
+fu_device_list_item_set_device_old(FuDeviceItem *item, FuDevice *device)
+{
+	if (item->identity_old_id != 0) {
+		g_signal_handler_disconnect(item->device_old, item->identity_old_id);
+		item->identity_old_id = 0;
+	}
+	if (device != NULL) {
+		item->identity_old_id =
+		    g_signal_connect(FU_DEVICE(device),
+				     "identity-changed",
+				     G_CALLBACK(fu_device_list_device_identity_changed_cb),
+				     item);
+	}
+	g_set_object(&item->device_old, device);
+}
+
 /* this should never be required, and yet here we are */
 static void
 fu_device_list_item_set_device(FuDeviceItem *item, FuDevice *device)
 {
+	if (item->identity_id != 0) {
+		g_signal_handler_disconnect(item->device, item->identity_id);
+		item->identity_id = 0;
+	}
 	if (item->device != NULL) {
 		g_object_weak_unref(G_OBJECT(item->device), fu_device_list_item_finalized_cb, item);
 	}
 	if (device != NULL) {
 		g_object_weak_ref(G_OBJECT(device), fu_device_list_item_finalized_cb, item);
+		item->identity_id =
+		    g_signal_connect(FU_DEVICE(device),
+				     "identity-changed",
+				     G_CALLBACK(fu_device_list_device_identity_changed_cb),
+				     item);
 	}
 	g_set_object(&item->device, device);
 }
 
+/* optionally moves the current device to be the old device */
+static void
+fu_device_list_item_swap_device(FuDeviceItem *item, FuDevice *device, gboolean keep_old)
+{
+	FuDeviceList *self = FU_DEVICE_LIST(item->self);
+	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->devices_mutex);
+	if (keep_old)
+		fu_device_list_item_set_device_old(item, item->device);
+	fu_device_list_item_set_device(item, device);
+	fu_device_list_item_index(item);
+}
+
 static void
 fu_device_list_clear_wait_for_replug(FuDeviceList *self, FuDeviceItem *item)
 {
@@ -603,6 +900,13 @@ fu_device_list_clear_wait_for_replug(FuDeviceList *self, FuDeviceItem *item)
 		g_autofree gchar *str = fu_device_list_to_string(self);
 		g_debug("\n%s", str);
 	}
+
+	/* wake up anything in fu_device_list_wait_for_replug() */
+	g_mutex_lock(&self->replug_mutex);
+	self->replug_serial++;
+	g_cond_broadcast(&self->replug_cond);
+	g_mutex_unlock(&self->replug_mutex);
+	g_main_context_wakeup(NULL);
 }
 
 static void
@@ -693,9 +997,12 @@ fu_device_list_replace(FuDeviceList *self, FuDeviceItem *item, FuDevice *device)
 	/* copy the update state if known */
 	fu_device_incorporate_update_state(item->device, device);
 
+	/* keep the I/O statistics from before the replug */
+	if (item->device != device)
+		fu_device_incorporate_io_stats(device, item->device);
+
 	/* assign the new device */
-	g_set_object(&item->device_old, item->device);
-	fu_device_list_item_set_device(item, device);
+	fu_device_list_item_swap_device(item, device, TRUE);
 	fu_device_list_emit_device_changed(self, device);
 	if (g_getenv("FWUPD_DEVICE_LIST_VERBOSE") != NULL) {
 		g_autofree gchar *str = fu_device_list_to_string(self);
@@ -745,7 +1052,7 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 			if (device != item->device) {
 				fu_device_uninhibit(item->device, "unconnected");
 				fu_device_incorporate_update_state(device, item->device);
-				fu_device_list_item_set_device(item, device);
+				fu_device_list_item_swap_device(item, device, FALSE);
 			}
 			fu_device_list_clear_wait_for_replug(self, item);
 			fu_device_list_emit_device_changed(self, device);
@@ -758,8 +1065,7 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 			g_debug("found old device %s, swapping", fu_device_get_id(device));
 			fu_device_uninhibit(item->device, "unconnected");
 			fu_device_incorporate_update_state(device, item->device);
-			g_set_object(&item->device_old, item->device);
-			fu_device_list_item_set_device(item, device);
+			fu_device_list_item_swap_device(item, device, TRUE);
 			fu_device_list_clear_wait_for_replug(self, item);
 			fu_device_list_emit_device_changed(self, device);
 			return;
@@ -810,9 +1116,11 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 	/* add helper */
 	item = g_new0(FuDeviceItem, 1);
 	item->self = self; /* no ref */
-	fu_device_list_item_set_device(item, device);
 	g_rw_lock_writer_lock(&self->devices_mutex);
+	item->order = self->item_order++;
+	fu_device_list_item_set_device(item, device);
 	g_ptr_array_add(self->devices, item);
+	fu_device_list_item_index(item);
 	g_rw_lock_writer_unlock(&self->devices_mutex);
 	fu_device_list_emit_device_added(self, device);
 }
@@ -843,44 +1151,76 @@ fu_device_list_get_by_guid(FuDeviceList *self, const gchar *guid, GError **error
 	return NULL;
 }
 
+/* the IDs of the root device, and of the root of any proxy */
+static GPtrArray *
+fu_device_list_get_root_ids(FuDevice *device)
+{
+	FuDevice *proxy = fu_device_get_proxy(device);
+	GPtrArray *root_ids = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(FuDevice) root = fu_device_get_root(device);
+
+	g_ptr_array_add(root_ids, g_strdup(fu_device_get_id(root)));
+	if (proxy != NULL) {
+		g_autoptr(FuDevice) proxy_root = fu_device_get_root(proxy);
+		g_ptr_array_add(root_ids, g_strdup(fu_device_get_id(proxy_root)));
+	}
+	return root_ids;
+}
+
+static gboolean
+fu_device_list_device_has_root_ids(FuDevice *device, GPtrArray *root_ids)
+{
+	g_autoptr(GPtrArray) root_ids_tmp = fu_device_list_get_root_ids(device);
+	for (guint i = 0; i < root_ids_tmp->len; i++) {
+		const gchar *root_id_tmp = g_ptr_array_index(root_ids_tmp, i);
+		for (guint j = 0; j < root_ids->len; j++) {
+			const gchar *root_id = g_ptr_array_index(root_ids, j);
+			if (g_strcmp0(root_id_tmp, root_id) == 0)
+				return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/* only devices sharing one of @root_ids are returned, unless %NULL */
 static GPtrArray *
-fu_device_list_get_wait_for_replug(FuDeviceList *self)
+fu_device_list_get_wait_for_replug(FuDeviceList *self, GPtrArray *root_ids)
 {
 	GPtrArray *devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_rw_lock_reader_lock(&self->devices_mutex);
 	for (guint i = 0; i < self->devices->len; i++) {
 		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		if (fu_device_has_flag(item_tmp->device, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG))
-			g_ptr_array_add(devices, g_object_ref(item_tmp->device));
+		if (!fu_device_has_flag(item_tmp->device, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG))
+			continue;
+		if (root_ids != NULL &&
+		    !fu_device_list_device_has_root_ids(item_tmp->device, root_ids))
+			continue;
+		g_ptr_array_add(devices, g_object_ref(item_tmp->device));
 	}
+	g_rw_lock_reader_unlock(&self->devices_mutex);
 	return devices;
 }
 
-/**
- * fu_device_list_wait_for_replug:
- * @self: a device list
- * @error: (nullable): optional return location for an error
- *
- * Waits for all the devices with %FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG to replug.
- *
- * If the device does not exist this function returns without an error.
- *
- * Returns: %TRUE for success
- *
- * Since: 1.1.2
- **/
-gboolean
-fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
+static gboolean
+fu_device_list_wait_for_replug_timeout_cb(gpointer user_data)
+{
+	gboolean *timed_out = (gboolean *)user_data;
+	*timed_out = TRUE;
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean
+fu_device_list_wait_for_replug_full(FuDeviceList *self, GPtrArray *root_ids, GError **error)
 {
 	guint remove_delay = 0;
+	guint wakeups = 0;
+	clock_t cpu_start = clock();
 	g_autoptr(GTimer) timer = g_timer_new();
 	g_autoptr(GPtrArray) devices_wfr1 = NULL;
 	g_autoptr(GPtrArray) devices_wfr2 = NULL;
 
-	g_return_val_if_fail(FU_IS_DEVICE_LIST(self), FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
-
 	/* not required, or possibly literally just happened */
-	devices_wfr1 = fu_device_list_get_wait_for_replug(self);
+	devices_wfr1 = fu_device_list_get_wait_for_replug(self, root_ids);
 	if (devices_wfr1->len == 0) {
 		g_debug("no replug or re-enumerate required");
 		return TRUE;
@@ -904,17 +1244,61 @@ fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
 	}
 
 	/* time to unplug and then re-plug */
-	do {
-		g_autoptr(GPtrArray) devices_wfr_tmp = NULL;
-		g_usleep(1000);
-		g_main_context_iteration(NULL, FALSE);
-		devices_wfr_tmp = fu_device_list_get_wait_for_replug(self);
-		if (devices_wfr_tmp->len == 0)
-			break;
-	} while (g_timer_elapsed(timer, NULL) * 1000.f < remove_delay);
+	if (g_main_context_acquire(NULL)) {
+		gboolean timed_out = FALSE;
+		guint timeout_id = g_timeout_add(remove_delay,
+						 fu_device_list_wait_for_replug_timeout_cb,
+						 &timed_out);
+
+		/* block until the udev event (or the timeout) is dispatched */
+		while (!timed_out) {
+			g_autoptr(GPtrArray) devices_wfr_tmp = NULL;
+			devices_wfr_tmp = fu_device_list_get_wait_for_replug(self, root_ids);
+			if (devices_wfr_tmp->len == 0)
+				break;
+			g_main_context_iteration(NULL, TRUE);
+			wakeups++;
+		}
+		if (!timed_out)
+			g_source_remove(timeout_id);
+		g_main_context_release(NULL);
+	} else {
+		gint64 end_time = g_get_monotonic_time() + (gint64)remove_delay * 1000;
+
+		/* another thread is dispatching events, so wait to be signalled */
+		while (g_get_monotonic_time() < end_time) {
+			guint replug_serial;
+			g_autoptr(GPtrArray) devices_wfr_tmp = NULL;
+
+			g_mutex_lock(&self->replug_mutex);
+			replug_serial = self->replug_serial;
+			g_mutex_unlock(&self->replug_mutex);
+			devices_wfr_tmp = fu_device_list_get_wait_for_replug(self, root_ids);
+			if (devices_wfr_tmp->len == 0)
+				break;
+
+			/* also wake periodically in case the plugin cleared the flag itself */
+			g_mutex_lock(&self->replug_mutex);
+			while (replug_serial == self->replug_serial) {
+				gint64 wake_time = g_get_monotonic_time() +
+						   FU_DEVICE_LIST_REPLUG_POLL_INTERVAL * 1000;
+				wake_time = MIN(wake_time, end_time);
+				if (!g_cond_wait_until(&self->replug_cond,
+						       &self->replug_mutex,
+						       wake_time))
+					break;
+			}
+			g_mutex_unlock(&self->replug_mutex);
+			wakeups++;
+		}
+	}
+	g_debug("waited %.0fms for replug with %u wakeups using %.1fms of CPU time",
+		g_timer_elapsed(timer, NULL) * 1000.f,
+		wakeups,
+		(gdouble)(clock() - cpu_start) * 1000.f / CLOCKS_PER_SEC);
 
 	/* check that no other devices are still waiting for replug */
-	devices_wfr2 = fu_device_list_get_wait_for_replug(self);
+	devices_wfr2 = fu_device_list_get_wait_for_replug(self, root_ids);
 	if (devices_wfr2->len > 0) {
 		g_autoptr(GPtrArray) device_ids = g_ptr_array_new_with_free_func(g_free);
 		g_autofree gchar *device_ids_str = NULL;
@@ -945,6 +1329,54 @@ fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
 	return TRUE;
 }
 
+/**
+ * fu_device_list_wait_for_replug:
+ * @self: a device list
+ * @error: (nullable): optional return location for an error
+ *
+ * Waits for all the devices with %FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG to replug.
+ *
+ * If the device does not exist this function returns without an error.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.1.2
+ **/
+gboolean
+fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
+{
+	g_return_val_if_fail(FU_IS_DEVICE_LIST(self), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fu_device_list_wait_for_replug_full(self, NULL, error);
+}
+
+/**
+ * fu_device_list_wait_for_replug_device:
+ * @self: a device list
+ * @device: a device
+ * @error: (nullable): optional return location for an error
+ *
+ * Waits for @device, and any other device sharing the same root or proxy device, to replug
+ * if %FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG is set. Other devices waiting to replug are ignored,
+ * and are not failed if @device does not come back.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_device_list_wait_for_replug_device(FuDeviceList *self, FuDevice *device, GError **error)
+{
+	g_autoptr(GPtrArray) root_ids = NULL;
+
+	g_return_val_if_fail(FU_IS_DEVICE_LIST(self), FALSE);
+	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	root_ids = fu_device_list_get_root_ids(device);
+	return fu_device_list_wait_for_replug_full(self, root_ids, error);
+}
+
 /**
  * fu_device_list_get_by_id:
  * @self: a device list
@@ -998,8 +1430,8 @@ fu_device_list_item_free(FuDeviceItem *item)
 {
 	if (item->remove_id != 0)
 		g_source_remove(item->remove_id);
-	if (item->device_old != NULL)
-		g_object_unref(item->device_old);
+	fu_device_list_item_unindex(item);
+	fu_device_list_item_set_device_old(item, NULL);
 	fu_device_list_item_set_device(item, NULL);
 	g_free(item);
 }
@@ -1068,6 +1500,10 @@ fu_device_list_init(FuDeviceList *self)
 {
 	self->devices = g_ptr_array_new_with_free_func((GDestroyNotify)fu_device_list_item_free);
 	g_rw_lock_init(&self->devices_mutex);
+	g_mutex_init(&self->replug_mutex);
+	g_cond_init(&self->replug_cond);
+	fu_device_list_index_init(&self->index);
+	fu_device_list_index_init(&self->index_old);
 }
 
 static void
@@ -1077,6 +1513,10 @@ fu_device_list_finalize(GObject *obj)
 
 	g_rw_lock_clear(&self->devices_mutex);
 	g_ptr_array_unref(self->devices);
+	g_mutex_clear(&self->replug_mutex);
+	g_cond_clear(&self->replug_cond);
+	fu_device_list_index_clear(&self->index);
+	fu_device_list_index_clear(&self->index_old);
 
 	G_OBJECT_CLASS(fu_device_list_parent_class)->finalize(obj);
 }
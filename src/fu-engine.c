@@ -9,12 +9,14 @@
 #include "config.h"
 
 #include <fcntl.h>
+#include <glib/gstdio.h>
 
 #ifdef HAVE_GIO_UNIX
 #include <gio/gunixinputstream.h>
 #endif
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #ifdef HAVE_UTSNAME_H
 #include <sys/utsname.h>
 #endif
@@ -59,6 +61,7 @@
 #include "fu-remote-list.h"
 #include "fu-security-attr-common.h"
 #include "fu-security-attrs-private.h"
+#include "fu-trace-private.h"
 #include "fu-udev-device-private.h"
 #include "fu-version.h"
 
@@ -85,6 +88,12 @@ static void
 fu_engine_finalize(GObject *obj);
 static void
 fu_engine_ensure_security_attrs(FuEngine *self);
+static void
+fu_engine_plugin_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data);
+static void
+fu_engine_plugin_device_removed_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data);
+static void
+fu_engine_plugin_device_register_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data);
 
 struct _FuEngine {
 	GObject parent_instance;
@@ -99,8 +108,7 @@ struct _FuEngine {
 	guint percentage;
 	FuHistory *history;
 	FuIdle *idle;
-	XbSilo *silo;
-	XbQuery *query_component_by_guid;
+	GPtrArray *silos; /* (element-type XbSilo) */
 	guint coldplug_id;
 	FuPluginList *plugin_list;
 	GPtrArray *plugin_filter;
@@ -115,9 +123,13 @@ struct _FuEngine {
 	gchar *host_security_id;
 	FuSecurityAttrs *host_security_attrs;
 	GPtrArray *local_monitors; /* (element-type GFileMonitor) */
+	GPtrArray *plugin_events; /* (nullable) (element-type FuEnginePluginEvent) */
+	GMutex plugin_events_mutex;
 	GMainLoop *acquiesce_loop;
 	guint acquiesce_id;
 	guint acquiesce_delay;
+	gboolean install_concurrent;
+	guint install_acquiesce_delay;
 };
 
 enum {
@@ -414,11 +426,32 @@ fu_engine_wait_for_acquiesce(FuEngine *self, guint acquiesce_delay)
 {
 	if (acquiesce_delay == 0)
 		return;
+
+	/* wait once when all the concurrent installs have finished */
+	if (self->install_concurrent) {
+		self->install_acquiesce_delay = MAX(self->install_acquiesce_delay, acquiesce_delay);
+		return;
+	}
+
 	self->acquiesce_delay = acquiesce_delay;
 	self->acquiesce_id = g_timeout_add(acquiesce_delay, fu_engine_acquiesce_timeout_cb, self);
 	g_main_loop_run(self->acquiesce_loop);
 }
 
+/* when installing concurrently, only wait for the devices being written by this pipeline */
+static gboolean
+fu_engine_wait_for_replug(FuEngine *self, const gchar *device_id, GError **error)
+{
+	g_autoptr(FuDevice) device = NULL;
+
+	if (!self->install_concurrent)
+		return fu_device_list_wait_for_replug(self->device_list, error);
+	device = fu_device_list_get_by_id(self->device_list, device_id, NULL);
+	if (device == NULL)
+		return TRUE;
+	return fu_device_list_wait_for_replug_device(self->device_list, device, error);
+}
+
 static void
 fu_engine_device_added_cb(FuDeviceList *device_list, FuDevice *device, FuEngine *self)
 {
@@ -475,21 +508,19 @@ fu_engine_request_get_localized_xpath(FuEngineRequest *request, const gchar *ele
 	return g_string_free(xpath, FALSE);
 }
 
-/* add any client-side BKC tags */
 static gboolean
-fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError **error)
+fu_engine_add_local_release_metadata_silo(FuEngine *self,
+					  XbSilo *silo,
+					  FuDevice *dev,
+					  FuRelease *release,
+					  GError **error)
 {
-	FuDevice *dev = fu_release_get_device(release);
 	GPtrArray *guids;
 	g_autoptr(XbQuery) query = NULL;
 	g_autoptr(GError) error_query = NULL;
 
-	/* no device matched */
-	if (dev == NULL)
-		return TRUE;
-
 	/* prepare query with bound GUID parameter */
-	query = xb_query_new_full(self->silo,
+	query = xb_query_new_full(silo,
 				  "local/components/component[@merge='append']/provides/"
 				  "firmware[text()=?]/../../releases/release[@version=?]/../../"
 				  "tags/tag",
@@ -519,7 +550,7 @@ fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError
 					   1,
 					   fu_release_get_version(release),
 					   NULL);
-		tags = xb_silo_query_with_context(self->silo, query, &context, &error_local);
+		tags = xb_silo_query_with_context(silo, query, &context, &error_local);
 #else
 		if (!xb_query_bind_str(query, 0, guid, error)) {
 			g_prefix_error(error, "failed to bind GUID: ");
@@ -529,7 +560,7 @@ fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError
 			g_prefix_error(error, "failed to bind version: ");
 			return FALSE;
 		}
-		tags = xb_silo_query_full(self->silo, query, &error_local);
+		tags = xb_silo_query_full(silo, query, &error_local);
 #endif
 		if (tags == NULL) {
 			if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
@@ -548,6 +579,27 @@ fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError
 	return TRUE;
 }
 
+/* add any client-side BKC tags */
+static gboolean
+fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError **error)
+{
+	FuDevice *dev = fu_release_get_device(release);
+
+	/* no device matched */
+	if (dev == NULL)
+		return TRUE;
+
+	/* the local metadata may be in any of the silos */
+	for (guint i = 0; i < self->silos->len; i++) {
+		XbSilo *silo = g_ptr_array_index(self->silos, i);
+		if (!fu_engine_add_local_release_metadata_silo(self, silo, dev, release, error))
+			return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
 static void
 fu_engine_release_remote_id_changed_cb(FuRelease *release, GParamSpec *pspec, FuEngine *self)
 {
@@ -603,15 +655,17 @@ static const gchar *
 fu_engine_get_remote_id_for_checksum(FuEngine *self, const gchar *csum)
 {
 	g_autofree gchar *xpath = NULL;
-	g_autoptr(XbNode) key = NULL;
 	xpath = g_strdup_printf("components/component[@type='firmware']/releases/release/"
 				"checksum[@target='container'][text()='%s']/../../"
 				"../../custom/value[@key='fwupd::RemoteId']",
 				csum);
-	key = xb_silo_query_first(self->silo, xpath, NULL);
-	if (key == NULL)
-		return NULL;
-	return xb_node_get_text(key);
+	for (guint i = 0; i < self->silos->len; i++) {
+		XbSilo *silo = g_ptr_array_index(self->silos, i);
+		g_autoptr(XbNode) key = xb_silo_query_first(silo, xpath, NULL);
+		if (key != NULL)
+			return xb_node_get_text(key);
+	}
+	return NULL;
 }
 
 /**
@@ -1132,43 +1186,160 @@ fu_engine_verify_update(FuEngine *self,
 	return TRUE;
 }
 
+/* has the same lifecycle as the silo, see fu_engine_create_silo_index() */
+typedef struct {
+	GPtrArray *components; /* element-type XbNode, in document order */
+	GHashTable *guids;     /* fwupd_guid_t : GArray of guint component index */
+} FuEngineSiloIndex;
+
+static guint
+fu_engine_guid_hash(gconstpointer key)
+{
+	const guint8 *buf = (const guint8 *)key;
+	guint32 hash = 0;
+
+	/* the GUID is either random or a SHA-1 hash, so just fold it */
+	for (guint i = 0; i < sizeof(fwupd_guid_t); i += sizeof(guint32)) {
+		guint32 tmp;
+		memcpy(&tmp, buf + i, sizeof(tmp));
+		hash ^= tmp;
+	}
+	return hash;
+}
+
+static gboolean
+fu_engine_guid_equal(gconstpointer a, gconstpointer b)
+{
+	return memcmp(a, b, sizeof(fwupd_guid_t)) == 0;
+}
+
+static void
+fu_engine_silo_index_free(FuEngineSiloIndex *silo_index)
+{
+	g_ptr_array_unref(silo_index->components);
+	g_hash_table_unref(silo_index->guids);
+	g_free(silo_index);
+}
+
+static void
+fu_engine_silo_index_add_guid(FuEngineSiloIndex *silo_index, const gchar *guid, guint idx)
+{
+	fwupd_guid_t guid_bin = {0x0};
+	GArray *idxs;
+
+	/* ignore anything that is not a valid GUID, as no device can match it */
+	if (guid == NULL || !fwupd_guid_from_string(guid, &guid_bin, FWUPD_GUID_FLAG_NONE, NULL))
+		return;
+	idxs = g_hash_table_lookup(silo_index->guids, guid_bin);
+	if (idxs == NULL) {
+		guint8 *key = g_new(guint8, sizeof(fwupd_guid_t));
+		memcpy(key, guid_bin, sizeof(fwupd_guid_t));
+		idxs = g_array_new(FALSE, FALSE, sizeof(guint));
+		g_hash_table_insert(silo_index->guids, key, idxs);
+	}
+
+	/* a component may list the same GUID more than once */
+	if (idxs->len == 0 || g_array_index(idxs, guint, idxs->len - 1) != idx)
+		g_array_append_val(idxs, idx);
+}
+
+static FuEngineSiloIndex *
+fu_engine_silo_index_new(GPtrArray *components)
+{
+	FuEngineSiloIndex *silo_index = g_new0(FuEngineSiloIndex, 1);
+
+	silo_index->components = g_ptr_array_ref(components);
+	silo_index->guids = g_hash_table_new_full(fu_engine_guid_hash,
+						  fu_engine_guid_equal,
+						  g_free,
+						  (GDestroyNotify)g_array_unref);
+
+	/* walk the children directly rather than compiling a query for each component */
+	for (guint i = 0; i < components->len; i++) {
+		XbNode *component = g_ptr_array_index(components, i);
+		g_autoptr(XbNode) provides = NULL;
+		g_autoptr(XbNode) child = NULL;
+
+		provides = xb_node_get_child(component);
+		while (provides != NULL &&
+		       g_strcmp0(xb_node_get_element(provides), "provides") != 0) {
+			XbNode *next = xb_node_get_next(provides);
+			g_object_unref(provides);
+			provides = next;
+		}
+		if (provides == NULL)
+			continue;
+		child = xb_node_get_child(provides);
+		while (child != NULL) {
+			XbNode *next = xb_node_get_next(child);
+			if (g_strcmp0(xb_node_get_element(child), "firmware") == 0 &&
+			    g_strcmp0(xb_node_get_attr(child, "type"), "flashed") == 0) {
+				fu_engine_silo_index_add_guid(silo_index,
+							      xb_node_get_text(child),
+							      i);
+			}
+			g_object_unref(child);
+			child = next;
+		}
+	}
+	return silo_index;
+}
+
+/* returns the indexes of the components providing @guid, or %NULL */
+static GArray *
+fu_engine_silo_index_lookup(FuEngineSiloIndex *silo_index, const fwupd_guid_t *guid)
+{
+	return g_hash_table_lookup(silo_index->guids, guid);
+}
+
+static gint
+fu_engine_silo_index_sort_cb(gconstpointer a, gconstpointer b)
+{
+	guint idx_a = *((const guint *)a);
+	guint idx_b = *((const guint *)b);
+	if (idx_a < idx_b)
+		return -1;
+	if (idx_a > idx_b)
+		return 1;
+	return 0;
+}
+
 static XbNode *
-fu_engine_get_component_by_guid(FuEngine *self, const gchar *guid)
+fu_engine_get_component_by_guid_silo(FuEngine *self, XbSilo *silo, const gchar *guid)
 {
-	g_autoptr(GError) error_local = NULL;
-	g_autoptr(XbNode) component = NULL;
-#if LIBXMLB_CHECK_VERSION(0, 3, 0)
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
-#endif
+	FuEngineSiloIndex *silo_index = g_object_get_data(G_OBJECT(silo), "fwupd::SiloIndex");
+	XbNode *component;
+	fwupd_guid_t guid_bin = {0x0};
+	GArray *idxs;
 
 	/* no components in silo */
-	if (self->query_component_by_guid == NULL)
+	if (silo_index == NULL)
 		return NULL;
-
-#if LIBXMLB_CHECK_VERSION(0, 3, 0)
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	component = xb_silo_query_first_with_context(self->silo,
-						     self->query_component_by_guid,
-						     &context,
-						     &error_local);
-#else
-	if (!xb_query_bind_str(self->query_component_by_guid, 0, guid, &error_local)) {
-		g_warning("failed to bind 0: %s", error_local->message);
+	if (!fwupd_guid_from_string(guid, &guid_bin, FWUPD_GUID_FLAG_NONE, NULL))
 		return NULL;
-	}
-	component =
-	    xb_silo_query_first_full(self->silo, self->query_component_by_guid, &error_local);
-#endif
-	if (component == NULL) {
-		if (!g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
-		    !g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
-			g_warning("ignoring: %s", error_local->message);
+
+	/* the lowest index is the first in document order */
+	FU_TRACE2(silo_query_begin, "component-by-guid", guid);
+	idxs = fu_engine_silo_index_lookup(silo_index, &guid_bin);
+	FU_TRACE2(silo_query_end, "component-by-guid", idxs != NULL);
+	if (idxs == NULL)
 		return NULL;
-	}
+	component = g_ptr_array_index(silo_index->components, g_array_index(idxs, guint, 0));
 	return g_object_ref(component);
 }
 
+static XbNode *
+fu_engine_get_component_by_guid(FuEngine *self, const gchar *guid)
+{
+	for (guint i = 0; i < self->silos->len; i++) {
+		XbSilo *silo = g_ptr_array_index(self->silos, i);
+		XbNode *component = fu_engine_get_component_by_guid_silo(self, silo, guid);
+		if (component != NULL)
+			return component;
+	}
+	return NULL;
+}
+
 XbNode *
 fu_engine_get_component_by_guids(FuEngine *self, FuDevice *device)
 {
@@ -1224,14 +1395,17 @@ fu_engine_verify_from_local_metadata(FuEngine *self, FuDevice *device, GError **
 }
 
 static XbNode *
-fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError **error)
+fu_engine_verify_from_system_metadata_silo(FuEngine *self,
+					   XbSilo *silo,
+					   FuDevice *device,
+					   GError **error)
 {
 	FwupdVersionFormat fmt = fu_device_get_version_format(device);
 	GPtrArray *guids = fu_device_get_guids(device);
 	g_autoptr(XbQuery) query = NULL;
 
 	/* prepare query with bound GUID parameter */
-	query = xb_query_new_full(self->silo,
+	query = xb_query_new_full(silo,
 				  "components/component[@type='firmware']/"
 				  "provides/firmware[@type='flashed'][text()=?]/"
 				  "../../releases/release",
@@ -1252,14 +1426,17 @@ fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError *
 		/* bind GUID and then query */
 #if LIBXMLB_CHECK_VERSION(0, 3, 0)
 		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-		releases = xb_silo_query_with_context(self->silo, query, &context, &error_local);
+		FU_TRACE2(silo_query_begin, "releases-by-guid", guid);
+		releases = xb_silo_query_with_context(silo, query, &context, &error_local);
 #else
 		if (!xb_query_bind_str(query, 0, guid, error)) {
 			g_prefix_error(error, "failed to bind string: ");
 			return NULL;
 		}
-		releases = xb_silo_query_full(self->silo, query, &error_local);
+		FU_TRACE2(silo_query_begin, "releases-by-guid", guid);
+		releases = xb_silo_query_full(silo, query, &error_local);
 #endif
+		FU_TRACE2(silo_query_end, "releases-by-guid", releases != NULL);
 		if (releases == NULL) {
 			if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
 			    g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
@@ -1283,6 +1460,31 @@ fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError *
 	return NULL;
 }
 
+static XbNode *
+fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError **error)
+{
+	/* the release may be in any of the silos */
+	for (guint i = 0; i < self->silos->len; i++) {
+		XbSilo *silo = g_ptr_array_index(self->silos, i);
+		g_autoptr(GError) error_local = NULL;
+		XbNode *release;
+
+		release =
+		    fu_engine_verify_from_system_metadata_silo(self, silo, device, &error_local);
+		if (release != NULL)
+			return release;
+		if (!g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
+		    !g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return NULL;
+		}
+	}
+
+	/* not found */
+	g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "failed to find release");
+	return NULL;
+}
+
 /**
  * fu_engine_verify:
  * @self: a #FuEngine
@@ -2272,6 +2474,307 @@ fu_engine_sort_release_versions_cb(gconstpointer a, gconstpointer b)
 	return fu_version_compare(va, vb, fu_device_get_version_format(device));
 }
 
+typedef struct {
+	GPtrArray *releases;	/* (element-type FuRelease) */
+	GHashTable *device_ids; /* of root and proxy device IDs */
+	FuProgress *progress;
+	GError *error;	 /* (nullable) */
+	gdouble elapsed; /* s */
+	gpointer batch;	 /* no-ref */
+} FuEngineInstallHelper;
+
+static void
+fu_engine_install_helper_free(FuEngineInstallHelper *helper)
+{
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	if (helper->progress != NULL)
+		g_object_unref(helper->progress);
+	g_hash_table_unref(helper->device_ids);
+	g_ptr_array_unref(helper->releases);
+	g_free(helper);
+}
+
+static FuEngineInstallHelper *
+fu_engine_install_helper_new(gpointer batch)
+{
+	FuEngineInstallHelper *helper = g_new0(FuEngineInstallHelper, 1);
+	helper->batch = batch;
+	helper->releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	helper->device_ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	return helper;
+}
+
+typedef struct {
+	FuEngine *self;
+	GBytes *blob_cab;
+	FwupdInstallFlags flags;
+	GPtrArray *helpers; /* (element-type FuEngineInstallHelper) */
+	FuProgress *progress;
+	guint n_releases;
+	guint n_pending;
+} FuEngineInstallBatch;
+
+static void
+fu_engine_install_batch_free(FuEngineInstallBatch *batch)
+{
+	g_ptr_array_unref(batch->helpers);
+	g_free(batch);
+}
+
+static FuEngineInstallBatch *
+fu_engine_install_batch_new(FuEngine *self, GBytes *blob_cab, FwupdInstallFlags flags)
+{
+	FuEngineInstallBatch *batch = g_new0(FuEngineInstallBatch, 1);
+	batch->self = self;
+	batch->blob_cab = blob_cab;
+	batch->flags = flags;
+	batch->helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_install_helper_free);
+	return batch;
+}
+
+/* devices sharing a root device or a proxy cannot be written at the same time */
+static GPtrArray *
+fu_engine_install_release_get_device_ids(FuRelease *release)
+{
+	FuDevice *device = fu_release_get_device(release);
+	FuDevice *proxy = fu_device_get_proxy(device);
+	GPtrArray *device_ids = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(FuDevice) root = fu_device_get_root(device);
+
+	g_ptr_array_add(device_ids, g_strdup(fu_device_get_id(root)));
+	if (proxy != NULL) {
+		g_autoptr(FuDevice) proxy_root = fu_device_get_root(proxy);
+		g_ptr_array_add(device_ids, g_strdup(fu_device_get_id(proxy_root)));
+	}
+	return device_ids;
+}
+
+static void
+fu_engine_install_batch_add_release(FuEngineInstallBatch *batch, FuRelease *release)
+{
+	FuEngineInstallHelper *helper = NULL;
+	GHashTableIter iter;
+	gpointer key;
+	g_autoptr(GPtrArray) device_ids = fu_engine_install_release_get_device_ids(release);
+
+	/* merge every helper that shares a device with this release */
+	for (guint i = 0; i < batch->helpers->len; i++) {
+		FuEngineInstallHelper *helper_tmp = g_ptr_array_index(batch->helpers, i);
+		gboolean shared = FALSE;
+
+		for (guint j = 0; j < device_ids->len; j++) {
+			const gchar *device_id = g_ptr_array_index(device_ids, j);
+			if (g_hash_table_contains(helper_tmp->device_ids, device_id)) {
+				shared = TRUE;
+				break;
+			}
+		}
+		if (!shared)
+			continue;
+		if (helper == NULL) {
+			helper = helper_tmp;
+			continue;
+		}
+		for (guint j = 0; j < helper_tmp->releases->len; j++) {
+			FuRelease *release_tmp = g_ptr_array_index(helper_tmp->releases, j);
+			g_ptr_array_add(helper->releases, g_object_ref(release_tmp));
+		}
+		g_hash_table_iter_init(&iter, helper_tmp->device_ids);
+		while (g_hash_table_iter_next(&iter, &key, NULL))
+			g_hash_table_add(helper->device_ids, g_strdup(key));
+		g_ptr_array_remove_index(batch->helpers, i--);
+	}
+	if (helper == NULL) {
+		helper = fu_engine_install_helper_new(batch);
+		g_ptr_array_add(batch->helpers, helper);
+	}
+	for (guint j = 0; j < device_ids->len; j++) {
+		const gchar *device_id = g_ptr_array_index(device_ids, j);
+		g_hash_table_add(helper->device_ids, g_strdup(device_id));
+	}
+	g_ptr_array_add(helper->releases, g_object_ref(release));
+	g_ptr_array_sort(helper->releases, fu_engine_sort_release_versions_cb);
+	batch->n_releases++;
+}
+
+static void
+fu_engine_install_helper_run(FuEngineInstallHelper *helper)
+{
+	FuEngineInstallBatch *batch = (FuEngineInstallBatch *)helper->batch;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	for (guint i = 0; i < helper->releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(helper->releases, i);
+		if (!fu_engine_install_release(batch->self,
+					       release,
+					       batch->blob_cab,
+					       fu_progress_get_child(helper->progress),
+					       batch->flags,
+					       &helper->error))
+			break;
+		fu_progress_step_done(helper->progress);
+	}
+	helper->elapsed = g_timer_elapsed(timer, NULL);
+}
+
+static gboolean
+fu_engine_install_helper_idle_cb(gpointer user_data)
+{
+	FuEngineInstallHelper *helper = (FuEngineInstallHelper *)user_data;
+	FuEngineInstallBatch *batch = (FuEngineInstallBatch *)helper->batch;
+	fu_engine_install_helper_run(helper);
+	batch->n_pending--;
+	return G_SOURCE_REMOVE;
+}
+
+static void
+fu_engine_install_batch_percentage_changed_cb(FuProgress *progress,
+					      guint percentage,
+					      FuEngineInstallBatch *batch)
+{
+	guint64 total = 0;
+
+	for (guint i = 0; i < batch->helpers->len; i++) {
+		FuEngineInstallHelper *helper = g_ptr_array_index(batch->helpers, i);
+		total += (guint64)fu_progress_get_percentage(helper->progress) *
+			 helper->releases->len;
+	}
+	fu_progress_set_percentage(batch->progress, (guint)(total / batch->n_releases));
+}
+
+static void
+fu_engine_install_batch_status_changed_cb(FuProgress *progress,
+					  FwupdStatus status,
+					  FuEngineInstallBatch *batch)
+{
+	fu_progress_set_status(batch->progress, status);
+}
+
+static gboolean
+fu_engine_install_batch_run(FuEngineInstallBatch *batch, FuProgress *progress, GError **error)
+{
+	FuEngine *self = batch->self;
+	FuEngineInstallHelper *helper_failed = NULL;
+
+	/* each set of devices has its own progress, which is merged into the batch */
+	batch->progress = progress;
+	for (guint i = 0; i < batch->helpers->len; i++) {
+		FuEngineInstallHelper *helper = g_ptr_array_index(batch->helpers, i);
+		if (batch->helpers->len == 1) {
+			helper->progress = g_object_ref(progress);
+		} else {
+			helper->progress = fu_progress_new(G_STRLOC);
+			fu_progress_add_flag(helper->progress, FU_PROGRESS_FLAG_NO_PROFILE);
+			g_signal_connect(FU_PROGRESS(helper->progress),
+					 "percentage-changed",
+					 G_CALLBACK(fu_engine_install_batch_percentage_changed_cb),
+					 batch);
+			g_signal_connect(FU_PROGRESS(helper->progress),
+					 "status-changed",
+					 G_CALLBACK(fu_engine_install_batch_status_changed_cb),
+					 batch);
+		}
+		fu_progress_set_id(helper->progress, G_STRLOC);
+		fu_progress_set_steps(helper->progress, helper->releases->len);
+	}
+
+	/* nothing to do concurrently, already installing concurrently, or the main context is
+	 * in use by another thread */
+	if (batch->helpers->len == 1 || self->install_concurrent || !g_main_context_acquire(NULL)) {
+		for (guint i = 0; i < batch->helpers->len; i++) {
+			FuEngineInstallHelper *helper = g_ptr_array_index(batch->helpers, i);
+			fu_engine_install_helper_run(helper);
+			if (helper->error != NULL) {
+				g_propagate_error(error, g_steal_pointer(&helper->error));
+				return FALSE;
+			}
+		}
+		if (batch->helpers->len > 1)
+			fu_progress_set_percentage(progress, 100);
+		return TRUE;
+	}
+
+	/* every set of devices is installed from an idle source on this thread, and only the
+	 * firmware write is done in a worker -- while it is running the main context is iterated,
+	 * which dispatches the udev events and starts the next set of devices */
+	self->install_concurrent = TRUE;
+	self->install_acquiesce_delay = 0;
+	batch->n_pending = batch->helpers->len;
+	for (guint i = 0; i < batch->helpers->len; i++) {
+		FuEngineInstallHelper *helper = g_ptr_array_index(batch->helpers, i);
+		g_idle_add(fu_engine_install_helper_idle_cb, helper);
+	}
+	while (batch->n_pending > 0)
+		g_main_context_iteration(NULL, TRUE);
+	g_main_context_release(NULL);
+	self->install_concurrent = FALSE;
+
+	/* wait for the system to acquiesce once for all the devices */
+	fu_engine_wait_for_acquiesce(self, self->install_acquiesce_delay);
+
+	/* the first failure is returned, the others are only shown */
+	for (guint i = 0; i < batch->helpers->len; i++) {
+		FuEngineInstallHelper *helper = g_ptr_array_index(batch->helpers, i);
+		FuRelease *release = g_ptr_array_index(helper->releases, 0);
+		g_debug("installing %u release(s) on %s took %.0fms",
+			helper->releases->len,
+			fu_device_get_id(fu_release_get_device(release)),
+			helper->elapsed * 1000.f);
+		if (helper->error == NULL)
+			continue;
+		if (helper_failed == NULL) {
+			helper_failed = helper;
+			continue;
+		}
+		g_warning("failed to install on %s: %s",
+			  fu_device_get_id(fu_release_get_device(release)),
+			  helper->error->message);
+	}
+	if (helper_failed != NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper_failed->error));
+		return FALSE;
+	}
+	fu_progress_set_percentage(progress, 100);
+	return TRUE;
+}
+
+/* releases are grouped into batches of independent devices, where devices that have not opted
+ * into being installed concurrently are a batch on their own -- each batch is one weighted step */
+static GPtrArray *
+fu_engine_install_releases_get_batches(FuEngine *self,
+				       GPtrArray *releases,
+				       GBytes *blob_cab,
+				       FwupdInstallFlags flags)
+{
+	FuEngineInstallBatch *batch = NULL;
+	GPtrArray *batches =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_install_batch_free);
+
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		FuDevice *device = fu_release_get_device(release);
+		if (!fu_config_get_parallel_install(self->config) ||
+		    (flags & FWUPD_INSTALL_FLAG_OFFLINE) > 0 ||
+		    !fu_device_has_internal_flag(device,
+						 FU_DEVICE_INTERNAL_FLAG_CONCURRENT_INSTALL)) {
+			FuEngineInstallBatch *batch_tmp =
+			    fu_engine_install_batch_new(self, blob_cab, flags);
+			fu_engine_install_batch_add_release(batch_tmp, release);
+			g_ptr_array_add(batches, batch_tmp);
+			batch = NULL;
+			continue;
+		}
+		if (batch == NULL) {
+			batch = fu_engine_install_batch_new(self, blob_cab, flags);
+			g_ptr_array_add(batches, batch);
+		}
+		fu_engine_install_batch_add_release(batch, release);
+	}
+	return batches;
+}
+
 /**
  * fu_engine_install_releases:
  * @self: a #FuEngine
@@ -2299,6 +2802,7 @@ fu_engine_install_releases(FuEngine *self,
 			   GError **error)
 {
 	g_autoptr(FuIdleLocker) locker = NULL;
+	g_autoptr(GPtrArray) batches = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
 	g_autoptr(GPtrArray) devices_new = NULL;
 
@@ -2324,16 +2828,19 @@ fu_engine_install_releases(FuEngine *self,
 	}
 
 	/* all authenticated, so install all the things */
+	batches = fu_engine_install_releases_get_batches(self, releases, blob_cab, flags);
 	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, releases->len);
-	for (guint i = 0; i < releases->len; i++) {
-		FuRelease *release = g_ptr_array_index(releases, i);
-		if (!fu_engine_install_release(self,
-					       release,
-					       blob_cab,
-					       fu_progress_get_child(progress),
-					       flags,
-					       error)) {
+	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_NO_PROFILE);
+	for (guint i = 0; i < batches->len; i++) {
+		FuEngineInstallBatch *batch = g_ptr_array_index(batches, i);
+		fu_progress_add_step(progress,
+				     fu_progress_get_status(progress),
+				     batch->n_releases,
+				     NULL);
+	}
+	for (guint i = 0; i < batches->len; i++) {
+		FuEngineInstallBatch *batch = g_ptr_array_index(batches, i);
+		if (!fu_engine_install_batch_run(batch, fu_progress_get_child(progress), error)) {
 			g_autoptr(GError) error_local = NULL;
 			if (!fu_engine_composite_cleanup(self, devices, &error_local)) {
 				g_warning("failed to cleanup failed composite action: %s",
@@ -2627,6 +3134,23 @@ fu_engine_schedule_update(FuEngine *self,
 	return fu_engine_offline_setup(error);
 }
 
+/* kept out of the release metadata as that is uploaded in the history report */
+static gboolean
+fu_engine_save_io_stats(FuEngine *self, const gchar *device_id, GError **error)
+{
+	g_autoptr(FuDevice) device = NULL;
+	g_autoptr(GHashTable) io_stats = NULL;
+
+	/* the device may have been replaced during the update */
+	device = fu_device_list_get_by_id(self->device_list, device_id, NULL);
+	if (device == NULL)
+		return TRUE;
+	io_stats = fu_device_get_io_stats(device);
+	if (g_hash_table_size(io_stats) == 0)
+		return TRUE;
+	return fu_history_set_device_io_stats(self->history, device_id, io_stats, error);
+}
+
 /**
  * fu_engine_install_release:
  * @self: a #FuEngine
@@ -2753,6 +3277,11 @@ fu_engine_install_release(FuEngine *self,
 				    flags,
 				    feature_flags,
 				    &error_local)) {
+		if (self->write_history) {
+			g_autoptr(GError) error_stats = NULL;
+			if (!fu_engine_save_io_stats(self, fu_device_get_id(device), &error_stats))
+				g_warning("failed to save I/O stats: %s", error_stats->message);
+		}
 		if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_AC_POWER_REQUIRED) ||
 		    g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_BATTERY_LEVEL_TOO_LOW) ||
 		    g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NEEDS_USER_ACTION) ||
@@ -2775,6 +3304,12 @@ fu_engine_install_release(FuEngine *self,
 	}
 	g_set_object(&device, device_tmp);
 
+	/* save how the time was spent talking to the hardware */
+	if (self->write_history) {
+		if (!fu_engine_save_io_stats(self, fu_device_get_id(device), error))
+			return FALSE;
+	}
+
 	/* update state (which updates the database if required) */
 	if (fu_device_has_flag(device, FWUPD_DEVICE_FLAG_NEEDS_REBOOT) ||
 	    fu_device_has_flag(device, FWUPD_DEVICE_FLAG_NEEDS_SHUTDOWN)) {
@@ -2845,7 +3380,7 @@ fu_engine_get_device(FuEngine *self, const gchar *device_id, GError **error)
 	g_autoptr(FuDevice) device = NULL;
 
 	/* wait for any device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, device_id, error)) {
 		g_prefix_error(error, "failed to wait for detach replug: ");
 		return NULL;
 	}
@@ -2859,6 +3394,51 @@ fu_engine_get_device(FuEngine *self, const gchar *device_id, GError **error)
 	return g_steal_pointer(&device);
 }
 
+/**
+ * fu_engine_get_device_stats:
+ * @self: a #FuEngine
+ * @device_id: a device ID
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the I/O statistics for the device, either from the running device or
+ * from the history database if the daemon has been restarted since the update.
+ *
+ * Returns: (transfer container): operation kind to summary, or %NULL if not found
+ **/
+GHashTable *
+fu_engine_get_device_stats(FuEngine *self, const gchar *device_id, GError **error)
+{
+	g_autoptr(FuDevice) device = NULL;
+	g_autoptr(FuDevice) device_history = NULL;
+	g_autoptr(GHashTable) hash = NULL;
+
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	g_return_val_if_fail(device_id != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* recorded since the daemon was started */
+	device = fu_device_list_get_by_id(self->device_list, device_id, NULL);
+	if (device != NULL) {
+		hash = fu_device_get_io_stats(device);
+		if (g_hash_table_size(hash) > 0)
+			return g_steal_pointer(&hash);
+		device_id = fu_device_get_id(device);
+	}
+
+	/* saved with the last update */
+	device_history = fu_history_get_device_by_id(self->history, device_id, error);
+	if (device_history == NULL) {
+		g_prefix_error(error, "no I/O statistics: ");
+		return NULL;
+	}
+	hash = fu_history_get_device_io_stats(self->history, device_id, error);
+	if (hash == NULL) {
+		g_prefix_error(error, "no I/O statistics: ");
+		return NULL;
+	}
+	return g_steal_pointer(&hash);
+}
+
 /* same as FuDevice->prepare, but with the device open */
 static gboolean
 fu_engine_device_prepare(FuEngine *self,
@@ -2989,7 +3569,7 @@ fu_engine_prepare(FuEngine *self,
 	}
 
 	/* wait for device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, device_id, error)) {
 		g_prefix_error(error, "failed to wait for prepare replug: ");
 		return FALSE;
 	}
@@ -3025,7 +3605,7 @@ fu_engine_cleanup(FuEngine *self,
 	}
 
 	/* wait for device to disconnect and reconnect */
-	if (!fu_device_list_wait_for_replug(self->device_list, error)) {
+	if (!fu_engine_wait_for_replug(self, device_id, error)) {
 		g_prefix_error(error, "failed to wait for cleanup replug: ");
 		return FALSE;
 	}
@@ -3199,6 +3779,134 @@ fu_engine_reload(FuEngine *self, const gchar *device_id, GError **error)
 	return TRUE;
 }
 
+typedef struct {
+	FuPlugin *plugin;
+	FuDevice *device;
+	GBytes *blob_fw;
+	FuProgress *progress;	    /* used by the main thread */
+	FuProgress *progress_write; /* used by the worker */
+	FwupdInstallFlags flags;
+	GError *error;
+	gboolean ret;
+	gint done;
+	gint percentage;
+	gint status;
+} FuEngineWriteHelper;
+
+static void
+fu_engine_write_helper_percentage_changed_cb(FuProgress *progress,
+					     guint percentage,
+					     FuEngineWriteHelper *helper)
+{
+	g_atomic_int_set(&helper->percentage, (gint)percentage);
+}
+
+static void
+fu_engine_write_helper_status_changed_cb(FuProgress *progress,
+					 FwupdStatus status,
+					 FuEngineWriteHelper *helper)
+{
+	g_atomic_int_set(&helper->status, (gint)status);
+}
+
+/* runs in the main thread, copying what the worker has done so far */
+static gboolean
+fu_engine_write_helper_progress_cb(gpointer user_data)
+{
+	FuEngineWriteHelper *helper = (FuEngineWriteHelper *)user_data;
+	FwupdStatus status = (FwupdStatus)g_atomic_int_get(&helper->status);
+	if (status != FWUPD_STATUS_UNKNOWN)
+		fu_progress_set_status(helper->progress, status);
+	fu_progress_set_percentage(helper->progress, (guint)g_atomic_int_get(&helper->percentage));
+	return G_SOURCE_CONTINUE;
+}
+
+/* runs in a worker thread, and must not touch anything other than the device */
+static gpointer
+fu_engine_write_helper_thread_cb(gpointer user_data)
+{
+	FuEngineWriteHelper *helper = (FuEngineWriteHelper *)user_data;
+	helper->ret = fu_plugin_runner_write_firmware(helper->plugin,
+						      helper->device,
+						      helper->blob_fw,
+						      helper->progress_write,
+						      helper->flags,
+						      &helper->error);
+	g_atomic_int_set(&helper->done, TRUE);
+	g_main_context_wakeup(NULL);
+	return NULL;
+}
+
+/* when installing concurrently, devices that opted in are written from a worker thread while
+ * the main context is iterated, so that other devices can be prepared and written meanwhile */
+static gboolean
+fu_engine_write_firmware_device(FuEngine *self,
+				FuPlugin *plugin,
+				FuDevice *device,
+				GBytes *blob_fw,
+				FuProgress *progress,
+				FwupdInstallFlags flags,
+				GError **error)
+{
+	guint timeout_id;
+	FuEngineWriteHelper helper = {
+	    .plugin = plugin,
+	    .device = device,
+	    .blob_fw = blob_fw,
+	    .progress = progress,
+	    .flags = flags,
+	    .status = FWUPD_STATUS_UNKNOWN,
+	};
+	g_autoptr(FuProgress) progress_write = NULL;
+	g_autoptr(GError) error_thread = NULL;
+	GThread *thread;
+
+	if (!self->install_concurrent ||
+	    !fu_device_has_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_CONCURRENT_INSTALL))
+		return fu_plugin_runner_write_firmware(plugin,
+						       device,
+						       blob_fw,
+						       progress,
+						       flags,
+						       error);
+
+	/* the worker only ever updates its own progress */
+	progress_write = fu_progress_new(G_STRLOC);
+	helper.progress_write = progress_write;
+	g_signal_connect(FU_PROGRESS(progress_write),
+			 "percentage-changed",
+			 G_CALLBACK(fu_engine_write_helper_percentage_changed_cb),
+			 &helper);
+	g_signal_connect(FU_PROGRESS(progress_write),
+			 "status-changed",
+			 G_CALLBACK(fu_engine_write_helper_status_changed_cb),
+			 &helper);
+	thread = g_thread_try_new("fwupd-write",
+				  fu_engine_write_helper_thread_cb,
+				  &helper,
+				  &error_thread);
+	if (thread == NULL) {
+		g_debug("failed to create thread, writing now: %s", error_thread->message);
+		return fu_plugin_runner_write_firmware(plugin,
+						       device,
+						       blob_fw,
+						       progress,
+						       flags,
+						       error);
+	}
+	timeout_id = g_timeout_add(100, fu_engine_write_helper_progress_cb, &helper);
+	while (!g_atomic_int_get(&helper.done))
+		g_main_context_iteration(NULL, TRUE);
+	g_source_remove(timeout_id);
+	g_thread_join(thread);
+	fu_engine_write_helper_progress_cb(&helper);
+	if (!helper.ret) {
+		g_propagate_error(error, helper.error);
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_engine_write_firmware(FuEngine *self,
 			 const gchar *device_id,
@@ -3236,7 +3944,13 @@ fu_engine_write_firmware(FuEngine *self,
 	    fu_plugin_list_find_by_name(self->plugin_list, fu_device_get_plugin(device), error);
 	if (plugin == NULL)
 		return FALSE;
-	if (!fu_plugin_runner_write_firmware(plugin, device, blob_fw, progress, flags, error)) {
+	if (!fu_engine_write_firmware_device(self,
+					     plugin,
+					     device,
+					     blob_fw,
+					     progress,
+					     flags,
+					     error)) {
 		g_autoptr(GError) error_attach = NULL;
 		g_autoptr(GError) error_cleanup = NULL;
 
@@ -3343,6 +4057,7 @@ fu_engine_install_blob(FuEngine *self,
 		       GError **error)
 {
 	guint retries = 0;
+	clock_t cpu_start = clock();
 	g_autofree gchar *device_id = NULL;
 	g_autoptr(GTimer) timer = g_timer_new();
 
@@ -3364,6 +4079,7 @@ fu_engine_install_blob(FuEngine *self,
 
 	/* mark this as modified even if we actually fail to do the update */
 	fu_device_set_modified(device, (guint64)g_get_real_time() / G_USEC_PER_SEC);
+	fu_device_clear_io_stats(device);
 
 	/* signal to all the plugins the update is about to happen */
 	device_id = g_strdup(fu_device_get_id(device));
@@ -3460,9 +4176,10 @@ fu_engine_install_blob(FuEngine *self,
 
 	/* make the UI update */
 	fu_engine_emit_device_changed(self, device_id);
-	g_debug("Updating %s took %f seconds",
+	g_debug("Updating %s took %f seconds, using %.1fms of CPU time",
 		fu_device_get_name(device),
-		g_timer_elapsed(timer, NULL));
+		g_timer_elapsed(timer, NULL),
+		(gdouble)(clock() - cpu_start) * 1000.f / CLOCKS_PER_SEC);
 	return TRUE;
 }
 
@@ -3523,47 +4240,40 @@ fu_engine_get_item_by_id_fallback_history(FuEngine *self, const gchar *id, GErro
 }
 
 static gboolean
-fu_engine_create_silo_index(FuEngine *self, GError **error)
+fu_engine_create_silo_index(FuEngine *self, XbSilo *silo, GError **error)
 {
 	g_autoptr(GPtrArray) components = NULL;
 
 	/* print what we've got */
-	components = xb_silo_query(self->silo, "components/component[@type='firmware']", 0, NULL);
+	components = xb_silo_query(silo, "components/component[@type='firmware']", 0, NULL);
 	if (components == NULL)
 		return TRUE;
 	g_debug("%u components now in silo", components->len);
 
 	/* build the index */
-	if (!xb_silo_query_build_index(self->silo, "components/component", "type", error))
+	if (!xb_silo_query_build_index(silo, "components/component", "type", error))
 		return FALSE;
-	if (!xb_silo_query_build_index(self->silo,
+	if (!xb_silo_query_build_index(silo,
 				       "components/component[@type='firmware']/provides/firmware",
 				       "type",
 				       error))
 		return FALSE;
-	if (!xb_silo_query_build_index(self->silo,
+	if (!xb_silo_query_build_index(silo,
 				       "components/component[@type='firmware']/provides/firmware",
 				       NULL,
 				       error))
 		return FALSE;
-	if (!xb_silo_query_build_index(self->silo,
+	if (!xb_silo_query_build_index(silo,
 				       "components/component[@type='firmware']/tags/tag",
 				       "namespace",
 				       error))
 		return FALSE;
 
-	/* create prepared queries to save time later */
-	self->query_component_by_guid =
-	    xb_query_new_full(self->silo,
-			      "components/component[@type='firmware']/"
-			      "provides/firmware[@type=$'flashed'][text()=?]/"
-			      "../..",
-			      XB_QUERY_FLAG_OPTIMIZE,
-			      error);
-	if (self->query_component_by_guid == NULL) {
-		g_prefix_error(error, "failed to prepare query: ");
-		return FALSE;
-	}
+	/* map each flashed GUID to the components providing it to save time later */
+	g_object_set_data_full(G_OBJECT(silo),
+			       "fwupd::SiloIndex",
+			       fu_engine_silo_index_new(components),
+			       (GDestroyNotify)fu_engine_silo_index_free);
 	return TRUE;
 }
 
@@ -3574,8 +4284,9 @@ fu_engine_set_silo(FuEngine *self, XbSilo *silo)
 	g_autoptr(GError) error_local = NULL;
 	g_return_if_fail(FU_IS_ENGINE(self));
 	g_return_if_fail(XB_IS_SILO(silo));
-	g_set_object(&self->silo, silo);
-	if (!fu_engine_create_silo_index(self, &error_local))
+	g_ptr_array_set_size(self->silos, 0);
+	g_ptr_array_add(self->silos, g_object_ref(silo));
+	if (!fu_engine_create_silo_index(self, silo, &error_local))
 		g_warning("failed to create indexes: %s", error_local->message);
 }
 
@@ -3590,36 +4301,178 @@ fu_engine_appstream_upgrade_cb(XbBuilderFixup *self,
 	return TRUE;
 }
 
-static XbBuilderSource *
-fu_engine_create_metadata_builder_source(FuEngine *self, const gchar *fn, GError **error)
+static gboolean
+fu_engine_create_metadata_cache_append_file(GString *str, const gchar *fn, GError **error)
 {
-	g_autoptr(GBytes) blob = NULL;
-	g_autoptr(XbSilo) silo = NULL;
-	g_autoptr(XbBuilderSource) source = xb_builder_source_new();
-	g_autofree gchar *xml = NULL;
+	guint64 mtime;
+	g_autoptr(GFile) file = g_file_new_for_path(fn);
+	g_autoptr(GFileInfo) info = NULL;
+
+	info = g_file_query_info(file,
+				 G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_STANDARD_SIZE,
+				 G_FILE_QUERY_INFO_NONE,
+				 NULL,
+				 error);
+	if (info == NULL)
+		return FALSE;
+	mtime = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED);
+	g_string_append_printf(str,
+			       "%s:%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT ";",
+			       fn,
+			       mtime,
+			       (guint64)g_file_info_get_size(info));
+	return TRUE;
+}
 
-	g_debug("building metadata for %s", fn);
-	blob = fu_bytes_get_contents(fn, error);
-	if (blob == NULL)
-		return NULL;
+static gint
+fu_engine_sort_strings_cb(gconstpointer a, gconstpointer b)
+{
+	return g_strcmp0(*(const gchar **)a, *(const gchar **)b);
+}
 
-	/* convert the silo for the CAB into a XbBuilderSource */
-	silo = fu_engine_get_silo_from_blob(self, blob, error);
-	if (silo == NULL)
+/* anything other than the archive itself that changes the parsed metainfo */
+static gchar *
+fu_engine_create_metadata_cache_salt(FuEngine *self, FwupdRemote *remote)
+{
+	const gchar *pkidirs[] = {"fwupd", "fwupd-metadata", NULL};
+	g_autofree gchar *sysconfdir = fu_path_from_kind(FU_PATH_KIND_SYSCONFDIR);
+	GString *str = g_string_new(NULL);
+
+	/* the daemon version, config and remote */
+	g_string_append_printf(str,
+			       "%s;%" G_GUINT64_FORMAT ";%s;",
+			       VERSION,
+			       fu_config_get_archive_size_max(self->config),
+			       fwupd_keyring_kind_to_string(fwupd_remote_get_keyring_kind(remote)));
+
+	/* the public keys used to set the trust flags */
+	for (guint i = 0; pkidirs[i] != NULL; i++) {
+		g_autofree gchar *pkidir = g_build_filename(sysconfdir, "pki", pkidirs[i], NULL);
+		g_autoptr(GPtrArray) files = fu_path_get_files(pkidir, NULL);
+		if (files == NULL)
+			continue;
+		g_ptr_array_sort(files, fu_engine_sort_strings_cb);
+		for (guint j = 0; j < files->len; j++) {
+			const gchar *fn = g_ptr_array_index(files, j);
+			g_autoptr(GError) error_local = NULL;
+			if (!fu_engine_create_metadata_cache_append_file(str, fn, &error_local))
+				g_debug("ignoring %s: %s", fn, error_local->message);
+		}
+	}
+	return g_string_free(str, FALSE);
+}
+
+/* the cache key changes if the CAB archive is replaced or modified, or anything in @salt */
+static gchar *
+fu_engine_create_metadata_cache_key(const gchar *fn, const gchar *salt, GError **error)
+{
+	g_autoptr(GString) str = g_string_new(salt);
+	if (!fu_engine_create_metadata_cache_append_file(str, fn, error))
 		return NULL;
-	xml = xb_silo_export(silo, XB_NODE_EXPORT_FLAG_NONE, error);
-	if (xml == NULL)
+	return g_compute_checksum_for_string(G_CHECKSUM_SHA1, str->str, str->len);
+}
+
+static XbBuilderSource *
+fu_engine_create_metadata_builder_source(FuEngine *self,
+					 const gchar *fn,
+					 const gchar *cachedir,
+					 const gchar *cache_salt,
+					 GHashTable *cache_used,
+					 GError **error)
+{
+	g_autofree gchar *cache_fn = NULL;
+	g_autofree gchar *cache_key = NULL;
+	g_autoptr(GFile) cache_file = NULL;
+	g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+
+	/* already parsed this exact archive */
+	cache_key = fu_engine_create_metadata_cache_key(fn, cache_salt, error);
+	if (cache_key == NULL)
 		return NULL;
-	if (!xb_builder_source_load_xml(source, xml, XB_BUILDER_SOURCE_FLAG_NONE, error))
+	cache_fn = g_strdup_printf("%s/%s.xml", cachedir, cache_key);
+	cache_file = g_file_new_for_path(cache_fn);
+	if (!g_file_query_exists(cache_file, NULL)) {
+		g_autoptr(GBytes) blob = NULL;
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(XbSilo) silo = NULL;
+
+		g_debug("building metadata for %s", fn);
+		blob = fu_bytes_get_contents(fn, error);
+		if (blob == NULL)
+			return NULL;
+
+		/* save the silo for the CAB so this is only done once */
+		silo = fu_engine_get_silo_from_blob(self, blob, error);
+		if (silo == NULL)
+			return NULL;
+		if (!fu_path_mkdir_parent(cache_fn, &error_local) ||
+		    !xb_silo_export_file(silo,
+					 cache_file,
+					 XB_NODE_EXPORT_FLAG_NONE,
+					 NULL,
+					 &error_local)) {
+			g_autofree gchar *xml = NULL;
+
+			/* not fatal, e.g. a read-only cache directory */
+			g_debug("failed to save metainfo cache: %s", error_local->message);
+			xml = xb_silo_export(silo, XB_NODE_EXPORT_FLAG_NONE, error);
+			if (xml == NULL)
+				return NULL;
+			if (!xb_builder_source_load_xml(source,
+							xml,
+							XB_BUILDER_SOURCE_FLAG_NONE,
+							error))
+				return NULL;
+			return g_steal_pointer(&source);
+		}
+	}
+	g_hash_table_add(cache_used, g_steal_pointer(&cache_key));
+
+	/* the source GUID is the path and mtime of the cached file, so unchanged archives
+	 * do not cause the remote silo to be recompiled */
+	if (!xb_builder_source_load_file(source,
+					 cache_file,
+					 XB_BUILDER_SOURCE_FLAG_NONE,
+					 NULL,
+					 error))
 		return NULL;
 	return g_steal_pointer(&source);
 }
 
+/* delete any cached metainfo for archives that no longer exist */
+static void
+fu_engine_create_metadata_cache_prune(const gchar *cachedir, GHashTable *cache_used)
+{
+	const gchar *fn;
+	g_autoptr(GDir) dir = g_dir_open(cachedir, 0, NULL);
+
+	if (dir == NULL)
+		return;
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		g_autofree gchar *cache_key = NULL;
+		g_autofree gchar *path = NULL;
+
+		if (!g_str_has_suffix(fn, ".xml"))
+			continue;
+		cache_key = g_strndup(fn, strlen(fn) - 4);
+		if (g_hash_table_contains(cache_used, cache_key))
+			continue;
+		path = g_build_filename(cachedir, fn, NULL);
+		g_debug("deleting stale metainfo cache %s", path);
+		if (g_unlink(path) != 0)
+			g_debug("failed to delete %s", path);
+	}
+}
+
 static gboolean
 fu_engine_create_metadata(FuEngine *self, XbBuilder *builder, FwupdRemote *remote, GError **error)
 {
 	g_autoptr(GPtrArray) files = NULL;
+	g_autoptr(GHashTable) cache_used = NULL;
 	const gchar *path;
+	g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *cachedir = NULL;
+	g_autofree gchar *cache_salt = NULL;
 
 	/* find all files in directory */
 	path = fwupd_remote_get_filename_cache(remote);
@@ -3627,6 +4480,11 @@ fu_engine_create_metadata(FuEngine *self, XbBuilder *builder, FwupdRemote *remot
 	if (files == NULL)
 		return FALSE;
 
+	/* the metainfo for each archive is cached */
+	cachedir = g_build_filename(cachedirpkg, "cabinets", fwupd_remote_get_id(remote), NULL);
+	cache_used = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	cache_salt = fu_engine_create_metadata_cache_salt(self, remote);
+
 	/* add each source */
 	for (guint i = 0; i < files->len; i++) {
 		g_autoptr(XbBuilderNode) custom = NULL;
@@ -3642,7 +4500,12 @@ fu_engine_create_metadata(FuEngine *self, XbBuilder *builder, FwupdRemote *remot
 		}
 
 		/* build source for file */
-		source = fu_engine_create_metadata_builder_source(self, fn, &error_local);
+		source = fu_engine_create_metadata_builder_source(self,
+								  fn,
+								  cachedir,
+								  cache_salt,
+								  cache_used,
+								  &error_local);
 		if (source == NULL) {
 			g_warning("failed to create builder source: %s", error_local->message);
 			continue;
@@ -3665,6 +4528,9 @@ fu_engine_create_metadata(FuEngine *self, XbBuilder *builder, FwupdRemote *remot
 		xb_builder_source_set_info(source, custom);
 		xb_builder_import_source(builder, source);
 	}
+
+	/* success */
+	fu_engine_create_metadata_cache_prune(cachedir, cache_used);
 	return TRUE;
 }
 
@@ -3987,15 +4853,56 @@ fu_engine_load_metadata_store_local(FuEngine *self,
 }
 
 static gboolean
-fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **error)
+fu_engine_load_metadata_store_remote(FuEngine *self,
+				     XbBuilder *builder,
+				     FwupdRemote *remote,
+				     GError **error)
 {
-	GPtrArray *remotes;
-	XbBuilderCompileFlags compile_flags = XB_BUILDER_COMPILE_FLAG_IGNORE_INVALID;
-	g_autoptr(GFile) xmlb = NULL;
-	g_autoptr(XbBuilder) builder = xb_builder_new();
+	const gchar *path = fwupd_remote_get_filename_cache(remote);
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(XbBuilderFixup) fixup = NULL;
+	g_autoptr(XbBuilderNode) custom = NULL;
+	g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+
+	/* generate all metadata on demand */
+	if (fwupd_remote_get_kind(remote) == FWUPD_REMOTE_KIND_DIRECTORY) {
+		g_debug("building metadata for remote '%s'", fwupd_remote_get_id(remote));
+		return fu_engine_create_metadata(self, builder, remote, error);
+	}
 
-	/* clear existing silo */
-	g_clear_object(&self->silo);
+	/* save the remote-id in the custom metadata space */
+	file = g_file_new_for_path(path);
+	if (!xb_builder_source_load_file(source, file, XB_BUILDER_SOURCE_FLAG_NONE, NULL, error))
+		return FALSE;
+
+	/* fix up any legacy installed files */
+	fixup = xb_builder_fixup_new("AppStreamUpgrade",
+				     fu_engine_appstream_upgrade_cb,
+				     self,
+				     NULL);
+	xb_builder_fixup_set_max_depth(fixup, 3);
+	xb_builder_source_add_fixup(source, fixup);
+
+	/* add metadata */
+	custom = xb_builder_node_new("custom");
+	xb_builder_node_insert_text(custom, "value", path, "key", "fwupd::FilenameCache", NULL);
+	xb_builder_node_insert_text(custom,
+				    "value",
+				    fwupd_remote_get_id(remote),
+				    "key",
+				    "fwupd::RemoteId",
+				    NULL);
+	xb_builder_source_set_info(source, custom);
+
+	/* we need to watch for changes? */
+	xb_builder_import_source(builder, source);
+	return TRUE;
+}
+
+static XbBuilder *
+fu_engine_metadata_builder_new(void)
+{
+	XbBuilder *builder = xb_builder_new();
 
 	/* verbose profiling */
 	if (g_getenv("FWUPD_XMLB_VERBOSE") != NULL) {
@@ -4003,74 +4910,255 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 					     XB_SILO_PROFILE_FLAG_XPATH |
 						 XB_SILO_PROFILE_FLAG_DEBUG);
 	}
+	return builder;
+}
 
-	/* load each enabled metadata file */
-	remotes = fu_remote_list_get_all(self->remote_list);
+static GFile *
+fu_engine_metadata_xmlb_file_new(const gchar *basename, FuEngineLoadFlags flags, GError **error)
+{
+	g_autofree gchar *cachedirpkg = NULL;
+	g_autofree gchar *xmlbfn = NULL;
+
+	/* do not save the compiled silo */
+	if (flags & FU_ENGINE_LOAD_FLAG_NO_CACHE) {
+		g_autoptr(GFileIOStream) iostr = NULL;
+		return g_file_new_tmp(NULL, &iostr, error);
+	}
+	cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	xmlbfn = g_build_filename(cachedirpkg, basename, NULL);
+	if ((flags & FU_ENGINE_LOAD_FLAG_READONLY) == 0) {
+		if (!fu_path_mkdir_parent(xmlbfn, error))
+			return NULL;
+	}
+	return g_file_new_for_path(xmlbfn);
+}
+
+typedef struct {
+	FwupdRemote *remote;
+	XbBuilder *builder;
+	GFile *xmlb;
+	XbBuilderCompileFlags compile_flags;
+	XbSilo *silo;	/* (nullable) */
+	GError *error;	/* (nullable) */
+	gdouble elapsed; /* s */
+} FuEngineMetadataSiloHelper;
+
+static void
+fu_engine_metadata_silo_helper_free(FuEngineMetadataSiloHelper *helper)
+{
+	if (helper->silo != NULL)
+		g_object_unref(helper->silo);
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_object_unref(helper->remote);
+	g_object_unref(helper->builder);
+	g_object_unref(helper->xmlb);
+	g_free(helper);
+}
+
+/* runs in a worker thread, using only the thread-local builder */
+static void
+fu_engine_metadata_silo_helper_compile_cb(gpointer data, gpointer user_data)
+{
+	FuEngineMetadataSiloHelper *helper = (FuEngineMetadataSiloHelper *)data;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* if the GUID matches then this just maps the existing file */
+	helper->silo = xb_builder_ensure(helper->builder,
+					 helper->xmlb,
+					 helper->compile_flags,
+					 NULL,
+					 &helper->error);
+	helper->elapsed = g_timer_elapsed(timer, NULL);
+}
+
+/* delete the silos of remotes that have been removed, disabled or have no metadata */
+static void
+fu_engine_metadata_silo_prune(GPtrArray *helpers, FuEngineLoadFlags flags)
+{
+	const gchar *fn;
+	g_autofree gchar *cachedirpkg = NULL;
+	g_autofree gchar *dirname = NULL;
+	g_autoptr(GDir) dir = NULL;
+	g_autoptr(GHashTable) basenames = NULL;
+
+	if (flags & (FU_ENGINE_LOAD_FLAG_NO_CACHE | FU_ENGINE_LOAD_FLAG_READONLY))
+		return;
+	cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	dirname = g_build_filename(cachedirpkg, "metadata.d", NULL);
+	dir = g_dir_open(dirname, 0, NULL);
+	if (dir == NULL)
+		return;
+	basenames = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	g_hash_table_add(basenames, g_strdup("local.xmlb"));
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineMetadataSiloHelper *helper = g_ptr_array_index(helpers, i);
+		g_hash_table_add(basenames, g_file_get_basename(helper->xmlb));
+	}
+	while ((fn = g_dir_read_name(dir)) != NULL) {
+		g_autofree gchar *path = NULL;
+		if (!g_str_has_suffix(fn, ".xmlb"))
+			continue;
+		if (g_hash_table_contains(basenames, fn))
+			continue;
+		path = g_build_filename(dirname, fn, NULL);
+		g_debug("deleting stale silo %s", path);
+		if (g_unlink(path) != 0)
+			g_debug("failed to delete %s", path);
+	}
+}
+
+/* each remote gets its own silo, so only the remotes that changed need to be recompiled */
+static gboolean
+fu_engine_load_metadata_store_incremental(FuEngine *self,
+					  FuEngineLoadFlags flags,
+					  XbBuilderCompileFlags compile_flags,
+					  GError **error)
+{
+	GPtrArray *remotes = fu_remote_list_get_all(self->remote_list);
+	GThreadPool *pool;
+	g_autoptr(GFile) xmlb_local = NULL;
+	g_autoptr(GPtrArray) helpers = NULL;
+	g_autoptr(XbBuilder) builder_local = fu_engine_metadata_builder_new();
+	g_autoptr(XbSilo) silo_local = NULL;
+
+	/* populate the builder for each enabled remote, which is cheap */
+	helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_metadata_silo_helper_free);
 	for (guint i = 0; i < remotes->len; i++) {
-		const gchar *path = NULL;
+		FwupdRemote *remote = g_ptr_array_index(remotes, i);
+		FuEngineMetadataSiloHelper *helper;
+		const gchar *checksum = fwupd_remote_get_checksum(remote);
+		g_autofree gchar *basename = NULL;
 		g_autoptr(GError) error_local = NULL;
-		g_autoptr(GFile) file = NULL;
-		g_autoptr(XbBuilderFixup) fixup = NULL;
-		g_autoptr(XbBuilderNode) custom = NULL;
-		g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+		g_autoptr(GFile) xmlb = NULL;
+		g_autoptr(XbBuilder) builder = fu_engine_metadata_builder_new();
 
-		FwupdRemote *remote = g_ptr_array_index(remotes, i);
 		if (!fwupd_remote_get_enabled(remote))
 			continue;
-		path = fwupd_remote_get_filename_cache(remote);
-		if (!g_file_test(path, G_FILE_TEST_EXISTS))
+		if (!g_file_test(fwupd_remote_get_filename_cache(remote), G_FILE_TEST_EXISTS))
 			continue;
 
-		/* generate all metadata on demand */
-		if (fwupd_remote_get_kind(remote) == FWUPD_REMOTE_KIND_DIRECTORY) {
-			g_debug("building metadata for remote '%s'", fwupd_remote_get_id(remote));
-			if (!fu_engine_create_metadata(self, builder, remote, &error_local)) {
-				g_warning("failed to generate remote %s: %s",
-					  fwupd_remote_get_id(remote),
-					  error_local->message);
-			}
+		/* only recompile the silo when the metadata contents change */
+		if (checksum != NULL)
+			xb_builder_append_guid(builder, checksum);
+		if (!fu_engine_load_metadata_store_remote(self, builder, remote, &error_local)) {
+			g_warning("failed to load remote %s: %s",
+				  fwupd_remote_get_id(remote),
+				  error_local->message);
+			continue;
+		}
+		basename = g_strdup_printf("metadata.d/%s.xmlb", fwupd_remote_get_id(remote));
+		xmlb = fu_engine_metadata_xmlb_file_new(basename, flags, error);
+		if (xmlb == NULL)
+			return FALSE;
+
+		helper = g_new0(FuEngineMetadataSiloHelper, 1);
+		helper->remote = g_object_ref(remote);
+		helper->builder = g_steal_pointer(&builder);
+		helper->xmlb = g_steal_pointer(&xmlb);
+		helper->compile_flags = compile_flags;
+		g_ptr_array_add(helpers, helper);
+	}
+
+	/* compile or load each silo in parallel */
+	pool = g_thread_pool_new(fu_engine_metadata_silo_helper_compile_cb,
+				 self,
+				 (gint)g_get_num_processors(),
+				 FALSE,
+				 error);
+	if (pool == NULL)
+		return FALSE;
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineMetadataSiloHelper *helper = g_ptr_array_index(helpers, i);
+		g_autoptr(GError) error_local = NULL;
+		if (!g_thread_pool_push(pool, helper, &error_local)) {
+			g_debug("failed to push to thread pool, compiling now: %s",
+				error_local->message);
+			fu_engine_metadata_silo_helper_compile_cb(helper, self);
+		}
+	}
+	g_thread_pool_free(pool, FALSE, TRUE);
+	fu_engine_metadata_silo_prune(helpers, flags);
+
+	/* use the silos in remote priority order */
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineMetadataSiloHelper *helper = g_ptr_array_index(helpers, i);
+		if (helper->silo == NULL) {
+			g_warning("failed to load remote %s: %s",
+				  fwupd_remote_get_id(helper->remote),
+				  helper->error->message);
 			continue;
 		}
+		g_debug("silo for remote %s ready in %.0fms",
+			fwupd_remote_get_id(helper->remote),
+			helper->elapsed * 1000.f);
+		if (!fu_engine_create_silo_index(self, helper->silo, error))
+			return FALSE;
+		g_ptr_array_add(self->silos, g_object_ref(helper->silo));
+	}
+
+	/* add any client-side data, e.g. BKC tags */
+	if (!fu_engine_load_metadata_store_local(self,
+						 builder_local,
+						 FU_PATH_KIND_LOCALSTATEDIR_PKG,
+						 error))
+		return FALSE;
+	if (!fu_engine_load_metadata_store_local(self,
+						 builder_local,
+						 FU_PATH_KIND_DATADIR_PKG,
+						 error))
+		return FALSE;
+	xmlb_local = fu_engine_metadata_xmlb_file_new("metadata.d/local.xmlb", flags, error);
+	if (xmlb_local == NULL)
+		return FALSE;
+	silo_local = xb_builder_ensure(builder_local, xmlb_local, compile_flags, NULL, error);
+	if (silo_local == NULL) {
+		g_prefix_error(error, "cannot create local.xmlb: ");
+		return FALSE;
+	}
+	g_ptr_array_add(self->silos, g_steal_pointer(&silo_local));
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **error)
+{
+	GPtrArray *remotes;
+	XbBuilderCompileFlags compile_flags = XB_BUILDER_COMPILE_FLAG_IGNORE_INVALID;
+	g_autoptr(GFile) xmlb = NULL;
+	g_autoptr(XbBuilder) builder = fu_engine_metadata_builder_new();
+	g_autoptr(XbSilo) silo = NULL;
+
+	/* clear existing silos */
+	g_ptr_array_set_size(self->silos, 0);
+
+	/* on a read-only filesystem don't care about the cache GUID */
+	if (flags & FU_ENGINE_LOAD_FLAG_READONLY)
+		compile_flags |= XB_BUILDER_COMPILE_FLAG_IGNORE_GUID;
+
+	/* one silo for each remote */
+	if (fu_config_get_incremental_metadata(self->config))
+		return fu_engine_load_metadata_store_incremental(self, flags, compile_flags, error);
+
+	/* load each enabled metadata file */
+	remotes = fu_remote_list_get_all(self->remote_list);
+	for (guint i = 0; i < remotes->len; i++) {
+		FwupdRemote *remote = g_ptr_array_index(remotes, i);
+		g_autoptr(GError) error_local = NULL;
 
-		/* save the remote-id in the custom metadata space */
-		file = g_file_new_for_path(path);
-		if (!xb_builder_source_load_file(source,
-						 file,
-						 XB_BUILDER_SOURCE_FLAG_NONE,
-						 NULL,
-						 &error_local)) {
+		if (!fwupd_remote_get_enabled(remote))
+			continue;
+		if (!g_file_test(fwupd_remote_get_filename_cache(remote), G_FILE_TEST_EXISTS))
+			continue;
+		if (!fu_engine_load_metadata_store_remote(self, builder, remote, &error_local)) {
 			g_warning("failed to load remote %s: %s",
 				  fwupd_remote_get_id(remote),
 				  error_local->message);
 			continue;
 		}
-
-		/* fix up any legacy installed files */
-		fixup = xb_builder_fixup_new("AppStreamUpgrade",
-					     fu_engine_appstream_upgrade_cb,
-					     self,
-					     NULL);
-		xb_builder_fixup_set_max_depth(fixup, 3);
-		xb_builder_source_add_fixup(source, fixup);
-
-		/* add metadata */
-		custom = xb_builder_node_new("custom");
-		xb_builder_node_insert_text(custom,
-					    "value",
-					    path,
-					    "key",
-					    "fwupd::FilenameCache",
-					    NULL);
-		xb_builder_node_insert_text(custom,
-					    "value",
-					    fwupd_remote_get_id(remote),
-					    "key",
-					    "fwupd::RemoteId",
-					    NULL);
-		xb_builder_source_set_info(source, custom);
-
-		/* we need to watch for changes? */
-		xb_builder_import_source(builder, source);
 	}
 
 	/* add any client-side data, e.g. BKC tags */
@@ -4082,29 +5170,21 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 	if (!fu_engine_load_metadata_store_local(self, builder, FU_PATH_KIND_DATADIR_PKG, error))
 		return FALSE;
 
-	/* on a read-only filesystem don't care about the cache GUID */
-	if (flags & FU_ENGINE_LOAD_FLAG_READONLY)
-		compile_flags |= XB_BUILDER_COMPILE_FLAG_IGNORE_GUID;
-
 	/* ensure silo is up to date */
-	if (flags & FU_ENGINE_LOAD_FLAG_NO_CACHE) {
-		g_autoptr(GFileIOStream) iostr = NULL;
-		xmlb = g_file_new_tmp(NULL, &iostr, error);
-		if (xmlb == NULL)
-			return FALSE;
-	} else {
-		g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
-		g_autofree gchar *xmlbfn = g_build_filename(cachedirpkg, "metadata.xmlb", NULL);
-		xmlb = g_file_new_for_path(xmlbfn);
-	}
-	self->silo = xb_builder_ensure(builder, xmlb, compile_flags, NULL, error);
-	if (self->silo == NULL) {
+	xmlb = fu_engine_metadata_xmlb_file_new("metadata.xmlb", flags, error);
+	if (xmlb == NULL)
+		return FALSE;
+	silo = xb_builder_ensure(builder, xmlb, compile_flags, NULL, error);
+	if (silo == NULL) {
 		g_prefix_error(error, "cannot create metadata.xmlb: ");
 		return FALSE;
 	}
+	if (!fu_engine_create_silo_index(self, silo, error))
+		return FALSE;
+	g_ptr_array_add(self->silos, g_steal_pointer(&silo));
 
 	/* success */
-	return fu_engine_create_silo_index(self, error);
+	return TRUE;
 }
 
 static void
@@ -5054,6 +6134,23 @@ fu_engine_sort_releases_cb(gconstpointer a, gconstpointer b, gpointer user_data)
 				  fu_device_get_version_format(device));
 }
 
+/* the sets keep the checksum as added, but an uppercase checksum from the metadata matches */
+static guint
+fu_engine_checksum_hash(gconstpointer key)
+{
+	const gchar *csum = (const gchar *)key;
+	guint32 hash = 5381;
+	for (guint i = 0; csum[i] != '\0'; i++)
+		hash = (hash << 5) + hash + (guint8)g_ascii_tolower(csum[i]);
+	return hash;
+}
+
+static gboolean
+fu_engine_checksum_equal(gconstpointer a, gconstpointer b)
+{
+	return g_ascii_strcasecmp(a, b) == 0;
+}
+
 static gboolean
 fu_engine_check_release_is_approved(FuEngine *self, FwupdRelease *rel)
 {
@@ -5062,8 +6159,7 @@ fu_engine_check_release_is_approved(FuEngine *self, FwupdRelease *rel)
 		return FALSE;
 	for (guint i = 0; i < csums->len; i++) {
 		const gchar *csum = g_ptr_array_index(csums, i);
-		g_debug("checking %s against approved list", csum);
-		if (g_hash_table_lookup(self->approved_firmware, csum) != NULL)
+		if (g_hash_table_contains(self->approved_firmware, csum))
 			return TRUE;
 	}
 	return FALSE;
@@ -5077,7 +6173,7 @@ fu_engine_check_release_is_blocked(FuEngine *self, FuRelease *release)
 		return FALSE;
 	for (guint i = 0; i < csums->len; i++) {
 		const gchar *csum = g_ptr_array_index(csums, i);
-		if (g_hash_table_lookup(self->blocked_firmware, csum) != NULL)
+		if (g_hash_table_contains(self->blocked_firmware, csum))
 			return TRUE;
 	}
 	return FALSE;
@@ -5226,12 +6322,11 @@ fu_engine_get_releases_for_device(FuEngine *self,
 {
 	GPtrArray *device_guids;
 	const gchar *version;
+	g_autoptr(GArray) guids_bin = g_array_new(FALSE, FALSE, sizeof(fwupd_guid_t));
 	g_autoptr(GError) error_all = NULL;
-	g_autoptr(GError) error_local = NULL;
 	g_autoptr(GPtrArray) branches = NULL;
 	g_autoptr(GPtrArray) components = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
-	g_autoptr(GString) xpath = g_string_new(NULL);
 
 	/* get device version */
 	version = fu_device_get_version(device);
@@ -5251,27 +6346,48 @@ fu_engine_get_releases_for_device(FuEngine *self,
 		return NULL;
 	}
 
-	/* get all the components that provide any of these GUIDs */
+	/* get all the components that provide any of these GUIDs, in document order */
 	device_guids = fu_device_get_guids(device);
 	for (guint i = 0; i < device_guids->len; i++) {
 		const gchar *guid = g_ptr_array_index(device_guids, i);
-		xb_string_append_union(xpath,
-				       "components/component[@type='firmware']/"
-				       "provides/firmware[@type=$'flashed'][text()=$'%s']/"
-				       "../..",
-				       guid);
-	}
-	components = xb_silo_query(self->silo, xpath->str, 0, &error_local);
-	if (components == NULL) {
-		if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
-		    g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
-			g_set_error_literal(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_NOTHING_TO_DO,
-					    "No releases found");
-			return NULL;
+		fwupd_guid_t guid_bin = {0x0};
+		if (fwupd_guid_from_string(guid, &guid_bin, FWUPD_GUID_FLAG_NONE, NULL))
+			g_array_append_val(guids_bin, guid_bin);
+	}
+	components = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = 0; i < self->silos->len; i++) {
+		XbSilo *silo = g_ptr_array_index(self->silos, i);
+		FuEngineSiloIndex *silo_index;
+		g_autoptr(GArray) idxs_silo = NULL;
+
+		/* no components in silo */
+		silo_index = g_object_get_data(G_OBJECT(silo), "fwupd::SiloIndex");
+		if (silo_index == NULL)
+			continue;
+
+		FU_TRACE2(silo_query_begin, "components-for-device", fu_device_get_id(device));
+		idxs_silo = g_array_new(FALSE, FALSE, sizeof(guint));
+		for (guint j = 0; j < guids_bin->len; j++) {
+			fwupd_guid_t *guid_bin = &g_array_index(guids_bin, fwupd_guid_t, j);
+			GArray *idxs = fu_engine_silo_index_lookup(silo_index, guid_bin);
+			if (idxs != NULL)
+				g_array_append_vals(idxs_silo, idxs->data, idxs->len);
+		}
+		g_array_sort(idxs_silo, fu_engine_silo_index_sort_cb);
+		for (guint j = 0; j < idxs_silo->len; j++) {
+			guint idx = g_array_index(idxs_silo, guint, j);
+			XbNode *component = g_ptr_array_index(silo_index->components, idx);
+			if (j > 0 && g_array_index(idxs_silo, guint, j - 1) == idx)
+				continue;
+			g_ptr_array_add(components, g_object_ref(component));
 		}
-		g_propagate_error(error, g_steal_pointer(&error_local));
+		FU_TRACE2(silo_query_end, "components-for-device", idxs_silo->len > 0);
+	}
+	if (components->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOTHING_TO_DO,
+				    "No releases found");
 		return NULL;
 	}
 
@@ -5496,8 +6612,10 @@ void
 fu_engine_add_approved_firmware(FuEngine *self, const gchar *checksum)
 {
 	if (self->approved_firmware == NULL) {
-		self->approved_firmware =
-		    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+		self->approved_firmware = g_hash_table_new_full(fu_engine_checksum_hash,
+								fu_engine_checksum_equal,
+								g_free,
+								NULL);
 	}
 	g_hash_table_add(self->approved_firmware, g_strdup(checksum));
 }
@@ -5520,8 +6638,10 @@ void
 fu_engine_add_blocked_firmware(FuEngine *self, const gchar *checksum)
 {
 	if (self->blocked_firmware == NULL) {
-		self->blocked_firmware =
-		    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+		self->blocked_firmware = g_hash_table_new_full(fu_engine_checksum_hash,
+							       fu_engine_checksum_equal,
+							       g_free,
+							       NULL);
 	}
 	g_hash_table_add(self->blocked_firmware, g_strdup(checksum));
 }
@@ -5540,14 +6660,7 @@ fu_engine_set_blocked_firmware(FuEngine *self, GPtrArray *checksums, GError **er
 	}
 
 	/* save database */
-	if (!fu_history_clear_blocked_firmware(self->history, error))
-		return FALSE;
-	for (guint i = 0; i < checksums->len; i++) {
-		const gchar *csum = g_ptr_array_index(checksums, i);
-		if (!fu_history_add_blocked_firmware(self->history, csum, error))
-			return FALSE;
-	}
-	return TRUE;
+	return fu_history_set_blocked_firmware(self->history, checksums, error);
 }
 
 gchar *
@@ -5782,21 +6895,219 @@ fu_engine_get_results(FuEngine *self, const gchar *device_id, GError **error)
 	return g_object_ref(FWUPD_DEVICE(device));
 }
 
+typedef enum {
+	FU_ENGINE_PLUGIN_EVENT_DEVICE_ADDED,
+	FU_ENGINE_PLUGIN_EVENT_DEVICE_REMOVED,
+	FU_ENGINE_PLUGIN_EVENT_DEVICE_REGISTER,
+} FuEnginePluginEventKind;
+
+typedef struct {
+	FuEnginePluginEventKind kind;
+	FuPlugin *plugin;
+	FuDevice *device;
+} FuEnginePluginEvent;
+
+static void
+fu_engine_plugin_event_free(FuEnginePluginEvent *event)
+{
+	g_object_unref(event->plugin);
+	g_object_unref(event->device);
+	g_free(event);
+}
+
+/* the plugin signals are queued while plugins are running on worker threads */
+static gboolean
+fu_engine_plugin_event_defer(FuEngine *self,
+			     FuEnginePluginEventKind kind,
+			     FuPlugin *plugin,
+			     FuDevice *device)
+{
+	FuEnginePluginEvent *event;
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->plugin_events_mutex);
+
+	if (self->plugin_events == NULL)
+		return FALSE;
+	event = g_new0(FuEnginePluginEvent, 1);
+	event->kind = kind;
+	event->plugin = g_object_ref(plugin);
+	event->device = g_object_ref(device);
+	g_ptr_array_add(self->plugin_events, event);
+	return TRUE;
+}
+
+static void
+fu_engine_plugin_events_replay(FuEngine *self, GPtrArray *events)
+{
+	for (guint i = 0; i < events->len; i++) {
+		FuEnginePluginEvent *event = g_ptr_array_index(events, i);
+		if (event->kind == FU_ENGINE_PLUGIN_EVENT_DEVICE_ADDED)
+			fu_engine_plugin_device_added_cb(event->plugin, event->device, self);
+		else if (event->kind == FU_ENGINE_PLUGIN_EVENT_DEVICE_REMOVED)
+			fu_engine_plugin_device_removed_cb(event->plugin, event->device, self);
+		else if (event->kind == FU_ENGINE_PLUGIN_EVENT_DEVICE_REGISTER)
+			fu_engine_plugin_device_register_cb(event->plugin, event->device, self);
+	}
+}
+
+typedef gboolean (*FuEnginePluginRunnerFunc)(FuPlugin *plugin,
+					     FuProgress *progress,
+					     GError **error);
+
+typedef struct {
+	FuPlugin *plugin;
+	FuEnginePluginRunnerFunc func;
+	FuProgress *progress;
+	GError *error;	 /* (nullable) */
+	gdouble elapsed; /* s */
+} FuEnginePluginHelper;
+
+static void
+fu_engine_plugin_helper_free(FuEnginePluginHelper *helper)
+{
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_object_unref(helper->progress);
+	g_object_unref(helper->plugin);
+	g_free(helper);
+}
+
+/* runs in a worker thread for plugins that have opted in using fu_plugin_set_thread_safe() */
+static void
+fu_engine_plugin_helper_run_cb(gpointer data, gpointer user_data)
+{
+	FuEnginePluginHelper *helper = (FuEnginePluginHelper *)data;
+	g_autoptr(GTimer) timer = g_timer_new();
+	(void)helper->func(helper->plugin, helper->progress, &helper->error);
+	helper->elapsed = g_timer_elapsed(timer, NULL);
+}
+
+/* all the thread safe plugins in @batch have the same order, and so cannot depend on each other */
+static void
+fu_engine_plugins_run_batch(FuEngine *self, GPtrArray *batch)
+{
+	GThreadPool *pool = NULL;
+	g_autoptr(GError) error_pool = NULL;
+	g_autoptr(GPtrArray) events = NULL;
+
+	if (batch->len == 0)
+		return;
+	if (batch->len > 1) {
+		pool = g_thread_pool_new(fu_engine_plugin_helper_run_cb,
+					 self,
+					 (gint)MIN(batch->len, g_get_num_processors()),
+					 FALSE,
+					 &error_pool);
+		if (pool == NULL)
+			g_debug("failed to create thread pool, running now: %s",
+				error_pool->message);
+	}
+
+	/* devices are added to the engine once all the plugins in the batch have finished */
+	g_mutex_lock(&self->plugin_events_mutex);
+	self->plugin_events =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_plugin_event_free);
+	g_mutex_unlock(&self->plugin_events_mutex);
+	for (guint i = 0; i < batch->len; i++) {
+		FuEnginePluginHelper *helper = g_ptr_array_index(batch, i);
+		g_autoptr(GError) error_local = NULL;
+		if (pool == NULL || !g_thread_pool_push(pool, helper, &error_local)) {
+			if (error_local != NULL)
+				g_debug("failed to push: %s", error_local->message);
+			fu_engine_plugin_helper_run_cb(helper, self);
+		}
+	}
+	if (pool != NULL)
+		g_thread_pool_free(pool, FALSE, TRUE);
+	g_mutex_lock(&self->plugin_events_mutex);
+	events = g_steal_pointer(&self->plugin_events);
+	g_mutex_unlock(&self->plugin_events_mutex);
+	fu_engine_plugin_events_replay(self, events);
+
+	for (guint i = 0; i < batch->len; i++) {
+		FuEnginePluginHelper *helper = g_ptr_array_index(batch, i);
+		g_debug("%s took %.0fms on worker thread",
+			fu_plugin_get_name(helper->plugin),
+			helper->elapsed * 1000.f);
+	}
+	g_ptr_array_set_size(batch, 0);
+}
+
+/* plugins are sorted by order, so each run of the same order is started in parallel */
+static GPtrArray *
+fu_engine_plugins_run_parallel(FuEngine *self, FuEnginePluginRunnerFunc func, FuProgress *progress)
+{
+	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
+	GPtrArray *helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_plugin_helper_free);
+	g_autoptr(GPtrArray) batch = g_ptr_array_new();
+
+	for (guint i = 0; i < plugins->len; i++) {
+		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		FuEnginePluginHelper *helper = g_new0(FuEnginePluginHelper, 1);
+
+		helper->plugin = g_object_ref(plugin);
+		helper->func = func;
+		g_ptr_array_add(helpers, helper);
+
+		/* the previous order has to complete before this plugin starts */
+		if (batch->len > 0) {
+			FuEnginePluginHelper *helper_tmp = g_ptr_array_index(batch, 0);
+			if (fu_plugin_get_order(helper_tmp->plugin) != fu_plugin_get_order(plugin))
+				fu_engine_plugins_run_batch(self, batch);
+		}
+
+		/* the worker thread cannot use the parent progress, so reserve the step now to
+		 * keep the steps of any main-thread plugins with the same order in plugin order */
+		if (fu_plugin_get_thread_safe(plugin)) {
+			helper->progress = fu_progress_new(G_STRLOC);
+			g_ptr_array_add(batch, helper);
+			fu_progress_step_done(progress);
+			continue;
+		}
+
+		/* everything else runs on the main thread */
+		helper->progress = g_object_ref(fu_progress_get_child(progress));
+		if (!func(plugin, helper->progress, &helper->error))
+			fu_progress_add_flag(progress, FU_PROGRESS_FLAG_CHILD_FINISHED);
+		fu_progress_step_done(progress);
+	}
+	fu_engine_plugins_run_batch(self, batch);
+	return helpers;
+}
+
 static void
+fu_engine_plugin_startup_failed(FuPlugin *plugin, const GError *error)
+{
+	fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
+	if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED))
+		fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
+	g_message("disabling plugin because: %s", error->message);
+}
+
+void
 fu_engine_plugins_setup(FuEngine *self, FuProgress *progress)
 {
 	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, plugins->len);
+
+	/* start any thread safe plugins with the same order at the same time */
+	if (fu_config_get_parallel_plugin_startup(self->config)) {
+		g_autoptr(GPtrArray) helpers =
+		    fu_engine_plugins_run_parallel(self, fu_plugin_runner_startup, progress);
+		for (guint i = 0; i < helpers->len; i++) {
+			FuEnginePluginHelper *helper = g_ptr_array_index(helpers, i);
+			if (helper->error != NULL)
+				fu_engine_plugin_startup_failed(helper->plugin, helper->error);
+		}
+		return;
+	}
+
 	for (guint i = 0; i < plugins->len; i++) {
 		g_autoptr(GError) error = NULL;
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
 		if (!fu_plugin_runner_startup(plugin, fu_progress_get_child(progress), &error)) {
-			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
-			if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
-				fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
-			}
-			g_message("disabling plugin because: %s", error->message);
+			fu_engine_plugin_startup_failed(plugin, error);
 			fu_progress_add_flag(progress, FU_PROGRESS_FLAG_CHILD_FINISHED);
 		}
 		fu_progress_step_done(progress);
@@ -5813,15 +7124,29 @@ fu_engine_plugins_coldplug(FuEngine *self, FuProgress *progress)
 	plugins = fu_plugin_list_get_all(self->plugin_list);
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, plugins->len);
-	for (guint i = 0; i < plugins->len; i++) {
-		g_autoptr(GError) error = NULL;
-		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (!fu_plugin_runner_coldplug(plugin, fu_progress_get_child(progress), &error)) {
-			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
-			g_message("disabling plugin because: %s", error->message);
-			fu_progress_add_flag(progress, FU_PROGRESS_FLAG_CHILD_FINISHED);
+	if (fu_config_get_parallel_plugin_startup(self->config)) {
+		g_autoptr(GPtrArray) helpers =
+		    fu_engine_plugins_run_parallel(self, fu_plugin_runner_coldplug, progress);
+		for (guint i = 0; i < helpers->len; i++) {
+			FuEnginePluginHelper *helper = g_ptr_array_index(helpers, i);
+			if (helper->error == NULL)
+				continue;
+			fu_plugin_add_flag(helper->plugin, FWUPD_PLUGIN_FLAG_DISABLED);
+			g_message("disabling plugin because: %s", helper->error->message);
+		}
+	} else {
+		for (guint i = 0; i < plugins->len; i++) {
+			g_autoptr(GError) error = NULL;
+			FuPlugin *plugin = g_ptr_array_index(plugins, i);
+			if (!fu_plugin_runner_coldplug(plugin,
+						       fu_progress_get_child(progress),
+						       &error)) {
+				fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
+				g_message("disabling plugin because: %s", error->message);
+				fu_progress_add_flag(progress, FU_PROGRESS_FLAG_CHILD_FINISHED);
+			}
+			fu_progress_step_done(progress);
 		}
-		fu_progress_step_done(progress);
 	}
 
 	/* print what we do have */
@@ -5861,6 +7186,11 @@ static void
 fu_engine_plugin_device_register_cb(FuPlugin *plugin, FuDevice *device, gpointer user_data)
 {
 	FuEngine *self = FU_ENGINE(user_data);
+	if (fu_engine_plugin_event_defer(self,
+					 FU_ENGINE_PLUGIN_EVENT_DEVICE_REGISTER,
+					 plugin,
+					 device))
+		return;
 	fu_engine_plugin_device_register(self, device);
 }
 
@@ -5869,6 +7199,12 @@ fu_engine_plugin_device_added_cb(FuPlugin *plugin, FuDevice *device, gpointer us
 {
 	FuEngine *self = FU_ENGINE(user_data);
 
+	if (fu_engine_plugin_event_defer(self,
+					 FU_ENGINE_PLUGIN_EVENT_DEVICE_ADDED,
+					 plugin,
+					 device))
+		return;
+
 	/* plugin has prio and device not already set from quirk */
 	if (fu_plugin_get_priority(plugin) > 0 && fu_device_get_priority(device) == 0) {
 		g_debug("auto-setting %s priority to %u",
@@ -6196,6 +7532,12 @@ fu_engine_plugin_device_removed_cb(FuPlugin *plugin, FuDevice *device, gpointer
 	g_autoptr(FuDevice) device_tmp = NULL;
 	g_autoptr(GError) error = NULL;
 
+	if (fu_engine_plugin_event_defer(self,
+					 FU_ENGINE_PLUGIN_EVENT_DEVICE_REMOVED,
+					 plugin,
+					 device))
+		return;
+
 	device_tmp = fu_device_list_get_by_id(self->device_list, fu_device_get_id(device), &error);
 	if (device_tmp == NULL) {
 		g_debug("failed to find device %s: %s", fu_device_get_id(device), error->message);
@@ -6301,7 +7643,6 @@ fu_engine_add_plugin_filter(FuEngine *self, const gchar *plugin_glob)
 static gboolean
 fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngine *self)
 {
-	g_autoptr(XbNode) n = NULL;
 	g_autofree gchar *xpath = NULL;
 
 	if (fu_config_get_enumerate_all_devices(self->config))
@@ -6310,8 +7651,13 @@ fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngin
 	xpath = g_strdup_printf("components/component[@type='firmware']/"
 				"provides/firmware[@type='flashed'][text()='%s']",
 				guid);
-	n = xb_silo_query_first(self->silo, xpath, NULL);
-	return n != NULL;
+	for (guint i = 0; i < self->silos->len; i++) {
+		XbSilo *silo = g_ptr_array_index(self->silos, i);
+		g_autoptr(XbNode) n = xb_silo_query_first(silo, xpath, NULL);
+		if (n != NULL)
+			return TRUE;
+	}
+	return FALSE;
 }
 
 gboolean
@@ -7067,6 +8413,20 @@ fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuP
 	}
 }
 
+static void
+fu_engine_backend_device_probe_warning(FuDevice *device, const GError *error)
+{
+	if (!g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
+		g_warning("failed to probe device %s: %s",
+			  fu_device_get_backend_id(device),
+			  error->message);
+	} else if (g_getenv("FWUPD_PROBE_VERBOSE") != NULL) {
+		g_debug("failed to probe device %s : %s",
+			fu_device_get_backend_id(device),
+			error->message);
+	}
+}
+
 static void
 fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *progress)
 {
@@ -7086,18 +8446,12 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 	}
 
 	/* add any extra quirks */
+	FU_TRACE1(engine_backend_device_added_begin, fu_device_get_backend_id(device));
 	fu_device_set_context(device, self->ctx);
 	if (!fu_device_probe(device, &error_local)) {
-		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
-			g_warning("failed to probe device %s: %s",
-				  fu_device_get_backend_id(device),
-				  error_local->message);
-		} else if (g_getenv("FWUPD_PROBE_VERBOSE") != NULL) {
-			g_debug("failed to probe device %s : %s",
-				fu_device_get_backend_id(device),
-				error_local->message);
-		}
+		fu_engine_backend_device_probe_warning(device, error_local);
 		fu_progress_finished(progress);
+		FU_TRACE2(engine_backend_device_added_end, fu_device_get_backend_id(device), FALSE);
 		return;
 	}
 	fu_progress_step_done(progress);
@@ -7114,6 +8468,7 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 	/* can be specified using a quirk */
 	fu_engine_backend_device_added_run_plugins(self, device, fu_progress_get_child(progress));
 	fu_progress_step_done(progress);
+	FU_TRACE2(engine_backend_device_added_end, fu_device_get_backend_id(device), TRUE);
 }
 
 static void
@@ -7480,6 +8835,23 @@ fu_engine_backends_coldplug_backend_add_devices(FuEngine *self,
 	return TRUE;
 }
 
+static void
+fu_engine_backend_connect_signals(FuEngine *self, FuBackend *backend)
+{
+	g_signal_connect(FU_BACKEND(backend),
+			 "device-added",
+			 G_CALLBACK(fu_engine_backend_device_added_cb),
+			 self);
+	g_signal_connect(FU_BACKEND(backend),
+			 "device-removed",
+			 G_CALLBACK(fu_engine_backend_device_removed_cb),
+			 self);
+	g_signal_connect(FU_BACKEND(backend),
+			 "device-changed",
+			 G_CALLBACK(fu_engine_backend_device_changed_cb),
+			 self);
+}
+
 static gboolean
 fu_engine_backends_coldplug_backend(FuEngine *self,
 				    FuBackend *backend,
@@ -7506,24 +8878,169 @@ fu_engine_backends_coldplug_backend(FuEngine *self,
 	fu_progress_step_done(progress);
 
 	/* success */
-	g_signal_connect(FU_BACKEND(backend),
-			 "device-added",
-			 G_CALLBACK(fu_engine_backend_device_added_cb),
-			 self);
-	g_signal_connect(FU_BACKEND(backend),
-			 "device-removed",
-			 G_CALLBACK(fu_engine_backend_device_removed_cb),
-			 self);
-	g_signal_connect(FU_BACKEND(backend),
-			 "device-changed",
-			 G_CALLBACK(fu_engine_backend_device_changed_cb),
-			 self);
+	fu_engine_backend_connect_signals(self, backend);
 	return TRUE;
 }
 
+typedef struct {
+	FuDevice *device;
+	GError *error;	 /* (nullable) */
+	gdouble elapsed; /* s */
+} FuEngineColdplugHelper;
+
+static void
+fu_engine_coldplug_helper_free(FuEngineColdplugHelper *helper)
+{
+	if (helper->error != NULL)
+		g_error_free(helper->error);
+	g_object_unref(helper->device);
+	g_free(helper);
+}
+
+/* runs in a worker thread, the baseclass ->probe() only parses attributes and matches quirks --
+ * udev devices are always probed on the main thread as GUdev and libudev are not thread safe */
+static void
+fu_engine_coldplug_helper_probe_cb(gpointer data, gpointer user_data)
+{
+	FuEngineColdplugHelper *helper = (FuEngineColdplugHelper *)data;
+	g_autoptr(GTimer) timer = g_timer_new();
+	(void)fu_device_probe(helper->device, &helper->error);
+	helper->elapsed = g_timer_elapsed(timer, NULL);
+}
+
+static GThreadPool *
+fu_engine_coldplug_pool_new(FuEngine *self)
+{
+#if LIBXMLB_CHECK_VERSION(0, 3, 0)
+	GThreadPool *pool;
+	g_autoptr(GError) error_local = NULL;
+	pool = g_thread_pool_new(fu_engine_coldplug_helper_probe_cb,
+				 self,
+				 (gint)g_get_num_processors(),
+				 FALSE,
+				 &error_local);
+	if (pool == NULL)
+		g_debug("failed to create thread pool, probing now: %s", error_local->message);
+	return pool;
+#else
+	/* quirk matching binds values to a shared XbQuery */
+	g_debug("libxmlb too old for concurrent quirk queries, probing now");
+	return NULL;
+#endif
+}
+
+/* the backends enumerate on the main thread, and the devices of each backend are probed on
+ * the thread pool while the next backend enumerates -- the plugins are then run in order */
+static void
+fu_engine_backends_coldplug_parallel(FuEngine *self, FuProgress *progress)
+{
+	GThreadPool *pool;
+	FuProgress *progress_child;
+	g_autoptr(GError) error_quirks = NULL;
+	g_autoptr(GPtrArray) backends = g_ptr_array_new();
+	g_autoptr(GPtrArray) helpers =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_coldplug_helper_free);
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_NO_PROFILE);
+	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 20, "coldplug");
+	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 80, "add-devices");
+
+	/* rebuild the quirk silo now if required, rather than from the first worker */
+	if (!fu_context_ensure_quirks(self->ctx, &error_quirks))
+		g_warning("failed to load quirks: %s", error_quirks->message);
+
+	/* if this fails then probe each device as it is found */
+	pool = fu_engine_coldplug_pool_new(self);
+
+	progress_child = fu_progress_get_child(progress);
+	fu_progress_set_id(progress_child, G_STRLOC);
+	fu_progress_set_steps(progress_child, self->backends->len);
+	for (guint i = 0; i < self->backends->len; i++) {
+		FuBackend *backend = g_ptr_array_index(self->backends, i);
+		g_autoptr(GError) error_backend = NULL;
+		g_autoptr(GPtrArray) devices = NULL;
+
+		if (!fu_backend_get_enabled(backend)) {
+			fu_progress_step_done(progress_child);
+			continue;
+		}
+		if (!fu_backend_coldplug(backend,
+					 fu_progress_get_child(progress_child),
+					 &error_backend)) {
+			g_warning("failed to coldplug backend %s: %s",
+				  fu_backend_get_name(backend),
+				  error_backend->message);
+			fu_progress_step_done(progress_child);
+			continue;
+		}
+		g_ptr_array_add(backends, backend);
+
+		devices = fu_backend_get_devices(backend);
+		for (guint j = 0; j < devices->len; j++) {
+			FuDevice *device = g_ptr_array_index(devices, j);
+			FuEngineColdplugHelper *helper = g_new0(FuEngineColdplugHelper, 1);
+			g_autoptr(GError) error_local = NULL;
+
+			fu_device_set_context(device, self->ctx);
+			helper->device = g_object_ref(device);
+			g_ptr_array_add(helpers, helper);
+			if (pool == NULL || FU_IS_UDEV_DEVICE(device)) {
+				fu_engine_coldplug_helper_probe_cb(helper, self);
+				continue;
+			}
+			if (!g_thread_pool_push(pool, helper, &error_local)) {
+				g_debug("failed to push to thread pool, probing now: %s",
+					error_local->message);
+				fu_engine_coldplug_helper_probe_cb(helper, self);
+			}
+		}
+		fu_progress_step_done(progress_child);
+	}
+	if (pool != NULL)
+		g_thread_pool_free(pool, FALSE, TRUE);
+	g_debug("enumerated and probed %u devices in %.0fms",
+		helpers->len,
+		g_timer_elapsed(timer, NULL) * 1000.f);
+	fu_progress_step_done(progress);
+
+	/* the plugins are not thread-safe, so add the devices on the main thread */
+	progress_child = fu_progress_get_child(progress);
+	fu_progress_set_id(progress_child, G_STRLOC);
+	fu_progress_set_steps(progress_child, helpers->len);
+	for (guint i = 0; i < helpers->len; i++) {
+		FuEngineColdplugHelper *helper = g_ptr_array_index(helpers, i);
+		if (helper->error != NULL) {
+			fu_engine_backend_device_probe_warning(helper->device, helper->error);
+			fu_progress_step_done(progress_child);
+			continue;
+		}
+		g_timer_reset(timer);
+		fu_engine_backend_device_added(self,
+					       helper->device,
+					       fu_progress_get_child(progress_child));
+		g_debug("%s probe took %.1fms, plugins took %.1fms",
+			fu_device_get_backend_id(helper->device),
+			helper->elapsed * 1000.f,
+			g_timer_elapsed(timer, NULL) * 1000.f);
+		fu_progress_step_done(progress_child);
+	}
+	for (guint i = 0; i < backends->len; i++) {
+		FuBackend *backend = g_ptr_array_index(backends, i);
+		fu_engine_backend_connect_signals(self, backend);
+	}
+	fu_progress_step_done(progress);
+}
+
 static void
 fu_engine_backends_coldplug(FuEngine *self, FuProgress *progress)
 {
+	if (fu_config_get_parallel_coldplug(self->config)) {
+		fu_engine_backends_coldplug_parallel(self, progress);
+		return;
+	}
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, self->backends->len);
 	for (guint i = 0; i < self->backends->len; i++) {
@@ -8055,6 +9572,7 @@ fu_engine_init(FuEngine *self)
 	self->host_security_attrs = fu_security_attrs_new();
 	self->backends = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->local_monitors = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	self->silos = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->runtime_versions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	self->compile_versions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	self->acquiesce_loop = g_main_loop_new(NULL, FALSE);
@@ -8171,10 +9689,7 @@ fu_engine_finalize(GObject *obj)
 		g_file_monitor_cancel(monitor);
 	}
 
-	if (self->silo != NULL)
-		g_object_unref(self->silo);
-	if (self->query_component_by_guid != NULL)
-		g_object_unref(self->query_component_by_guid);
+	g_ptr_array_unref(self->silos);
 	if (self->coldplug_id != 0)
 		g_source_remove(self->coldplug_id);
 	if (self->approved_firmware != NULL)
@@ -8198,6 +9713,7 @@ fu_engine_finalize(GObject *obj)
 	g_ptr_array_unref(self->plugin_filter);
 	g_ptr_array_unref(self->backends);
 	g_ptr_array_unref(self->local_monitors);
+	g_mutex_clear(&self->plugin_events_mutex);
 	g_hash_table_unref(self->runtime_versions);
 	g_hash_table_unref(self->compile_versions);
 	g_object_unref(self->plugin_list);
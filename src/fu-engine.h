@@ -107,6 +107,8 @@ FuSecurityAttrs *
 fu_engine_get_host_security_events(FuEngine *self, guint limit, GError **error);
 GHashTable *
 fu_engine_get_report_metadata(FuEngine *self, GError **error);
+GHashTable *
+fu_engine_get_device_stats(FuEngine *self, const gchar *device_id, GError **error);
 gboolean
 fu_engine_clear_results(FuEngine *self, const gchar *device_id, GError **error);
 gboolean
@@ -217,6 +219,8 @@ fu_engine_add_device(FuEngine *self, FuDevice *device);
 void
 fu_engine_add_plugin(FuEngine *self, FuPlugin *plugin);
 void
+fu_engine_plugins_setup(FuEngine *self, FuProgress *progress);
+void
 fu_engine_add_runtime_version(FuEngine *self, const gchar *component_id, const gchar *version);
 GPtrArray *
 fu_engine_get_details_for_bytes(FuEngine *self,
@@ -22,7 +22,7 @@
 #include "fu-mutex.h"
 #include "fu-security-attr-common.h"
 
-#define FU_HISTORY_CURRENT_SCHEMA_VERSION 8
+#define FU_HISTORY_CURRENT_SCHEMA_VERSION 10
 
 static void
 fu_history_finalize(GObject *object);
@@ -32,6 +32,8 @@ struct _FuHistory {
 #ifdef HAVE_SQLITE
 	sqlite3 *db;
 	GRWLock db_mutex;
+	GHashTable *stmts; /* (element-type utf8 sqlite3_stmt) */
+	GMutex stmts_mutex;
 #endif
 };
 
@@ -43,6 +45,77 @@ G_DEFINE_TYPE(FuHistory, fu_history, G_TYPE_OBJECT)
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(sqlite3_stmt, sqlite3_finalize);
 #pragma clang diagnostic pop
 
+/* a prepared statement borrowed from the cache, returned when freed */
+typedef struct {
+	FuHistory *self;
+	const gchar *sql;
+	sqlite3_stmt *stmt;
+} FuHistoryStmt;
+
+static FuHistoryStmt *
+fu_history_stmt_acquire(FuHistory *self, const gchar *sql, GError **error)
+{
+	gint rc;
+	sqlite3_stmt *stmt = NULL;
+	FuHistoryStmt *helper;
+
+	/* reuse an idle statement, which is already compiled */
+	g_mutex_lock(&self->stmts_mutex);
+	stmt = g_hash_table_lookup(self->stmts, sql);
+	if (stmt != NULL)
+		g_hash_table_steal(self->stmts, sql);
+	g_mutex_unlock(&self->stmts_mutex);
+	if (stmt == NULL) {
+		rc = sqlite3_prepare_v2(self->db, sql, -1, &stmt, NULL);
+		if (rc != SQLITE_OK) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    sqlite3_errmsg(self->db));
+			return NULL;
+		}
+	}
+	helper = g_new0(FuHistoryStmt, 1);
+	helper->self = self;
+	helper->sql = sql;
+	helper->stmt = stmt;
+	return helper;
+}
+
+static void
+fu_history_stmt_release(FuHistoryStmt *helper)
+{
+	FuHistory *self = helper->self;
+
+	/* make idle again, and do not hold references to the bound data */
+	sqlite3_reset(helper->stmt);
+	sqlite3_clear_bindings(helper->stmt);
+
+	/* the same statement may be in use by more than one reader */
+	g_mutex_lock(&self->stmts_mutex);
+	if (!g_hash_table_contains(self->stmts, helper->sql)) {
+		g_hash_table_insert(self->stmts, (gpointer)helper->sql, helper->stmt);
+		helper->stmt = NULL;
+	}
+	g_mutex_unlock(&self->stmts_mutex);
+	if (helper->stmt != NULL)
+		sqlite3_finalize(helper->stmt);
+	g_free(helper);
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wunused-function"
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuHistoryStmt, fu_history_stmt_release);
+#pragma clang diagnostic pop
+
+static void
+fu_history_stmt_clear(FuHistory *self)
+{
+	g_mutex_lock(&self->stmts_mutex);
+	g_hash_table_remove_all(self->stmts);
+	g_mutex_unlock(&self->stmts_mutex);
+}
+
 static FuDevice *
 fu_history_device_from_stmt(sqlite3_stmt *stmt)
 {
@@ -162,6 +235,37 @@ fu_history_stmt_exec(FuHistory *self, sqlite3_stmt *stmt, GPtrArray *array, GErr
 	return TRUE;
 }
 
+static gboolean
+fu_history_create_indexes(FuHistory *self, GError **error)
+{
+	gint rc;
+	rc = sqlite3_exec(self->db,
+			  "BEGIN TRANSACTION;"
+			  "CREATE INDEX IF NOT EXISTS history_device_id "
+			  "ON history (device_id, device_created);"
+			  "CREATE INDEX IF NOT EXISTS history_device_modified "
+			  "ON history (device_modified);"
+			  "CREATE INDEX IF NOT EXISTS approved_firmware_checksum "
+			  "ON approved_firmware (checksum);"
+			  "CREATE INDEX IF NOT EXISTS blocked_firmware_checksum "
+			  "ON blocked_firmware (checksum);"
+			  "CREATE INDEX IF NOT EXISTS hsi_history_timestamp "
+			  "ON hsi_history (timestamp);"
+			  "COMMIT;",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to create indexes: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_history_create_database(FuHistory *self, GError **error)
 {
@@ -198,6 +302,11 @@ fu_history_create_database(FuHistory *self, GError **error)
 			  "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
 			  "hsi_details TEXT DEFAULT NULL,"
 			  "hsi_score TEXT DEFAULT NULL);"
+			  "CREATE TABLE IF NOT EXISTS io_stats ("
+			  "device_id TEXT,"
+			  "kind TEXT,"
+			  "value TEXT,"
+			  "PRIMARY KEY (device_id, kind));"
 			  "COMMIT;",
 			  NULL,
 			  NULL,
@@ -210,7 +319,7 @@ fu_history_create_database(FuHistory *self, GError **error)
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
-	return TRUE;
+	return fu_history_create_indexes(self, error);
 }
 
 static gboolean
@@ -359,6 +468,36 @@ fu_history_migrate_database_v7(FuHistory *self, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_history_migrate_database_v8(FuHistory *self, GError **error)
+{
+	return fu_history_create_indexes(self, error);
+}
+
+static gboolean
+fu_history_migrate_database_v9(FuHistory *self, GError **error)
+{
+	gint rc;
+	rc = sqlite3_exec(self->db,
+			  "CREATE TABLE IF NOT EXISTS io_stats ("
+			  "device_id TEXT,"
+			  "kind TEXT,"
+			  "value TEXT,"
+			  "PRIMARY KEY (device_id, kind));",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to create table: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 /* returns 0 if database is not initialized */
 static guint
 fu_history_get_schema_version(FuHistory *self)
@@ -423,6 +562,14 @@ fu_history_create_or_migrate(FuHistory *self, guint schema_ver, GError **error)
 	case 7:
 		if (!fu_history_migrate_database_v7(self, error))
 			return FALSE;
+	/* fall through */
+	case 8:
+		if (!fu_history_migrate_database_v8(self, error))
+			return FALSE;
+	/* fall through */
+	case 9:
+		if (!fu_history_migrate_database_v9(self, error))
+			return FALSE;
 		break;
 	default:
 		/* this is probably okay, but return an error if we ever delete
@@ -463,6 +610,16 @@ fu_history_open(FuHistory *self, const gchar *filename, GError **error)
 
 	/* turn off the lookaside cache */
 	sqlite3_db_config(self->db, SQLITE_DBCONFIG_LOOKASIDE, NULL, 0, 0);
+
+	/* writers do not block readers, and only the WAL checkpoint needs a full sync */
+	rc = sqlite3_exec(self->db,
+			  "PRAGMA journal_mode=WAL;"
+			  "PRAGMA synchronous=NORMAL;",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK)
+		g_debug("ignoring database error: %s", sqlite3_errmsg(self->db));
 	return TRUE;
 }
 
@@ -515,12 +672,18 @@ fu_history_load(FuHistory *self, GError **error)
 	if (schema_ver != FU_HISTORY_CURRENT_SCHEMA_VERSION) {
 		g_autoptr(GError) error_migrate = NULL;
 		if (!fu_history_create_or_migrate(self, schema_ver, &error_migrate)) {
+			g_autofree gchar *filename_wal = g_strdup_printf("%s-wal", filename);
+			g_autofree gchar *filename_shm = g_strdup_printf("%s-shm", filename);
+
 			/* this is fatal to the daemon, so delete the database
 			 * and try again with something empty */
 			g_warning("failed to migrate %s database: %s",
 				  filename,
 				  error_migrate->message);
+			fu_history_stmt_clear(self);
 			sqlite3_close(self->db);
+			(void)g_unlink(filename_wal);
+			(void)g_unlink(filename_shm);
 			if (g_unlink(filename) != 0) {
 				g_set_error(error,
 					    FWUPD_ERROR,
@@ -563,6 +726,150 @@ fu_history_get_device_flags_filtered(FuDevice *device)
 	flags &= ~FWUPD_DEVICE_FLAG_SUPPORTED;
 	return flags;
 }
+
+static gboolean
+fu_history_exec(FuHistory *self, const gchar *sql, GError **error)
+{
+	gint rc = sqlite3_exec(self->db, sql, NULL, NULL, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to execute %s: %s",
+			    sql,
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* called with the writer lock held */
+static gboolean
+fu_history_remove_io_stats_id(FuHistory *self, const gchar *device_id, GError **error)
+{
+	g_autoptr(FuHistoryStmt) helper = NULL;
+
+	helper = fu_history_stmt_acquire(self, "DELETE FROM io_stats WHERE device_id = ?1;", error);
+	if (helper == NULL) {
+		g_prefix_error(error, "Failed to prepare SQL to delete I/O stats: ");
+		return FALSE;
+	}
+	sqlite3_bind_text(helper->stmt, 1, device_id, -1, SQLITE_STATIC);
+	return fu_history_stmt_exec(self, helper->stmt, NULL, error);
+}
+
+/* called with the writer lock held */
+static gboolean
+fu_history_remove_device_id(FuHistory *self, const gchar *device_id, GError **error)
+{
+	g_autoptr(FuHistoryStmt) helper = NULL;
+
+	helper = fu_history_stmt_acquire(self, "DELETE FROM history WHERE device_id = ?1;", error);
+	if (helper == NULL) {
+		g_prefix_error(error, "Failed to prepare SQL to delete history: ");
+		return FALSE;
+	}
+	sqlite3_bind_text(helper->stmt, 1, device_id, -1, SQLITE_STATIC);
+	if (!fu_history_stmt_exec(self, helper->stmt, NULL, error))
+		return FALSE;
+	return fu_history_remove_io_stats_id(self, device_id, error);
+}
+
+/* called with the writer lock held */
+static gboolean
+fu_history_insert_io_stats(FuHistory *self,
+			   const gchar *device_id,
+			   GHashTable *io_stats,
+			   GError **error)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+
+	if (!fu_history_remove_io_stats_id(self, device_id, error))
+		return FALSE;
+	g_hash_table_iter_init(&iter, io_stats);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		g_autoptr(FuHistoryStmt) helper = NULL;
+		helper = fu_history_stmt_acquire(self,
+						 "INSERT INTO io_stats (device_id, kind, value) "
+						 "VALUES (?1,?2,?3)",
+						 error);
+		if (helper == NULL) {
+			g_prefix_error(error, "Failed to prepare SQL to insert I/O stats: ");
+			return FALSE;
+		}
+		sqlite3_bind_text(helper->stmt, 1, device_id, -1, SQLITE_STATIC);
+		sqlite3_bind_text(helper->stmt, 2, key, -1, SQLITE_STATIC);
+		sqlite3_bind_text(helper->stmt, 3, value, -1, SQLITE_STATIC);
+		if (!fu_history_stmt_exec(self, helper->stmt, NULL, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+/* called with the writer lock held */
+static gboolean
+fu_history_insert_device(FuHistory *self, FuDevice *device, FwupdRelease *release, GError **error)
+{
+	const gchar *checksum_device;
+	const gchar *checksum = NULL;
+	g_autofree gchar *metadata = NULL;
+	g_autoptr(FuHistoryStmt) helper = NULL;
+
+	g_debug("add device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
+	if (release != NULL) {
+		GPtrArray *checksums = fwupd_release_get_checksums(release);
+		checksum = fwupd_checksum_get_by_kind(checksums, G_CHECKSUM_SHA1);
+	}
+	checksum_device =
+	    fwupd_checksum_get_by_kind(fu_device_get_checksums(device), G_CHECKSUM_SHA1);
+
+	/* metadata is stored as a simple string */
+	metadata = _convert_hash_to_string(fwupd_release_get_metadata(release));
+
+	/* add */
+	helper = fu_history_stmt_acquire(self,
+					 "INSERT INTO history (device_id,"
+					 "update_state,"
+					 "update_error,"
+					 "flags,"
+					 "filename,"
+					 "checksum,"
+					 "display_name,"
+					 "plugin,"
+					 "guid_default,"
+					 "metadata,"
+					 "device_created,"
+					 "device_modified,"
+					 "version_old,"
+					 "version_new,"
+					 "checksum_device,"
+					 "protocol) "
+					 "VALUES (?1,?2,?3,?4,?5,?6,?7,?8,?9,?10,"
+					 "?11,?12,?13,?14,?15,?16)",
+					 error);
+	if (helper == NULL) {
+		g_prefix_error(error, "Failed to prepare SQL to insert history: ");
+		return FALSE;
+	}
+	sqlite3_bind_text(helper->stmt, 1, fu_device_get_id(device), -1, SQLITE_STATIC);
+	sqlite3_bind_int(helper->stmt, 2, fu_device_get_update_state(device));
+	sqlite3_bind_text(helper->stmt, 3, fu_device_get_update_error(device), -1, SQLITE_STATIC);
+	sqlite3_bind_int64(helper->stmt, 4, fu_history_get_device_flags_filtered(device));
+	sqlite3_bind_text(helper->stmt, 5, fwupd_release_get_filename(release), -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 6, checksum, -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 7, fu_device_get_name(device), -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 8, fu_device_get_plugin(device), -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 9, fu_device_get_guid_default(device), -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 10, metadata, -1, SQLITE_STATIC);
+	sqlite3_bind_int64(helper->stmt, 11, fu_device_get_created(device));
+	sqlite3_bind_int64(helper->stmt, 12, fu_device_get_modified(device));
+	sqlite3_bind_text(helper->stmt, 13, fu_device_get_version(device), -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 14, fwupd_release_get_version(release), -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 15, checksum_device, -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 16, fwupd_release_get_protocol(release), -1, SQLITE_STATIC);
+	return fu_history_stmt_exec(self, helper->stmt, NULL, error);
+}
 #endif
 
 /**
@@ -581,8 +888,7 @@ gboolean
 fu_history_modify_device(FuHistory *self, FuDevice *device, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(FuHistoryStmt) helper = NULL;
 	g_autoptr(GRWLockWriterLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
@@ -596,40 +902,34 @@ fu_history_modify_device(FuHistory *self, FuDevice *device, GError **error)
 	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("modifying device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
-	rc = sqlite3_prepare_v2(self->db,
-				"UPDATE history SET "
-				"update_state = ?1, "
-				"update_error = ?2, "
-				"checksum_device = ?6, "
-				"device_modified = ?7, "
-				"flags = ?3 "
-				"WHERE device_id = ?4;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "Failed to prepare SQL to update history: %s",
-			    sqlite3_errmsg(self->db));
+	helper = fu_history_stmt_acquire(self,
+					 "UPDATE history SET "
+					 "update_state = ?1, "
+					 "update_error = ?2, "
+					 "checksum_device = ?6, "
+					 "device_modified = ?7, "
+					 "flags = ?3 "
+					 "WHERE device_id = ?4;",
+					 error);
+	if (helper == NULL) {
+		g_prefix_error(error, "Failed to prepare SQL to update history: ");
 		return FALSE;
 	}
 
-	sqlite3_bind_int(stmt, 1, fu_device_get_update_state(device));
-	sqlite3_bind_text(stmt, 2, fu_device_get_update_error(device), -1, SQLITE_STATIC);
-	sqlite3_bind_int64(stmt, 3, fu_history_get_device_flags_filtered(device));
-	sqlite3_bind_text(stmt, 4, fu_device_get_id(device), -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 5, fu_device_get_version(device), -1, SQLITE_STATIC);
+	sqlite3_bind_int(helper->stmt, 1, fu_device_get_update_state(device));
+	sqlite3_bind_text(helper->stmt, 2, fu_device_get_update_error(device), -1, SQLITE_STATIC);
+	sqlite3_bind_int64(helper->stmt, 3, fu_history_get_device_flags_filtered(device));
+	sqlite3_bind_text(helper->stmt, 4, fu_device_get_id(device), -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 5, fu_device_get_version(device), -1, SQLITE_STATIC);
 	sqlite3_bind_text(
-	    stmt,
+	    helper->stmt,
 	    6,
 	    fwupd_checksum_get_by_kind(fu_device_get_checksums(device), G_CHECKSUM_SHA1),
 	    -1,
 	    SQLITE_STATIC);
-	sqlite3_bind_int64(stmt, 7, fu_device_get_modified(device));
+	sqlite3_bind_int64(helper->stmt, 7, fu_device_get_modified(device));
 
-	return fu_history_stmt_exec(self, stmt, NULL, error);
+	return fu_history_stmt_exec(self, helper->stmt, NULL, error);
 #else
 	return TRUE;
 #endif
@@ -655,10 +955,9 @@ fu_history_set_device_metadata(FuHistory *self,
 			       GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
 	g_autofree gchar *metadata_str = NULL;
 	g_autoptr(GRWLockWriterLocker) locker = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(FuHistoryStmt) helper = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(device_id != NULL, FALSE);
@@ -671,33 +970,132 @@ fu_history_set_device_metadata(FuHistory *self,
 	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("modifying %s", device_id);
-	rc = sqlite3_prepare_v2(self->db,
-				"UPDATE history SET "
-				"metadata = ?1 "
-				"WHERE device_id = ?2;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "failed to prepare SQL to update history: %s",
-			    sqlite3_errmsg(self->db));
+	helper = fu_history_stmt_acquire(self,
+					 "UPDATE history SET "
+					 "metadata = ?1 "
+					 "WHERE device_id = ?2;",
+					 error);
+	if (helper == NULL) {
+		g_prefix_error(error, "failed to prepare SQL to update history: ");
 		return FALSE;
 	}
 
 	/* metadata is stored as a simple string */
 	metadata_str = _convert_hash_to_string(metadata);
-	sqlite3_bind_text(stmt, 1, metadata_str, -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 2, device_id, -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 1, metadata_str, -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 2, device_id, -1, SQLITE_STATIC);
 
-	return fu_history_stmt_exec(self, stmt, NULL, error);
+	return fu_history_stmt_exec(self, helper->stmt, NULL, error);
 #else
 	return TRUE;
 #endif
 }
 
+/**
+ * fu_history_set_device_io_stats:
+ * @self: a #FuHistory
+ * @device_id: a DeviceID string
+ * @io_stats: a #GHashTable of I/O kind:summary
+ * @error: (nullable): optional return location for an error
+ *
+ * Replaces the I/O statistics saved for a device. These are kept separate from the release
+ * metadata so that they are never included in a history report.
+ *
+ * Returns: @TRUE if successful, @FALSE for failure
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_history_set_device_io_stats(FuHistory *self,
+			       const gchar *device_id,
+			       GHashTable *io_stats,
+			       GError **error)
+{
+#ifdef HAVE_SQLITE
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(device_id != NULL, FALSE);
+	g_return_val_if_fail(io_stats != NULL, FALSE);
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return FALSE;
+
+	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	g_return_val_if_fail(locker != NULL, FALSE);
+	if (!fu_history_exec(self, "BEGIN TRANSACTION;", error))
+		return FALSE;
+	if (!fu_history_insert_io_stats(self, device_id, io_stats, error)) {
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_history_exec(self, "ROLLBACK;", &error_local))
+			g_debug("ignoring: %s", error_local->message);
+		return FALSE;
+	}
+	return fu_history_exec(self, "COMMIT;", error);
+#else
+	return TRUE;
+#endif
+}
+
+/**
+ * fu_history_get_device_io_stats:
+ * @self: a #FuHistory
+ * @device_id: a DeviceID string
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the I/O statistics saved for a device.
+ *
+ * Returns: (transfer container): a #GHashTable of I/O kind:summary, which may be empty
+ *
+ * Since: 1.8.5
+ **/
+GHashTable *
+fu_history_get_device_io_stats(FuHistory *self, const gchar *device_id, GError **error)
+{
+	g_autoptr(GHashTable) io_stats =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+#ifdef HAVE_SQLITE
+	gint rc;
+	g_autoptr(FuHistoryStmt) helper = NULL;
+	g_autoptr(GRWLockReaderLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
+	g_return_val_if_fail(device_id != NULL, NULL);
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return NULL;
+
+	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	g_return_val_if_fail(locker != NULL, NULL);
+	helper = fu_history_stmt_acquire(self,
+					 "SELECT kind, value FROM io_stats WHERE device_id = ?1;",
+					 error);
+	if (helper == NULL) {
+		g_prefix_error(error, "Failed to prepare SQL to get I/O stats: ");
+		return NULL;
+	}
+	sqlite3_bind_text(helper->stmt, 1, device_id, -1, SQLITE_STATIC);
+	while ((rc = sqlite3_step(helper->stmt)) == SQLITE_ROW) {
+		const gchar *kind = (const gchar *)sqlite3_column_text(helper->stmt, 0);
+		const gchar *value = (const gchar *)sqlite3_column_text(helper->stmt, 1);
+		if (kind == NULL || value == NULL)
+			continue;
+		g_hash_table_insert(io_stats, g_strdup(kind), g_strdup(value));
+	}
+	if (rc != SQLITE_DONE) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to execute prepared statement: %s",
+			    sqlite3_errmsg(self->db));
+		return NULL;
+	}
+#endif
+	return g_steal_pointer(&io_stats);
+}
+
 /**
  * fu_history_add_device:
  * @self: a #FuHistory
@@ -715,11 +1113,6 @@ gboolean
 fu_history_add_device(FuHistory *self, FuDevice *device, FwupdRelease *release, GError **error)
 {
 #ifdef HAVE_SQLITE
-	const gchar *checksum_device;
-	const gchar *checksum = NULL;
-	gint rc;
-	g_autofree gchar *metadata = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
 	g_autoptr(GRWLockWriterLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
@@ -730,70 +1123,19 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FwupdRelease *release,
 	if (!fu_history_load(self, error))
 		return FALSE;
 
-	/* ensure all old device(s) with this ID are removed */
-	if (!fu_history_remove_device(self, device, error))
-		return FALSE;
-	g_debug("add device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
-	if (release != NULL) {
-		GPtrArray *checksums = fwupd_release_get_checksums(release);
-		checksum = fwupd_checksum_get_by_kind(checksums, G_CHECKSUM_SHA1);
-	}
-	checksum_device =
-	    fwupd_checksum_get_by_kind(fu_device_get_checksums(device), G_CHECKSUM_SHA1);
-
-	/* metadata is stored as a simple string */
-	metadata = _convert_hash_to_string(fwupd_release_get_metadata(release));
-
-	/* add */
+	/* ensure all old device(s) with this ID are removed in the same transaction */
 	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
-	rc = sqlite3_prepare_v2(self->db,
-				"INSERT INTO history (device_id,"
-				"update_state,"
-				"update_error,"
-				"flags,"
-				"filename,"
-				"checksum,"
-				"display_name,"
-				"plugin,"
-				"guid_default,"
-				"metadata,"
-				"device_created,"
-				"device_modified,"
-				"version_old,"
-				"version_new,"
-				"checksum_device,"
-				"protocol) "
-				"VALUES (?1,?2,?3,?4,?5,?6,?7,?8,?9,?10,"
-				"?11,?12,?13,?14,?15,?16)",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "Failed to prepare SQL to insert history: %s",
-			    sqlite3_errmsg(self->db));
+	if (!fu_history_exec(self, "BEGIN TRANSACTION;", error))
+		return FALSE;
+	if (!fu_history_remove_device_id(self, fu_device_get_id(device), error) ||
+	    !fu_history_insert_device(self, device, release, error)) {
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_history_exec(self, "ROLLBACK;", &error_local))
+			g_debug("ignoring: %s", error_local->message);
 		return FALSE;
 	}
-	sqlite3_bind_text(stmt, 1, fu_device_get_id(device), -1, SQLITE_STATIC);
-	sqlite3_bind_int(stmt, 2, fu_device_get_update_state(device));
-	sqlite3_bind_text(stmt, 3, fu_device_get_update_error(device), -1, SQLITE_STATIC);
-	sqlite3_bind_int64(stmt, 4, fu_history_get_device_flags_filtered(device));
-	sqlite3_bind_text(stmt, 5, fwupd_release_get_filename(release), -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 6, checksum, -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 7, fu_device_get_name(device), -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 8, fu_device_get_plugin(device), -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 9, fu_device_get_guid_default(device), -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 10, metadata, -1, SQLITE_STATIC);
-	sqlite3_bind_int64(stmt, 11, fu_device_get_created(device));
-	sqlite3_bind_int64(stmt, 12, fu_device_get_modified(device));
-	sqlite3_bind_text(stmt, 13, fu_device_get_version(device), -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 14, fwupd_release_get_version(release), -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 15, checksum_device, -1, SQLITE_STATIC);
-	sqlite3_bind_text(stmt, 16, fwupd_release_get_protocol(release), -1, SQLITE_STATIC);
-	return fu_history_stmt_exec(self, stmt, NULL, error);
+	return fu_history_exec(self, "COMMIT;", error);
 #else
 	return TRUE;
 #endif
@@ -837,7 +1179,9 @@ fu_history_remove_all(FuHistory *self, GError **error)
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
-	return fu_history_stmt_exec(self, stmt, NULL, error);
+	if (!fu_history_stmt_exec(self, stmt, NULL, error))
+		return FALSE;
+	return fu_history_exec(self, "DELETE FROM io_stats;", error);
 #else
 	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
 	return FALSE;
@@ -860,8 +1204,6 @@ gboolean
 fu_history_remove_device(FuHistory *self, FuDevice *device, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
 	g_autoptr(GRWLockWriterLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
@@ -874,21 +1216,7 @@ fu_history_remove_device(FuHistory *self, FuDevice *device, GError **error)
 	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("remove device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
-	rc = sqlite3_prepare_v2(self->db,
-				"DELETE FROM history WHERE device_id = ?1;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "Failed to prepare SQL to delete history: %s",
-			    sqlite3_errmsg(self->db));
-		return FALSE;
-	}
-	sqlite3_bind_text(stmt, 1, fu_device_get_id(device), -1, SQLITE_STATIC);
-	return fu_history_stmt_exec(self, stmt, NULL, error);
+	return fu_history_remove_device_id(self, fu_device_get_id(device), error);
 #else
 	return TRUE;
 #endif
@@ -910,9 +1238,8 @@ FuDevice *
 fu_history_get_device_by_id(FuHistory *self, const gchar *device_id, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
 	g_autoptr(GPtrArray) array_tmp = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(FuHistoryStmt) helper = NULL;
 	g_autoptr(GRWLockReaderLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
@@ -925,39 +1252,33 @@ fu_history_get_device_by_id(FuHistory *self, const gchar *device_id, GError **er
 	/* get all the devices */
 	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
-	rc = sqlite3_prepare_v2(self->db,
-				"SELECT device_id, "
-				"checksum, "
-				"plugin, "
-				"device_created, "
-				"device_modified, "
-				"display_name, "
-				"filename, "
-				"flags, "
-				"metadata, "
-				"guid_default, "
-				"update_state, "
-				"update_error, "
-				"version_new, "
-				"version_old, "
-				"checksum_device, "
-				"protocol FROM history WHERE "
-				"device_id = ?1 ORDER BY device_created DESC "
-				"LIMIT 1",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "Failed to prepare SQL to get history: %s",
-			    sqlite3_errmsg(self->db));
+	helper = fu_history_stmt_acquire(self,
+					 "SELECT device_id, "
+					 "checksum, "
+					 "plugin, "
+					 "device_created, "
+					 "device_modified, "
+					 "display_name, "
+					 "filename, "
+					 "flags, "
+					 "metadata, "
+					 "guid_default, "
+					 "update_state, "
+					 "update_error, "
+					 "version_new, "
+					 "version_old, "
+					 "checksum_device, "
+					 "protocol FROM history WHERE "
+					 "device_id = ?1 ORDER BY device_created DESC "
+					 "LIMIT 1",
+					 error);
+	if (helper == NULL) {
+		g_prefix_error(error, "Failed to prepare SQL to get history: ");
 		return NULL;
 	}
-	sqlite3_bind_text(stmt, 1, device_id, -1, SQLITE_STATIC);
+	sqlite3_bind_text(helper->stmt, 1, device_id, -1, SQLITE_STATIC);
 	array_tmp = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
-	if (!fu_history_stmt_exec(self, stmt, array_tmp, error))
+	if (!fu_history_stmt_exec(self, helper->stmt, array_tmp, error))
 		return NULL;
 	if (array_tmp->len == 0) {
 		g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "No devices found");
@@ -1055,7 +1376,7 @@ fu_history_get_approved_firmware(FuHistory *self, GError **error)
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(GRWLockReaderLocker) locker = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(FuHistoryStmt) helper = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1068,21 +1389,15 @@ fu_history_get_approved_firmware(FuHistory *self, GError **error)
 	/* get all the approved firmware */
 	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
-	rc = sqlite3_prepare_v2(self->db,
-				"SELECT checksum FROM approved_firmware;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "Failed to prepare SQL to get checksum: %s",
-			    sqlite3_errmsg(self->db));
+	helper = fu_history_stmt_acquire(self,
+					 "SELECT checksum FROM approved_firmware ORDER BY rowid;",
+					 error);
+	if (helper == NULL) {
+		g_prefix_error(error, "Failed to prepare SQL to get checksum: ");
 		return NULL;
 	}
-	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-		const gchar *tmp = (const gchar *)sqlite3_column_text(stmt, 0);
+	while ((rc = sqlite3_step(helper->stmt)) == SQLITE_ROW) {
+		const gchar *tmp = (const gchar *)sqlite3_column_text(helper->stmt, 0);
 		g_ptr_array_add(array, g_strdup(tmp));
 	}
 	if (rc != SQLITE_DONE) {
@@ -1211,7 +1526,7 @@ fu_history_get_blocked_firmware(FuHistory *self, GError **error)
 #ifdef HAVE_SQLITE
 	gint rc;
 	g_autoptr(GRWLockReaderLocker) locker = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(FuHistoryStmt) helper = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1224,18 +1539,15 @@ fu_history_get_blocked_firmware(FuHistory *self, GError **error)
 	/* get all the blocked firmware */
 	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
-	rc =
-	    sqlite3_prepare_v2(self->db, "SELECT checksum FROM blocked_firmware;", -1, &stmt, NULL);
-	if (rc != SQLITE_OK) {
-		g_set_error(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_INTERNAL,
-			    "Failed to prepare SQL to get checksum: %s",
-			    sqlite3_errmsg(self->db));
+	helper = fu_history_stmt_acquire(self,
+					 "SELECT checksum FROM blocked_firmware ORDER BY rowid;",
+					 error);
+	if (helper == NULL) {
+		g_prefix_error(error, "Failed to prepare SQL to get checksum: ");
 		return NULL;
 	}
-	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-		const gchar *tmp = (const gchar *)sqlite3_column_text(stmt, 0);
+	while ((rc = sqlite3_step(helper->stmt)) == SQLITE_ROW) {
+		const gchar *tmp = (const gchar *)sqlite3_column_text(helper->stmt, 0);
 		g_ptr_array_add(array, g_strdup(tmp));
 	}
 	if (rc != SQLITE_DONE) {
@@ -1346,6 +1658,75 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 #endif
 }
 
+#ifdef HAVE_SQLITE
+/* called with the writer lock held */
+static gboolean
+fu_history_replace_blocked_firmware(FuHistory *self, GPtrArray *checksums, GError **error)
+{
+	if (!fu_history_exec(self, "DELETE FROM blocked_firmware;", error))
+		return FALSE;
+	for (guint i = 0; i < checksums->len; i++) {
+		const gchar *csum = g_ptr_array_index(checksums, i);
+		g_autoptr(FuHistoryStmt) helper = NULL;
+		helper = fu_history_stmt_acquire(self,
+						 "INSERT INTO blocked_firmware (checksum) "
+						 "VALUES (?1)",
+						 error);
+		if (helper == NULL) {
+			g_prefix_error(error, "Failed to prepare SQL to insert checksum: ");
+			return FALSE;
+		}
+		sqlite3_bind_text(helper->stmt, 1, csum, -1, SQLITE_STATIC);
+		if (!fu_history_stmt_exec(self, helper->stmt, NULL, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+#endif
+
+/**
+ * fu_history_set_blocked_firmware:
+ * @self: a #FuHistory
+ * @checksums: (element-type utf8): checksums
+ * @error: (nullable): optional return location for an error
+ *
+ * Replaces all the blocked firmware records in one transaction.
+ *
+ * Returns: #TRUE for success, #FALSE for failure
+ *
+ * Since: 1.8.5
+ **/
+gboolean
+fu_history_set_blocked_firmware(FuHistory *self, GPtrArray *checksums, GError **error)
+{
+#ifdef HAVE_SQLITE
+	g_autoptr(GRWLockWriterLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(checksums != NULL, FALSE);
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return FALSE;
+
+	/* a single sync rather than one for each checksum */
+	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	g_return_val_if_fail(locker != NULL, FALSE);
+	if (!fu_history_exec(self, "BEGIN TRANSACTION;", error))
+		return FALSE;
+	if (!fu_history_replace_blocked_firmware(self, checksums, error)) {
+		g_autoptr(GError) error_local = NULL;
+		if (!fu_history_exec(self, "ROLLBACK;", &error_local))
+			g_debug("ignoring: %s", error_local->message);
+		return FALSE;
+	}
+	return fu_history_exec(self, "COMMIT;", error);
+#else
+	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
+	return FALSE;
+#endif
+}
+
 gboolean
 fu_history_add_security_attribute(FuHistory *self,
 				  const gchar *security_attr_json,
@@ -1512,6 +1893,11 @@ fu_history_init(FuHistory *self)
 {
 #ifdef HAVE_SQLITE
 	g_rw_lock_init(&self->db_mutex);
+	g_mutex_init(&self->stmts_mutex);
+	self->stmts = g_hash_table_new_full(g_str_hash,
+					    g_str_equal,
+					    NULL,
+					    (GDestroyNotify)sqlite3_finalize);
 #endif
 }
 
@@ -1521,6 +1907,9 @@ fu_history_finalize(GObject *object)
 #ifdef HAVE_SQLITE
 	FuHistory *self = FU_HISTORY(object);
 
+	/* statements have to be finalized before the database can be closed */
+	g_hash_table_unref(self->stmts);
+	g_mutex_clear(&self->stmts_mutex);
 	g_rw_lock_clear(&self->db_mutex);
 
 	if (self->db != NULL)
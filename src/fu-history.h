@@ -24,6 +24,13 @@ fu_history_set_device_metadata(FuHistory *self,
 			       GHashTable *metadata,
 			       GError **error);
 gboolean
+fu_history_set_device_io_stats(FuHistory *self,
+			       const gchar *device_id,
+			       GHashTable *io_stats,
+			       GError **error);
+GHashTable *
+fu_history_get_device_io_stats(FuHistory *self, const gchar *device_id, GError **error);
+gboolean
 fu_history_remove_device(FuHistory *self, FuDevice *device, GError **error);
 gboolean
 fu_history_remove_all(FuHistory *self, GError **error);
@@ -42,6 +49,8 @@ gboolean
 fu_history_clear_blocked_firmware(FuHistory *self, GError **error);
 gboolean
 fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError **error);
+gboolean
+fu_history_set_blocked_firmware(FuHistory *self, GPtrArray *checksums, GError **error);
 GPtrArray *
 fu_history_get_blocked_firmware(FuHistory *self, GError **error);
 gboolean
@@ -27,6 +27,9 @@ fu_keyring_get_release_flags(XbNode *release, FwupdReleaseFlags *flags, GError *
 {
 	GBytes *blob;
 
+	/* decompress and verify the payload if not already done */
+	if (!fu_cabinet_load_release(release, error))
+		return FALSE;
 	blob = g_object_get_data(G_OBJECT(release), "fwupd::ReleaseFlags");
 	if (blob == NULL)
 		return TRUE;
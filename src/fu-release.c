@@ -892,7 +892,9 @@ fu_release_load(FuRelease *self,
 		}
 	}
 
-	/* get per-release firmware blob */
+	/* get per-release firmware blob, decompressing it if required */
+	if (!fu_cabinet_load_release(rel, error))
+		return FALSE;
 	blob_fw_tmp = xb_node_get_data(rel, "fwupd::FirmwareBlob");
 	if (blob_fw_tmp != NULL)
 		self->blob_fw = g_bytes_ref(blob_fw_tmp);
@@ -165,6 +165,240 @@ fu_engine_generate_md_func(gconstpointer user_data)
 	g_assert_cmpstr(tmp, ==, NULL);
 }
 
+static gboolean
+fu_engine_generate_md_cache_load(GError **error)
+{
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	return fu_engine_load(engine,
+			      FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_NO_CACHE,
+			      progress,
+			      error);
+}
+
+static void
+fu_engine_generate_md_cache_func(gconstpointer user_data)
+{
+	gboolean ret;
+	g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *cachedir = NULL;
+	g_autofree gchar *cache_fn = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(GBytes) data = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GFile) cab_file = NULL;
+	g_autoptr(GFile) cache_file = NULL;
+	g_autoptr(GFileInfo) info = NULL;
+	g_autoptr(GPtrArray) files = NULL;
+
+	/* put cab file somewhere we can parse it */
+	filename =
+	    g_test_build_filename(G_TEST_DIST, "tests", "colorhug", "colorhug-als-3.0.2.cab", NULL);
+	data = fu_bytes_get_contents(filename, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(data);
+	ret = fu_bytes_set_contents("/tmp/fwupd-self-test/var/cache/fwupd/foo.cab", data, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	cab_file = g_file_new_for_path("/tmp/fwupd-self-test/var/cache/fwupd/foo.cab");
+
+	/* the metainfo is cached the first time */
+	ret = fu_engine_generate_md_cache_load(&error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	cachedir = g_build_filename(cachedirpkg, "cabinets", "directory", NULL);
+	files = fu_path_get_files(cachedir, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(files);
+	g_assert_cmpint(files->len, ==, 1);
+	cache_fn = g_strdup(g_ptr_array_index(files, 0));
+	g_clear_pointer(&files, g_ptr_array_unref);
+
+	/* an unchanged archive uses the cached metainfo without rewriting it */
+	cache_file = g_file_new_for_path(cache_fn);
+	ret = g_file_set_attribute_uint64(cache_file,
+					  G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					  1,
+					  G_FILE_QUERY_INFO_NONE,
+					  NULL,
+					  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_engine_generate_md_cache_load(&error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	files = fu_path_get_files(cachedir, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(files);
+	g_assert_cmpint(files->len, ==, 1);
+	g_assert_cmpstr(g_ptr_array_index(files, 0), ==, cache_fn);
+	g_clear_pointer(&files, g_ptr_array_unref);
+	info = g_file_query_info(cache_file,
+				 G_FILE_ATTRIBUTE_TIME_MODIFIED,
+				 G_FILE_QUERY_INFO_NONE,
+				 NULL,
+				 &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(info);
+	g_assert_cmpint(g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED),
+			==,
+			1);
+
+	/* a modified archive is parsed again, and the old entry is deleted */
+	ret = g_file_set_attribute_uint64(cab_file,
+					  G_FILE_ATTRIBUTE_TIME_MODIFIED,
+					  12345,
+					  G_FILE_QUERY_INFO_NONE,
+					  NULL,
+					  &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_engine_generate_md_cache_load(&error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	files = fu_path_get_files(cachedir, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(files);
+	g_assert_cmpint(files->len, ==, 1);
+	g_assert_cmpstr(g_ptr_array_index(files, 0), !=, cache_fn);
+}
+
+static void
+fu_engine_incremental_metadata_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *localconfdir = fu_path_from_kind(FU_PATH_KIND_LOCALCONFDIR_PKG);
+	g_autofree gchar *conf_fn = g_build_filename(localconfdir, "daemon.conf", NULL);
+	g_autofree gchar *silo_local_fn = NULL;
+	g_autofree gchar *silo_removed_fn = NULL;
+	g_autofree gchar *silo_stable_fn = NULL;
+	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(XbNode) component = NULL;
+
+	/* only for this test */
+	ret = fu_path_mkdir_parent(conf_fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(conf_fn, "[fwupd]\nIncrementalMetadata=true\n", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* metadata for one remote */
+	ret = g_file_set_contents(
+	    "/tmp/fwupd-self-test/stable.xml",
+	    "<components>"
+	    "  <component type=\"firmware\">"
+	    "    <id>test</id>"
+	    "    <provides>"
+	    "      <firmware type=\"flashed\">aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee</firmware>"
+	    "    </provides>"
+	    "    <releases>"
+	    "      <release version=\"1.2.3\" date=\"2017-09-15\"/>"
+	    "    </releases>"
+	    "  </component>"
+	    "</components>",
+	    -1,
+	    &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* a silo for a remote that no longer exists */
+	silo_removed_fn = g_build_filename(cachedirpkg, "metadata.d", "removed.xmlb", NULL);
+	ret = fu_path_mkdir_parent(silo_removed_fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(silo_removed_fn, "XMLB", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* each remote is compiled into its own silo */
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_REMOTES, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	silo_stable_fn = g_build_filename(cachedirpkg, "metadata.d", "stable.xmlb", NULL);
+	g_assert_true(g_file_test(silo_stable_fn, G_FILE_TEST_EXISTS));
+	silo_local_fn = g_build_filename(cachedirpkg, "metadata.d", "local.xmlb", NULL);
+	g_assert_true(g_file_test(silo_local_fn, G_FILE_TEST_EXISTS));
+	g_assert_false(g_file_test(silo_removed_fn, G_FILE_TEST_EXISTS));
+
+	/* the component is found in the per-remote silo */
+	fu_device_add_guid(device, "aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee");
+	component = fu_engine_get_component_by_guids(engine, device);
+	g_assert_nonnull(component);
+	g_assert_cmpstr(xb_node_query_text(component, "id", NULL), ==, "test");
+
+	/* restore the default */
+	g_assert_cmpint(g_unlink(conf_fn), ==, 0);
+}
+
+static void
+fu_engine_plugins_parallel_percentage_cb(FuProgress *progress, guint percentage, gpointer user_data)
+{
+	GPtrArray *children = (GPtrArray *)user_data;
+
+	/* save the child used by the next step */
+	if (percentage < 100)
+		g_ptr_array_add(children, g_object_ref(fu_progress_get_child(progress)));
+}
+
+static void
+fu_engine_plugins_parallel_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	const gchar *names[] = {"aaa", "bbb", "ccc", "ddd"};
+	const gboolean thread_safe[] = {TRUE, TRUE, FALSE, TRUE};
+	const guint orders[] = {0, 0, 0, 1};
+	g_autofree gchar *localconfdir = fu_path_from_kind(FU_PATH_KIND_LOCALCONFDIR_PKG);
+	g_autofree gchar *conf_fn = g_build_filename(localconfdir, "daemon.conf", NULL);
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(FuProgress) progress_setup = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) children =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+
+	/* only for this test */
+	ret = fu_path_mkdir_parent(conf_fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(conf_fn, "[fwupd]\nParallelPluginStartup=true\n", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* a main-thread plugin with the same order as two thread safe plugins */
+	for (guint i = 0; i < G_N_ELEMENTS(names); i++) {
+		g_autoptr(FuPlugin) plugin = fu_plugin_new(self->ctx);
+		fu_plugin_set_name(plugin, names[i]);
+		fu_plugin_set_order(plugin, orders[i]);
+		fu_plugin_set_thread_safe(plugin, thread_safe[i]);
+		fu_engine_add_plugin(engine, plugin);
+	}
+	g_signal_connect(FU_PROGRESS(progress_setup),
+			 "percentage-changed",
+			 G_CALLBACK(fu_engine_plugins_parallel_percentage_cb),
+			 children);
+	fu_engine_plugins_setup(engine, progress_setup);
+	g_assert_cmpint(fu_progress_get_percentage(progress_setup), ==, 100);
+
+	/* the main-thread plugin used its own step and not the one reserved for a worker */
+	g_assert_cmpint(children->len, ==, 3);
+	g_assert_cmpstr(fu_progress_get_name(g_ptr_array_index(children, 0)), ==, NULL);
+	g_assert_cmpstr(fu_progress_get_name(g_ptr_array_index(children, 1)), ==, "ccc");
+	g_assert_cmpstr(fu_progress_get_name(g_ptr_array_index(children, 2)), ==, NULL);
+
+	/* restore the default */
+	g_assert_cmpint(g_unlink(conf_fn), ==, 0);
+}
+
 static void
 fu_plugin_hash_func(gconstpointer user_data)
 {
@@ -1682,6 +1916,7 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	g_autoptr(FuEngineRequest) request = fu_engine_request_new(FU_ENGINE_REQUEST_KIND_ACTIVE);
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) approved = NULL;
 	g_autoptr(GPtrArray) devices = NULL;
 	g_autoptr(GPtrArray) devices_pre = NULL;
 	g_autoptr(GPtrArray) releases_dg = NULL;
@@ -1839,6 +2074,16 @@ fu_engine_downgrade_func(gconstpointer user_data)
 	fu_engine_add_approved_firmware(engine, "deadbeefdeadbeefdeadbeefdeadbeef");
 	fu_engine_add_approved_firmware(engine, "XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX");
 
+	/* checksums are compared without case, but returned as they were added */
+	fu_engine_add_approved_firmware(engine, "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+	fu_engine_add_approved_firmware(engine, "XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX");
+	approved = fu_engine_get_approved_firmware(engine);
+	g_assert_cmpint(approved->len, ==, 2);
+	g_assert_true(g_ptr_array_find_with_equal_func(approved,
+						       "XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX",
+						       g_str_equal,
+						       NULL));
+
 	/* upgrades */
 	releases_up = fu_engine_get_upgrades(engine, request, fu_device_get_id(device), &error);
 	g_assert_no_error(error);
@@ -2211,6 +2456,150 @@ fu_engine_multiple_rels_func(gconstpointer user_data)
 	g_assert_cmpstr(fu_device_get_version(device), ==, "1.2.4");
 }
 
+typedef struct {
+	FuEngine *engine;
+	FuDevice *device_replug;
+	FuDevice *device_timeout;
+	gboolean replugged;
+} FuEngineInstallConcurrentHelper;
+
+static gboolean
+fu_engine_install_concurrent_replug_cb(gpointer user_data)
+{
+	FuEngineInstallConcurrentHelper *helper = (FuEngineInstallConcurrentHelper *)user_data;
+
+	/* only replug once the other device has given up waiting */
+	if (!fu_device_has_flag(helper->device_replug, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG))
+		return G_SOURCE_CONTINUE;
+	if (fu_device_get_metadata_integer(helper->device_timeout, "nr-update") != 1 ||
+	    fu_device_has_flag(helper->device_timeout, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG))
+		return G_SOURCE_CONTINUE;
+	fu_engine_add_device(helper->engine, helper->device_replug);
+	helper->replugged = TRUE;
+	return G_SOURCE_REMOVE;
+}
+
+static void
+fu_engine_install_concurrent_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	guint timeout_id;
+	FuEngineInstallConcurrentHelper helper = {NULL};
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *localconfdir = fu_path_from_kind(FU_PATH_KIND_LOCALCONFDIR_PKG);
+	g_autofree gchar *conf_fn = g_build_filename(localconfdir, "daemon.conf", NULL);
+	g_autoptr(FuDevice) device1 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new();
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new(FU_ENGINE_REQUEST_KIND_ACTIVE);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GBytes) blob_cab = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) releases =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+	g_autoptr(XbSilo) silo = NULL;
+	FuDevice *devices[] = {device1, device2, NULL};
+
+	/* only for this test */
+	ret = fu_path_mkdir_parent(conf_fn, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(conf_fn, "[fwupd]\nParallelInstall=true\n", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* ensure empty tree */
+	fu_self_test_mkroot();
+	(void)g_unsetenv("FWUPD_PLUGIN_TEST");
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+
+	/* set up dummy plugin */
+	fu_engine_add_plugin(engine, self->plugin);
+
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* add two unrelated devices that both opt into being written concurrently */
+	for (guint i = 0; devices[i] != NULL; i++) {
+		g_autofree gchar *id = g_strdup_printf("test_device%u", i + 1);
+		fu_device_set_version_format(devices[i], FWUPD_VERSION_FORMAT_TRIPLET);
+		fu_device_set_version(devices[i], "1.2.2");
+		fu_device_set_id(devices[i], id);
+		fu_device_add_vendor_id(devices[i], "USB:FFFF");
+		fu_device_add_protocol(devices[i], "com.acme");
+		fu_device_set_name(devices[i], "Test Device");
+		fu_device_set_plugin(devices[i], "test");
+		fu_device_add_guid(devices[i], "12345678-1234-1234-1234-123456789012");
+		fu_device_add_flag(devices[i], FWUPD_DEVICE_FLAG_UPDATABLE);
+		fu_device_add_flag(devices[i], FWUPD_DEVICE_FLAG_UNSIGNED_PAYLOAD);
+		fu_device_add_internal_flag(devices[i], FU_DEVICE_INTERNAL_FLAG_CONCURRENT_INSTALL);
+		fu_device_set_metadata_boolean(devices[i], "WaitForReplug", TRUE);
+		fu_device_set_metadata_integer(devices[i], "nr-update", 0);
+		fu_device_set_created(devices[i], 1515338000);
+		fu_engine_add_device(engine, devices[i]);
+	}
+
+	/* the first device replugs, the second never comes back */
+	fu_device_set_remove_delay(device1, 10000);
+	fu_device_set_remove_delay(device2, 50);
+
+	filename =
+	    g_test_build_filename(G_TEST_BUILT, "tests", "missing-hwid", "noreqs-1.2.3.cab", NULL);
+	blob_cab = fu_bytes_get_contents(filename, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_cab);
+	silo = fu_engine_get_silo_from_blob(engine, blob_cab, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(silo);
+	component =
+	    xb_silo_query_first(silo,
+				"components/component/id[text()='com.hughski.test.firmware']/..",
+				&error);
+	g_assert_no_error(error);
+	g_assert_nonnull(component);
+	for (guint i = 0; devices[i] != NULL; i++) {
+		g_autoptr(FuRelease) release = fu_release_new();
+		fu_release_set_device(release, devices[i]);
+		ret = fu_release_load(release, component, NULL, FWUPD_INSTALL_FLAG_NONE, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+		g_ptr_array_add(releases, g_steal_pointer(&release));
+	}
+
+	/* the replug is processed on this thread while the devices are being written */
+	helper.engine = engine;
+	helper.device_replug = device1;
+	helper.device_timeout = device2;
+	timeout_id = g_timeout_add(5, fu_engine_install_concurrent_replug_cb, &helper);
+	ret = fu_engine_install_releases(engine,
+					 request,
+					 releases,
+					 blob_cab,
+					 progress,
+					 FWUPD_INSTALL_FLAG_NONE,
+					 &error);
+	if (!helper.replugged)
+		g_source_remove(timeout_id);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_false(ret);
+
+	/* only the device that timed out failed, and the other was not waited for */
+	g_assert_nonnull(strstr(error->message, fu_device_get_id(device2)));
+	g_assert_null(strstr(error->message, fu_device_get_id(device1)));
+	g_assert_true(helper.replugged);
+	g_assert_false(fu_device_has_flag(device1, FWUPD_DEVICE_FLAG_WAIT_FOR_REPLUG));
+	g_assert_cmpint(fu_device_get_metadata_integer(device1, "nr-update"), ==, 1);
+
+	/* restore the default */
+	g_assert_cmpint(g_unlink(conf_fn), ==, 0);
+}
+
 static void
 fu_engine_history_inherit(gconstpointer user_data)
 {
@@ -2606,6 +2995,155 @@ fu_device_list_no_auto_remove_children_func(gconstpointer user_data)
 	g_assert_cmpint(active3->len, ==, 0);
 }
 
+static void
+fu_device_list_index_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	FuDevice *device;
+	gboolean ret;
+	g_autoptr(FuDeviceList) device_list = fu_device_list_new();
+	g_autoptr(GPtrArray) devices = g_ptr_array_new_with_free_func(g_object_unref);
+	g_autoptr(GError) error = NULL;
+	g_autofree gchar *device_id = NULL;
+	g_autofree gchar *device_id_old = NULL;
+	g_autofree gchar *guid_old = NULL;
+
+	/* add lots of devices */
+	for (guint i = 0; i < 1000; i++) {
+		g_autoptr(FuDevice) device_tmp = fu_device_new(self->ctx);
+		g_autofree gchar *id = g_strdup_printf("device%u", i);
+		g_autofree gchar *instance_id = g_strdup_printf("USB\\VID_273F&PID_%04X", i);
+		g_autofree gchar *physical_id = g_strdup_printf("usb:%02x:%02x", i / 256, i % 256);
+		fu_device_set_id(device_tmp, id);
+		fu_device_set_physical_id(device_tmp, physical_id);
+		fu_device_add_instance_id(device_tmp, instance_id);
+		fu_device_convert_instance_ids(device_tmp);
+		fu_device_list_add(device_list, device_tmp);
+		g_ptr_array_add(devices, g_steal_pointer(&device_tmp));
+	}
+
+	/* lookup each device by GUID and ID */
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device_tmp = g_ptr_array_index(devices, i);
+		const gchar *guid = g_ptr_array_index(fu_device_get_guids(device_tmp), 0);
+		device = fu_device_list_get_by_guid(device_list, guid, &error);
+		g_assert_no_error(error);
+		g_assert_true(device == device_tmp);
+		g_object_unref(device);
+		device =
+		    fu_device_list_get_by_id(device_list, fu_device_get_id(device_tmp), &error);
+		g_assert_no_error(error);
+		g_assert_true(device == device_tmp);
+		g_object_unref(device);
+	}
+
+	/* lookup missing GUID */
+	device = fu_device_list_get_by_guid(device_list, "USB\\VID_FFFF", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(device);
+	g_clear_error(&error);
+
+	/* a GUID added after the device was added is found */
+	device = g_ptr_array_index(devices, 123);
+	fu_device_add_guid(device, "a90a2416-b1ad-49f4-9bd5-0ef9fb9f4e47");
+	device = fu_device_list_get_by_guid(device_list,
+					    "A90A2416-B1AD-49F4-9BD5-0EF9FB9F4E47",
+					    &error);
+	g_assert_no_error(error);
+	g_assert_true(device == g_ptr_array_index(devices, 123));
+	g_object_unref(device);
+
+	/* the first device in the list wins for a shared GUID */
+	device = g_ptr_array_index(devices, 789);
+	fu_device_add_guid(device, "a90a2416-b1ad-49f4-9bd5-0ef9fb9f4e47");
+	device = fu_device_list_get_by_guid(device_list,
+					    "a90a2416-b1ad-49f4-9bd5-0ef9fb9f4e47",
+					    &error);
+	g_assert_no_error(error);
+	g_assert_true(device == g_ptr_array_index(devices, 123));
+	g_object_unref(device);
+
+	/* a changed device ID is found, and the old ID is not */
+	device = g_ptr_array_index(devices, 321);
+	device_id_old = g_strdup(fu_device_get_id(device));
+	fu_device_set_id(device, "device321-renamed");
+	device = fu_device_list_get_by_id(device_list, device_id_old, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(device);
+	g_clear_error(&error);
+	device = fu_device_list_get_by_id(device_list,
+					  fu_device_get_id(g_ptr_array_index(devices, 321)),
+					  &error);
+	g_assert_no_error(error);
+	g_assert_true(device == g_ptr_array_index(devices, 321));
+	g_object_unref(device);
+
+	/* abbreviated device ID */
+	device_id = g_strndup(fu_device_get_id(g_ptr_array_index(devices, 456)), 12);
+	device = fu_device_list_get_by_id(device_list, device_id, &error);
+	g_assert_no_error(error);
+	g_assert_true(device == g_ptr_array_index(devices, 456));
+	g_object_unref(device);
+	device = fu_device_list_get_by_id(device_list, "", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED);
+	g_assert_null(device);
+	g_clear_error(&error);
+
+	/* GUIDs removed by a rescan are not found, even if no new GUIDs are added */
+	device = g_ptr_array_index(devices, 654);
+	guid_old = g_strdup(g_ptr_array_index(fu_device_get_guids(device), 0));
+	fu_device_add_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_NO_AUTO_INSTANCE_IDS);
+	ret = fu_device_rescan(device, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_false(fu_device_has_guid(device, guid_old));
+	device = fu_device_list_get_by_guid(device_list, guid_old, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(device);
+	g_clear_error(&error);
+
+	/* removing a device removes it from the index */
+	device = g_ptr_array_index(devices, 123);
+	fu_device_list_remove(device_list, device);
+	device = fu_device_list_get_by_id(device_list,
+					  fu_device_get_id(g_ptr_array_index(devices, 123)),
+					  &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(device);
+	g_clear_error(&error);
+	device = fu_device_list_get_by_guid(device_list,
+					    "a90a2416-b1ad-49f4-9bd5-0ef9fb9f4e47",
+					    &error);
+	g_assert_no_error(error);
+	g_assert_true(device == g_ptr_array_index(devices, 789));
+	g_object_unref(device);
+
+	/* changing the device after removal does not affect the list */
+	device = g_ptr_array_index(devices, 123);
+	fu_device_add_guid(device, "7b5e8ac6-5ed1-4b53-8b6e-bd1f3b5e0e8b");
+	device = fu_device_list_get_by_guid(device_list,
+					    "7b5e8ac6-5ed1-4b53-8b6e-bd1f3b5e0e8b",
+					    &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(device);
+	g_clear_error(&error);
+
+	/* adding it again indexes it at the end of the list */
+	fu_device_list_add(device_list, g_ptr_array_index(devices, 123));
+	device = fu_device_list_get_by_guid(device_list,
+					    "a90a2416-b1ad-49f4-9bd5-0ef9fb9f4e47",
+					    &error);
+	g_assert_no_error(error);
+	g_assert_true(device == g_ptr_array_index(devices, 789));
+	g_object_unref(device);
+	device = fu_device_list_get_by_guid(device_list,
+					    "7b5e8ac6-5ed1-4b53-8b6e-bd1f3b5e0e8b",
+					    &error);
+	g_assert_no_error(error);
+	g_assert_true(device == g_ptr_array_index(devices, 123));
+	g_object_unref(device);
+}
+
 static void
 fu_device_list_delay_func(gconstpointer user_data)
 {
@@ -3337,6 +3875,11 @@ fu_history_func(gconstpointer user_data)
 	g_autoptr(FuDevice) device_found = NULL;
 	g_autoptr(FuHistory) history = NULL;
 	g_autoptr(GPtrArray) approved_firmware = NULL;
+	g_autoptr(GPtrArray) blocked_firmware = NULL;
+	g_autoptr(GPtrArray) checksums_blocked = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GHashTable) io_stats = NULL;
+	g_autoptr(GHashTable) io_stats_saved = NULL;
 	g_autofree gchar *dirname = NULL;
 	g_autofree gchar *filename = NULL;
 
@@ -3415,6 +3958,42 @@ fu_history_func(gconstpointer user_data)
 	g_assert_no_error(error);
 	g_assert_true(ret);
 
+	/* re-adding replaces the old entry */
+	devices = fu_history_get_devices(history, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices);
+	g_assert_cmpint(devices->len, ==, 1);
+
+	/* I/O stats are stored outside of the release metadata */
+	io_stats = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	g_hash_table_insert(io_stats, g_strdup("Read"), g_strdup("4 calls, 128 bytes"));
+	g_hash_table_insert(io_stats, g_strdup("Write"), g_strdup("2 calls, 64 bytes"));
+	ret = fu_history_set_device_io_stats(history,
+					     "2ba16d10df45823dd4494ff10a0bfccfef512c9d",
+					     io_stats,
+					     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	io_stats_saved = fu_history_get_device_io_stats(history,
+							"2ba16d10df45823dd4494ff10a0bfccfef512c9d",
+							&error);
+	g_assert_no_error(error);
+	g_assert_nonnull(io_stats_saved);
+	g_assert_cmpint(g_hash_table_size(io_stats_saved), ==, 2);
+	g_assert_cmpstr(g_hash_table_lookup(io_stats_saved, "Read"), ==, "4 calls, 128 bytes");
+	g_assert_cmpstr(g_hash_table_lookup(io_stats_saved, "Write"), ==, "2 calls, 64 bytes");
+	g_clear_pointer(&io_stats_saved, g_hash_table_unref);
+	device_found = fu_history_get_device_by_id(history,
+						   "2ba16d10df45823dd4494ff10a0bfccfef512c9d",
+						   &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(device_found);
+	release = fu_device_get_release_default(device_found);
+	g_assert_nonnull(release);
+	g_assert_null(fwupd_release_get_metadata_item(release, "IoStats(Read)"));
+	g_assert_null(fwupd_release_get_metadata_item(release, "Read"));
+	g_clear_object(&device_found);
+
 	/* get device that does not exist */
 	device_found = fu_history_get_device_by_id(history, "XXXXXXXXXXXXX", &error);
 	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
@@ -3443,6 +4022,14 @@ fu_history_func(gconstpointer user_data)
 	g_assert_null(device_found);
 	g_clear_error(&error);
 
+	/* the I/O stats were removed too */
+	io_stats_saved = fu_history_get_device_io_stats(history,
+							"2ba16d10df45823dd4494ff10a0bfccfef512c9d",
+							&error);
+	g_assert_no_error(error);
+	g_assert_nonnull(io_stats_saved);
+	g_assert_cmpint(g_hash_table_size(io_stats_saved), ==, 0);
+
 	/* approved firmware */
 	ret = fu_history_clear_approved_firmware(history, &error);
 	g_assert_no_error(error);
@@ -3459,6 +4046,22 @@ fu_history_func(gconstpointer user_data)
 	g_assert_cmpint(approved_firmware->len, ==, 2);
 	g_assert_cmpstr(g_ptr_array_index(approved_firmware, 0), ==, "foo");
 	g_assert_cmpstr(g_ptr_array_index(approved_firmware, 1), ==, "bar");
+
+	/* blocked firmware is replaced as a whole */
+	ret = fu_history_add_blocked_firmware(history, "foo", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_ptr_array_add(checksums_blocked, g_strdup("bar"));
+	g_ptr_array_add(checksums_blocked, g_strdup("baz"));
+	ret = fu_history_set_blocked_firmware(history, checksums_blocked, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blocked_firmware = fu_history_get_blocked_firmware(history, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blocked_firmware);
+	g_assert_cmpint(blocked_firmware->len, ==, 2);
+	g_assert_cmpstr(g_ptr_array_index(blocked_firmware, 0), ==, "bar");
+	g_assert_cmpstr(g_ptr_array_index(blocked_firmware, 1), ==, "baz");
 }
 
 static GBytes *
@@ -4023,6 +4626,7 @@ fu_release_uri_scheme_func(void)
 static void
 fu_common_store_cab_func(void)
 {
+	gboolean ret;
 	GBytes *blob_tmp;
 	g_autoptr(GBytes) blob = NULL;
 	g_autoptr(GError) error = NULL;
@@ -4090,6 +4694,9 @@ fu_common_store_cab_func(void)
 	csum = xb_node_query_first(rel, "checksum[@target='content']", &error);
 	g_assert_nonnull(csum);
 	g_assert_cmpstr(xb_node_get_text(csum), ==, "7c211433f02071597741e6ff5a8ea34789abbf43");
+	ret = fu_cabinet_load_release(rel, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 	blob_tmp = xb_node_get_data(rel, "fwupd::FirmwareBlob");
 	g_assert_nonnull(blob_tmp);
 	req = xb_node_query_first(component, "requires/id", &error);
@@ -4223,6 +4830,7 @@ fu_common_store_cab_artifact_func(void)
 static void
 fu_common_store_cab_unsigned_func(void)
 {
+	gboolean ret;
 	GBytes *blob_tmp;
 	g_autoptr(GBytes) blob = NULL;
 	g_autoptr(GError) error = NULL;
@@ -4273,6 +4881,9 @@ fu_common_store_cab_unsigned_func(void)
 	g_assert_cmpstr(xb_node_get_attr(rel, "version"), ==, "1.2.3");
 	csum = xb_node_query_first(rel, "checksum[@target='content']", &error);
 	g_assert_null(csum);
+	ret = fu_cabinet_load_release(rel, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 	blob_tmp = xb_node_get_data(rel, "fwupd::FirmwareBlob");
 	g_assert_nonnull(blob_tmp);
 }
@@ -4309,6 +4920,7 @@ fu_common_store_cab_sha256_func(void)
 static void
 fu_common_store_cab_folder_func(void)
 {
+	gboolean ret;
 	GBytes *blob_tmp;
 	g_autoptr(GBytes) blob = NULL;
 	g_autoptr(GError) error = NULL;
@@ -4356,6 +4968,9 @@ fu_common_store_cab_folder_func(void)
 	g_assert_no_error(error);
 	g_assert_nonnull(rel);
 	g_assert_cmpstr(xb_node_get_attr(rel, "version"), ==, "1.2.3");
+	ret = fu_cabinet_load_release(rel, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 	blob_tmp = xb_node_get_data(rel, "fwupd::FirmwareBlob");
 	g_assert_nonnull(blob_tmp);
 }
@@ -4451,7 +5066,12 @@ fu_common_store_cab_error_size_func(void)
 static void
 fu_common_store_cab_error_wrong_checksum_func(void)
 {
+	gboolean ret;
 	g_autoptr(XbSilo) silo = NULL;
+	g_autoptr(XbNode) rel = NULL;
+#if LIBXMLB_CHECK_VERSION(0, 2, 0)
+	g_autoptr(XbQuery) query = NULL;
+#endif
 	g_autoptr(GBytes) blob = NULL;
 	g_autoptr(GError) error = NULL;
 
@@ -4470,8 +5090,26 @@ fu_common_store_cab_error_wrong_checksum_func(void)
 			  "world",
 			  NULL);
 	silo = fu_cabinet_build_silo(blob, 10240, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(silo);
+
+	/* the checksum is only verified when the payload is required */
+#if LIBXMLB_CHECK_VERSION(0, 2, 0)
+	query = xb_query_new_full(silo,
+				  "components/component/releases/release",
+				  XB_QUERY_FLAG_FORCE_NODE_CACHE,
+				  &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(query);
+	rel = xb_silo_query_first_full(silo, query, &error);
+#else
+	rel = xb_silo_query_first(silo, "components/component/releases/release", &error);
+#endif
+	g_assert_no_error(error);
+	g_assert_nonnull(rel);
+	ret = fu_cabinet_load_release(rel, &error);
 	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE);
-	g_assert_null(silo);
+	g_assert_false(ret);
 }
 
 static void
@@ -4694,6 +5332,7 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/security-attr", self, fu_security_attr_func);
 	g_test_add_data_func("/fwupd/security-attrs", self, fu_security_attrs_func);
 	g_test_add_data_func("/fwupd/device-list", self, fu_device_list_func);
+	g_test_add_data_func("/fwupd/device-list{index}", self, fu_device_list_index_func);
 	g_test_add_data_func("/fwupd/device-list{delay}", self, fu_device_list_delay_func);
 	g_test_add_data_func("/fwupd/device-list{no-auto-remove-children}",
 			     self,
@@ -4716,6 +5355,9 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/engine{multiple-releases}",
 			     self,
 			     fu_engine_multiple_rels_func);
+	g_test_add_data_func("/fwupd/engine{install-concurrent}",
+			     self,
+			     fu_engine_install_concurrent_func);
 	g_test_add_data_func("/fwupd/engine{history-success}", self, fu_engine_history_func);
 	g_test_add_data_func("/fwupd/engine{history-error}", self, fu_engine_history_error_func);
 	if (g_test_slow()) {
@@ -4794,6 +5436,15 @@ main(int argc, char **argv)
 			     self,
 			     fu_engine_install_duration_func);
 	g_test_add_data_func("/fwupd/engine{generate-md}", self, fu_engine_generate_md_func);
+	g_test_add_data_func("/fwupd/engine{generate-md-cache}",
+			     self,
+			     fu_engine_generate_md_cache_func);
+	g_test_add_data_func("/fwupd/engine{incremental-metadata}",
+			     self,
+			     fu_engine_incremental_metadata_func);
+	g_test_add_data_func("/fwupd/engine{plugins-parallel}",
+			     self,
+			     fu_engine_plugins_parallel_func);
 	g_test_add_data_func("/fwupd/engine{requirements-other-device}",
 			     self,
 			     fu_engine_requirements_other_device_func);
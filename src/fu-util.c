@@ -1768,6 +1768,51 @@ fu_util_get_results(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_util_get_device_stats(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	g_autoptr(FwupdDevice) dev = NULL;
+	g_autoptr(GHashTable) stats = NULL;
+	g_autoptr(GList) keys = NULL;
+
+	dev = fu_util_get_device_or_prompt(priv, values, error);
+	if (dev == NULL)
+		return FALSE;
+	stats = fwupd_client_get_device_stats(priv->client,
+					      fwupd_device_get_id(dev),
+					      priv->cancellable,
+					      error);
+	if (stats == NULL)
+		return FALSE;
+
+	/* not for human consumption */
+	keys = g_list_sort(g_hash_table_get_keys(stats), (GCompareFunc)g_strcmp0);
+	if (priv->as_json) {
+		g_autoptr(JsonBuilder) builder = json_builder_new();
+		json_builder_begin_object(builder);
+		for (GList *l = keys; l != NULL; l = l->next) {
+			const gchar *key = l->data;
+			json_builder_set_member_name(builder, key);
+			json_builder_add_string_value(builder, g_hash_table_lookup(stats, key));
+		}
+		json_builder_end_object(builder);
+		return fu_util_print_builder(builder, error);
+	}
+	if (keys == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOTHING_TO_DO,
+				    /* TRANSLATORS: no I/O was recorded during an update */
+				    _("No device statistics have been recorded"));
+		return FALSE;
+	}
+	for (GList *l = keys; l != NULL; l = l->next) {
+		const gchar *key = l->data;
+		g_print("%s: %s\n", key, (const gchar *)g_hash_table_lookup(stats, key));
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_util_get_releases(FuUtilPrivate *priv, gchar **values, GError **error)
 {
@@ -4308,6 +4353,13 @@ main(int argc, char *argv[])
 			      /* TRANSLATORS: command description */
 			      _("Gets the results from the last update"),
 			      fu_util_get_results);
+	fu_util_cmd_array_add(cmd_array,
+			      "get-device-stats",
+			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
+			      _("DEVICE-ID|GUID"),
+			      /* TRANSLATORS: command description */
+			      _("Gets the I/O statistics from the last update"),
+			      fu_util_get_device_stats);
 	fu_util_cmd_array_add(cmd_array,
 			      "get-releases",
 			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */